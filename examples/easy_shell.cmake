@@ -0,0 +1 @@
+target_link_libraries(easy_shell PUBLIC alice cli11 any kitty json)
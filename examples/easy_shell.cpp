@@ -0,0 +1,52 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <alice/alice.hpp>
+
+#include <easy/cli/stores/function.hpp>
+#include <easy/cli/stores/esop.hpp>
+
+#include <easy/cli/commands/cover.hpp>
+#include <easy/cli/commands/ec.hpp>
+#include <easy/cli/commands/exorlink.hpp>
+#include <easy/cli/commands/function.hpp>
+#include <easy/cli/commands/read_fns.hpp>
+#include <easy/cli/commands/sort.hpp>
+#include <easy/cli/commands/synth.hpp>
+
+namespace alice
+{
+
+ALICE_ADD_COMMAND( function, "Functions" )
+ALICE_ADD_COMMAND( read_fns, "Functions" )
+ALICE_ADD_COMMAND( cover, "Synthesis" )
+ALICE_ADD_COMMAND( synth, "Synthesis" )
+ALICE_ADD_COMMAND( exorlink, "ESOP" )
+ALICE_ADD_COMMAND( sort, "ESOP" )
+ALICE_ADD_COMMAND( ec, "Verification" )
+
+} // namespace alice
+
+ALICE_MAIN( easy )
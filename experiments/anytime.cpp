@@ -0,0 +1,58 @@
+#include <easy/esop/constructors.hpp>
+
+#include <kitty/kitty.hpp>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+/* anytime Helliwell-MAXSAT (LSU) under time limits */
+template<int NumVars>
+void run( uint32_t num_functions, double time_limit )
+{
+  using truth_table = kitty::static_truth_table<NumVars>;
+  using maxsat_t = easy::esop::esop_from_tt<truth_table, easy::sat2::maxsat_lsu, easy::esop::helliwell_maxsat>;
+
+  std::mt19937 gen( 0xcafe );
+  for ( auto i = 0u; i < num_functions; ++i )
+  {
+    truth_table tt;
+    kitty::create_random( tt, gen() );
+
+    auto const t0 = std::chrono::steady_clock::now();
+    auto const elapsed = [&t0](){ return std::chrono::duration<double>( std::chrono::steady_clock::now() - t0 ).count(); };
+
+    easy::esop::helliwell_maxsat_statistics stats;
+    easy::esop::helliwell_maxsat_params ps;
+    ps.maxsat.time_limit = time_limit;
+    ps.pkrm_hint = true;
+
+    double first_time = 0.0;
+    int64_t first_cost = -1;
+    ps.maxsat.on_improvement = [&]( int64_t cost, std::vector<int> const& ){
+      if ( first_cost < 0 )
+      {
+        first_cost = cost;
+        first_time = elapsed();
+      }
+    };
+
+    auto const esop = maxsat_t( stats, ps ).synthesize( tt );
+    auto const pkrm = easy::esop::esop_from_optimum_pkrm( tt );
+
+    fmt::print( "[i] n = {} limit = {:4.1f}s first = {:4} cubes after {:6.3f}s best = {:4} cubes after {:6.3f}s ({} improvements{}) PKRM = {:4} cubes\n",
+                NumVars, time_limit, first_cost, first_time, esop.size(), elapsed(), stats.maxsat.improvements,
+                stats.maxsat.optimal ? ", optimal" : "", pkrm.size() );
+    std::fflush( stdout );
+  }
+}
+
+int main()
+{
+  run<5>( 3u, 1.0 );
+  run<6>( 3u, 1.0 );
+  run<7>( 3u, 1.0 );
+  run<7>( 1u, 10.0 );
+  return 0;
+}
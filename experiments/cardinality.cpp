@@ -0,0 +1,86 @@
+#include <easy/esop/constructors.hpp>
+#include <easy/sat2/cardinality.hpp>
+
+#include <kitty/kitty.hpp>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::vector<std::pair<easy::sat2::cardinality_encoding, std::string>> const encodings = {
+  { easy::sat2::cardinality_encoding::totalizer, "totalizer" },
+  { easy::sat2::cardinality_encoding::sequential_counter, "seq-counter" },
+  { easy::sat2::cardinality_encoding::cardinality_network, "card-network" },
+  { easy::sat2::cardinality_encoding::modulo_totalizer, "modulo-tot" },
+  { easy::sat2::cardinality_encoding::automatic, "automatic" }
+};
+
+/* number of clauses of each encoding */
+void sizes()
+{
+  for ( auto n : { 100u, 1000u, 10000u } )
+  {
+    for ( auto k : { 1u, 10u, 100u, 1000u } )
+    {
+      if ( k >= n )
+      {
+        continue;
+      }
+
+      fmt::print( "[i] n = {:5} k = {:4}", n, k );
+      for ( auto i = 0u; i + 1u < encodings.size(); ++i )
+      {
+        fmt::print( " {} = {:8}", encodings[i].second, easy::sat2::compute_cardinality_encoding_size( encodings[i].first, n, k ).clauses );
+      }
+      fmt::print( "\n" );
+    }
+  }
+  std::fflush( stdout );
+}
+
+/* Helliwell-MAXSAT with an algorithm that bounds the cost by cardinality constraints */
+template<int NumVars, typename Algorithm>
+void run( uint32_t num_functions, std::string const& name )
+{
+  using truth_table = kitty::static_truth_table<NumVars>;
+  using maxsat_t = easy::esop::esop_from_tt<truth_table, Algorithm, easy::esop::helliwell_maxsat>;
+
+  for ( const auto& [encoding, encoding_name] : encodings )
+  {
+    std::mt19937 gen( 0xcafe );
+    double time = 0.0;
+    uint64_t cubes = 0u;
+
+    for ( auto i = 0u; i < num_functions; ++i )
+    {
+      truth_table tt;
+      kitty::create_random( tt, gen() );
+
+      easy::esop::helliwell_maxsat_statistics stats;
+      easy::esop::helliwell_maxsat_params ps;
+      ps.maxsat.cardinality = encoding;
+
+      auto const t0 = std::chrono::steady_clock::now();
+      auto const esop = maxsat_t( stats, ps ).synthesize( tt );
+      auto const t1 = std::chrono::steady_clock::now();
+
+      time += std::chrono::duration<double>( t1 - t0 ).count();
+      cubes += esop.size();
+    }
+
+    fmt::print( "[i] n = {} {:6} {:12} cubes = {:5} time = {:8.3f}s\n", NumVars, name, encoding_name, cubes, time );
+    std::fflush( stdout );
+  }
+}
+
+int main()
+{
+  sizes();
+  run<4, easy::sat2::maxsat_linear>( 20u, "linear" );
+  run<4, easy::sat2::maxsat_lsu>( 20u, "lsu" );
+  run<5, easy::sat2::maxsat_lsu>( 3u, "lsu" );
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include <easy/esop/exorlink.hpp>
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+/* compares the runtime EXORLINK transformation with the specialized kernels */
+template<uint32_t Distance>
+void compare( std::uint32_t const* groups, uint32_t num_pairs, uint32_t repetitions )
+{
+  std::mt19937 gen( 0xcafe );
+  std::vector<std::pair<kitty::cube, kitty::cube>> pairs;
+  while ( pairs.size() < num_pairs )
+  {
+    kitty::cube c0, c1;
+    for ( auto l = 0u; l < 16u; ++l )
+    {
+      auto const v0 = gen() % 3, v1 = gen() % 3;
+      if ( v0 != 2 ) c0.add_literal( l, v0 );
+      if ( v1 != 2 ) c1.add_literal( l, v1 );
+    }
+    if ( uint32_t( c0.distance( c1 ) ) == Distance )
+    {
+      pairs.emplace_back( c0, c1 );
+    }
+  }
+
+  uint64_t checksum_vector = 0u, checksum_kernel = 0u;
+
+  auto const t0 = std::chrono::steady_clock::now();
+  for ( auto r = 0u; r < repetitions; ++r )
+  {
+    for ( const auto& p : pairs )
+    {
+      for ( auto g = 0u; g < easy::esop::exorlink_num_groups<Distance>; ++g )
+      {
+        for ( const auto& c : easy::esop::exorlink( p.first, p.second, Distance, groups + g * Distance * Distance ) )
+        {
+          checksum_vector += c._value;
+        }
+      }
+    }
+  }
+
+  auto const t1 = std::chrono::steady_clock::now();
+  std::array<std::array<kitty::cube, Distance>, easy::esop::exorlink_num_groups<Distance>> results;
+  for ( auto r = 0u; r < repetitions; ++r )
+  {
+    for ( const auto& p : pairs )
+    {
+      easy::esop::exorlink_all<Distance>( p.first, p.second, results );
+      for ( const auto& cubes : results )
+      {
+        for ( const auto& c : cubes )
+        {
+          checksum_kernel += c._value;
+        }
+      }
+    }
+  }
+  auto const t2 = std::chrono::steady_clock::now();
+
+  fmt::print( "[i] distance = {} pairs = {} groups = {}\n", Distance, num_pairs, easy::esop::exorlink_num_groups<Distance> );
+  fmt::print( "[i]   vector : {:8.3f}s\n", std::chrono::duration<double>( t1 - t0 ).count() );
+  fmt::print( "[i]   kernel : {:8.3f}s {}\n", std::chrono::duration<double>( t2 - t1 ).count(), checksum_vector == checksum_kernel ? "" : "(mismatch)" );
+}
+
+int main()
+{
+  compare<2>( &easy::esop::cube_groups2[0], 10000u, 100u );
+  compare<3>( &easy::esop::cube_groups3[0], 10000u, 100u );
+  compare<4>( &easy::esop::cube_groups4[0], 10000u, 20u );
+  compare<5>( &easy::esop::cube_groups5[0], 1000u, 20u );
+  compare<6>( &easy::esop::cube_groups6[0], 1000u, 5u );
+  return 0;
+}
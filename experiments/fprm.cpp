@@ -0,0 +1,36 @@
+#include <easy/esop/constructors.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+
+#include <fmt/format.h>
+
+#include <chrono>
+
+/* compares the cubes and runtime of the PPRM, the best FPRM, and the PKRM */
+int main()
+{
+  for ( auto n = 8u; n <= 16u; n += 2u )
+  {
+    kitty::dynamic_truth_table tt( n );
+    kitty::create_random( tt, n );
+
+    auto const t0 = std::chrono::steady_clock::now();
+    auto const pprm = easy::esop::esop_from_pprm( tt );
+    auto const t1 = std::chrono::steady_clock::now();
+    easy::esop::fprm_statistics st;
+    auto const fprm = easy::esop::esop_from_best_fprm( tt, st );
+    auto const t2 = std::chrono::steady_clock::now();
+    /* the PKRM is too slow beyond 14 variables */
+    auto const pkrm = n <= 14u ? easy::esop::esop_from_optimum_pkrm( tt ) : easy::esop::esop_t{};
+    auto const t3 = std::chrono::steady_clock::now();
+
+    fmt::print( "[i] n = {:2}\n", n );
+    fmt::print( "[i]   PPRM : {:6} cubes {:8.3f}s\n", pprm.size(), std::chrono::duration<double>( t1 - t0 ).count() );
+    fmt::print( "[i]   FPRM : {:6} cubes {:8.3f}s\n", fprm.size(), std::chrono::duration<double>( t2 - t1 ).count() );
+    if ( n <= 14u )
+    {
+      fmt::print( "[i]   PKRM : {:6} cubes {:8.3f}s\n", pkrm.size(), std::chrono::duration<double>( t3 - t2 ).count() );
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,55 @@
+#include <easy/esop/constructors.hpp>
+
+#include <kitty/kitty.hpp>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <random>
+
+/* compares Helliwell-MAXSAT with the minimum-weight search on random functions */
+template<int NumVars>
+void compare( uint32_t num_functions, uint64_t max_iterations )
+{
+  using truth_table = kitty::static_truth_table<NumVars>;
+  using maxsat_t = easy::esop::esop_from_tt<truth_table, easy::sat2::maxsat_rc2, easy::esop::helliwell_maxsat>;
+  using min_weight_t = easy::esop::esop_from_tt<truth_table, easy::sat2::maxsat_rc2, easy::esop::helliwell_min_weight>;
+
+  std::mt19937 gen( 0xcafe );
+  double maxsat_time = 0.0, min_weight_time = 0.0;
+  uint64_t maxsat_cubes = 0u, min_weight_cubes = 0u, equal = 0u;
+
+  for ( auto i = 0u; i < num_functions; ++i )
+  {
+    truth_table tt;
+    kitty::create_random( tt, gen() );
+
+    auto const t0 = std::chrono::steady_clock::now();
+    easy::esop::helliwell_maxsat_statistics maxsat_stats;
+    easy::esop::helliwell_maxsat_params maxsat_ps;
+    auto const a = maxsat_t( maxsat_stats, maxsat_ps ).synthesize( tt );
+
+    auto const t1 = std::chrono::steady_clock::now();
+    easy::esop::helliwell_min_weight_statistics min_weight_stats;
+    easy::esop::helliwell_min_weight_params min_weight_ps;
+    min_weight_ps.search.max_iterations = max_iterations;
+    auto const b = min_weight_t( min_weight_stats, min_weight_ps ).synthesize( tt );
+    auto const t2 = std::chrono::steady_clock::now();
+
+    maxsat_time += std::chrono::duration<double>( t1 - t0 ).count();
+    min_weight_time += std::chrono::duration<double>( t2 - t1 ).count();
+    maxsat_cubes += a.size();
+    min_weight_cubes += b.size();
+    equal += a.size() == b.size();
+  }
+
+  fmt::print( "[i] n = {} functions = {} iterations = {}\n", NumVars, num_functions, max_iterations );
+  fmt::print( "[i]   maxsat     : {:8.3f}s {:5} cubes\n", maxsat_time, maxsat_cubes );
+  fmt::print( "[i]   min-weight : {:8.3f}s {:5} cubes ({} of {} minimum)\n", min_weight_time, min_weight_cubes, equal, num_functions );
+}
+
+int main()
+{
+  compare<4>( 100u, 100u );
+  compare<5>( 10u, 1000u );
+  return 0;
+}
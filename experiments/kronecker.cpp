@@ -0,0 +1,25 @@
+#include <easy/algorithms/kronecker_decomposition.hpp>
+#include <easy/utils/stopwatch.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+
+#include <fmt/format.h>
+
+/* branch-and-bound search for the best Kronecker decomposition vector */
+int main()
+{
+  for ( auto n = 6u; n <= 12u; ++n )
+  {
+    kitty::dynamic_truth_table tt( n );
+    kitty::create_random( tt, n );
+
+    kronecker_search_params ps;
+    ps.num_threads = 0u;
+    kronecker_search_statistics st;
+    auto const result = best_kronecker_decomposition( tt, st, ps );
+
+    fmt::print( "[i] n = {:2} cost = {:5} cubes = {:5} nodes = {:8} pruned = {:8} time = {:7.3f}s\n",
+                n, st.cost, result.esop.size(), st.nodes, st.pruned, easy::utils::to_seconds( st.time ) );
+  }
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include <easy/esop/constructors.hpp>
+
+#include <kitty/kitty.hpp>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+/* random function with an ESOP form of at most num_cubes cubes (0: random truth table) */
+template<int NumVars>
+kitty::static_truth_table<NumVars> make_function( std::mt19937& gen, uint32_t num_cubes )
+{
+  kitty::static_truth_table<NumVars> tt;
+  if ( num_cubes == 0u )
+  {
+    kitty::create_random( tt, gen() );
+    return tt;
+  }
+
+  std::vector<kitty::cube> cubes;
+  for ( auto i = 0u; i < num_cubes; ++i )
+  {
+    auto const mask = gen() & ( ( 1u << NumVars ) - 1u );
+    cubes.emplace_back( gen() & mask, mask );
+  }
+  kitty::create_from_cubes( tt, cubes, true );
+  return tt;
+}
+
+/* runs Helliwell-MAXSAT with a MAXSAT algorithm on generated functions */
+template<int NumVars, typename Algorithm>
+void run( uint32_t num_functions, uint32_t num_cubes, std::string const& name )
+{
+  using truth_table = kitty::static_truth_table<NumVars>;
+  using maxsat_t = easy::esop::esop_from_tt<truth_table, Algorithm, easy::esop::helliwell_maxsat>;
+
+  std::mt19937 gen( 0xcafe );
+  double time = 0.0;
+  uint64_t cubes = 0u, iterations = 0u, cores = 0u;
+
+  for ( auto i = 0u; i < num_functions; ++i )
+  {
+    auto const tt = make_function<NumVars>( gen, num_cubes );
+
+    easy::esop::helliwell_maxsat_statistics stats;
+    easy::esop::helliwell_maxsat_params ps;
+
+    auto const t0 = std::chrono::steady_clock::now();
+    auto const esop = maxsat_t( stats, ps ).synthesize( tt );
+    auto const t1 = std::chrono::steady_clock::now();
+
+    time += std::chrono::duration<double>( t1 - t0 ).count();
+    cubes += esop.size();
+    iterations += stats.maxsat.iterations;
+    cores += stats.maxsat.cores;
+  }
+
+  fmt::print( "[i] n = {} functions = {:3} {:6} cubes = {:5} iterations = {:6} cores = {:6} time = {:8.3f}s\n",
+              NumVars, num_functions, name, cubes, iterations, cores, time );
+  std::fflush( stdout );
+}
+
+template<int NumVars>
+void compare( uint32_t num_functions, uint32_t num_cubes )
+{
+  run<NumVars, easy::sat2::maxsat_rc2>( num_functions, num_cubes, "rc2" );
+  run<NumVars, easy::sat2::maxsat_oll>( num_functions, num_cubes, "oll" );
+  run<NumVars, easy::sat2::maxsat_pmres>( num_functions, num_cubes, "pm-res" );
+}
+
+int main()
+{
+  /* random functions for n <= 5, functions of few cubes for larger n */
+  compare<4>( 20u, 0u );
+  compare<5>( 3u, 0u );
+  compare<6>( 3u, 4u );
+  compare<7>( 2u, 3u );
+  return 0;
+}
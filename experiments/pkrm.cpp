@@ -0,0 +1,29 @@
+#include <easy/esop/esop_from_pkrm.hpp>
+#include <easy/utils/stopwatch.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+
+#include <fmt/format.h>
+
+/* optimum PKRM with unbounded and bounded cache */
+int main()
+{
+  for ( auto n = 12u; n <= 16u; n += 2u )
+  {
+    kitty::dynamic_truth_table tt( n );
+    kitty::create_random( tt, n );
+
+    for ( auto capacity : {uint64_t( 0 ), uint64_t( 1 ) << ( n - 2u )} )
+    {
+      easy::esop::pkrm_params ps;
+      ps.cache_capacity = capacity;
+      ps.num_threads = 0u;
+
+      easy::esop::pkrm_statistics st;
+      auto const cubes = easy::esop::esop_from_optimum_pkrm( tt, st, ps );
+      fmt::print( "[i] n = {:2} capacity = {:7} cubes = {:6} time = {:7.3f}s peak = {:7} hit rate = {:.2f} evictions = {}\n",
+                  n, capacity, cubes.size(), easy::utils::to_seconds( st.time ), st.peak_cache_size, st.hit_rate(), st.cache_evictions );
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,34 @@
+#include <easy/esop/esop_from_pprm.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/esop.hpp>
+
+#include <fmt/format.h>
+
+#include <chrono>
+
+/* compares the recursive PPRM construction with the Reed-Muller transform */
+int main()
+{
+  for ( auto n = 12u; n <= 24u; n += 2u )
+  {
+    kitty::dynamic_truth_table tt( n );
+    kitty::create_random( tt, n );
+
+    auto const t0 = std::chrono::steady_clock::now();
+    auto const transform = easy::esop::esop_from_pprm( tt );
+    auto const t1 = std::chrono::steady_clock::now();
+
+    fmt::print( "[i] n = {:2} cubes = {:8}\n", n, transform.size() );
+    fmt::print( "[i]   transform : {:8.3f}s\n", std::chrono::duration<double>( t1 - t0 ).count() );
+
+    /* the recursion is too slow beyond 18 variables */
+    if ( n <= 18u )
+    {
+      auto const recursive = kitty::esop_from_pprm( tt );
+      auto const t2 = std::chrono::steady_clock::now();
+      fmt::print( "[i]   recursive : {:8.3f}s {}\n", std::chrono::duration<double>( t2 - t1 ).count(), recursive.size() == transform.size() ? "" : "(mismatch)" );
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,74 @@
+#include <easy/esop/constructors.hpp>
+#include <easy/esop/cost.hpp>
+
+#include <kitty/kitty.hpp>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+
+/* compares RC2 configurations on Helliwell-MAXSAT with T-count weights */
+template<int NumVars>
+void compare( uint32_t num_functions, std::string const& name, easy::sat2::maxsat_solver_params const& maxsat_ps )
+{
+  using truth_table = kitty::static_truth_table<NumVars>;
+  using maxsat_t = easy::esop::esop_from_tt<truth_table, easy::sat2::maxsat_rc2, easy::esop::helliwell_maxsat>;
+
+  std::mt19937 gen( 0xcafe );
+  double time = 0.0;
+  uint64_t iterations = 0u, cores = 0u, exhausted = 0u, levels = 0u, removed = 0u, cost = 0u;
+
+  for ( auto i = 0u; i < num_functions; ++i )
+  {
+    truth_table tt;
+    kitty::create_random( tt, gen() );
+
+    easy::esop::helliwell_maxsat_statistics stats;
+    easy::esop::helliwell_maxsat_params ps;
+    ps.maxsat = maxsat_ps;
+
+    auto const t0 = std::chrono::steady_clock::now();
+    auto const esop = maxsat_t( stats, ps ).synthesize( tt, []( kitty::cube const& c ){ return int( easy::esop::T_count( c, NumVars ) ); } );
+    auto const t1 = std::chrono::steady_clock::now();
+
+    time += std::chrono::duration<double>( t1 - t0 ).count();
+    iterations += stats.maxsat.iterations;
+    cores += stats.maxsat.cores;
+    exhausted += stats.maxsat.exhausted;
+    levels += stats.maxsat.levels;
+    removed += stats.maxsat.removed_literals;
+    cost += easy::esop::T_count( esop, NumVars );
+  }
+
+  fmt::print( "[i] n = {} {:16} iterations = {:6} cores = {:6} exhausted = {:5} levels = {:4} removed = {:6} T-count = {:6} time = {:8.3f}s\n",
+              NumVars, name, iterations, cores, exhausted, levels, removed, cost, time );
+}
+
+template<int NumVars>
+void compare_all( uint32_t num_functions )
+{
+  easy::sat2::maxsat_solver_params ps;
+  ps.stratification = false;
+  ps.exhaust_cores = false;
+  compare<NumVars>( num_functions, "plain", ps );
+
+  ps.stratification = true;
+  compare<NumVars>( num_functions, "stratified", ps );
+
+  ps.exhaust_cores = true;
+  compare<NumVars>( num_functions, "+exhaust", ps );
+
+  ps.trim_cores = 8u;
+  compare<NumVars>( num_functions, "+trim", ps );
+
+  ps.minimize_cores = true;
+  compare<NumVars>( num_functions, "+minimize", ps );
+}
+
+int main()
+{
+  compare_all<3>( 100u );
+  compare_all<4>( 5u );
+  return 0;
+}
@@ -25,9 +25,16 @@
 
 #pragma once
 
+#include <easy/esop/cube_set.hpp>
+#include <easy/esop/esop_from_fprm.hpp>
+#include <easy/esop/esop_from_pprm.hpp>
+#include <easy/utils/stopwatch.hpp>
+#include <easy/utils/thread_pool.hpp>
 #include <kitty/kitty.hpp>
 
-#include <unordered_set>
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 enum class decomposition_type
@@ -41,7 +48,7 @@ namespace detail
 {
 
 template<typename TT>
-inline void kronecker_decomposition_rec( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& esop, TT const& tt, std::vector<decomposition_type> const& decomps,
+inline void kronecker_decomposition_rec( easy::esop::cube_set& esop, TT const& tt, std::vector<decomposition_type> const& decomps,
                                          uint8_t var_index, kitty::cube const& c )
 {
   /* terminal cases */
@@ -51,7 +58,7 @@ inline void kronecker_decomposition_rec( std::unordered_set<kitty::cube, kitty::
   }
   if ( is_const0( ~tt ) )
   {
-    kitty::detail::add_to_cubes( esop, c );
+    esop.add( c );
     return;
   }
 
@@ -81,7 +88,270 @@ inline std::vector<kitty::cube> kronecker_decomposition( TT const& tt, std::vect
 {
   assert( tt.num_vars() == decomps.size() );
 
-  std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
+  easy::esop::cube_set cubes( tt.num_vars() );
   detail::kronecker_decomposition_rec( cubes, tt, decomps, 0, kitty::cube() );
-  return std::vector<kitty::cube>( cubes.begin(), cubes.end() );
+  return cubes.esop();
+}
+
+struct kronecker_search_params
+{
+  uint32_t num_threads = 1u; /*>! Number of threads (0 denotes hardware concurrency) */
+};
+
+struct kronecker_search_statistics
+{
+  uint64_t nodes{0}; /*>! Number of visited prefixes of decomposition vectors */
+  uint64_t pruned{0}; /*>! Number of prefixes pruned by the lower bound */
+  uint64_t cost{0}; /*>! Number of cubes of the best Kronecker form */
+  easy::utils::stopwatch<>::duration time{0}; /*>! Total time */
+};
+
+struct kronecker_search_result
+{
+  std::vector<decomposition_type> decomposition;
+  std::vector<kitty::cube> esop;
+};
+
+namespace detail
+{
+
+/* in-place Kronecker transform of variable i; Shannon keeps the
+   cofactors (f0, f1), positive Davio yields (f0, f0 ^ f1), and negative
+   Davio (f1, f0 ^ f1) */
+inline void kronecker_variable( uint64_t* words, std::size_t num_words, uint32_t var_index, decomposition_type decomp, easy::esop::detail::xor_words_fn xor_words )
+{
+  switch ( decomp )
+  {
+  case decomposition_type::positive_davio:
+    easy::esop::detail::reed_muller_variable( words, num_words, var_index, xor_words );
+    break;
+  case decomposition_type::negative_davio:
+    easy::esop::detail::reed_muller_variable( words, num_words, var_index, xor_words );
+    easy::esop::detail::flip_polarity( words, num_words, var_index, xor_words );
+    break;
+  case decomposition_type::shannon:
+    break;
+  }
+}
+
+/* lower bound on the number of cubes after transforming the variables
+ * 0, ..., num_fixed - 1
+ *
+ * The transforms of the other variables are invertible on each
+ * subfunction that is obtained by fixing the transformed variables,
+ * such that each non-zero subfunction yields at least one cube. */
+inline uint64_t kronecker_lower_bound( std::vector<uint64_t> const& words, uint32_t num_fixed, uint32_t num_vars )
+{
+  if ( num_fixed < 6u )
+  {
+    uint64_t w = 0u;
+    for ( auto const word : words )
+    {
+      w |= word;
+    }
+    for ( auto v = num_fixed; v < 6u && v < num_vars; ++v )
+    {
+      w |= w >> ( 1u << v );
+    }
+    return __builtin_popcountll( w & ( ( uint64_t( 1 ) << ( 1u << num_fixed ) ) - 1u ) );
+  }
+
+  auto const stride = std::size_t( 1 ) << ( num_fixed - 6u );
+  uint64_t bound = 0u;
+  for ( auto s = 0u; s < stride; ++s )
+  {
+    uint64_t w = 0u;
+    for ( auto j = s; j < words.size(); j += stride )
+    {
+      w |= words[j];
+    }
+    bound += __builtin_popcountll( w );
+  }
+  return bound;
+}
+
+/* depth-first search over the decomposition vectors
+ *
+ * The vectors are numbered in base 3 with variable 0 as most
+ * significant digit, and (cost, number) pairs are packed into 64 bits
+ * such that the shared bound orders them lexicographically. */
+class kronecker_search
+{
+public:
+  explicit kronecker_search( uint32_t num_vars, std::atomic<uint64_t>& best )
+    : _num_vars( num_vars )
+    , _levels( num_vars + 1u )
+    , _best( best )
+    , _xor_words( easy::esop::detail::xor_words_function() )
+  {
+  }
+
+  void run( std::vector<uint64_t> const& words, uint64_t prefix, uint32_t depth )
+  {
+    _levels[depth] = words;
+    auto digits = prefix;
+    for ( auto v = depth; v-- > 0u; digits /= 3u )
+    {
+      kronecker_variable( _levels[depth].data(), words.size(), v, decomposition_type( digits % 3u ), _xor_words );
+    }
+    dfs( depth, prefix );
+  }
+
+  uint64_t nodes{0};
+  uint64_t pruned{0};
+
+private:
+  void dfs( uint32_t var_index, uint64_t number )
+  {
+    ++nodes;
+
+    auto const& words = _levels[var_index];
+    auto first_number = number;
+    for ( auto v = var_index; v < _num_vars; ++v )
+    {
+      first_number *= 3u;
+    }
+
+    auto const bound = ( kronecker_lower_bound( words, var_index, _num_vars ) << 32u ) | first_number;
+    if ( var_index == _num_vars )
+    {
+      auto best = _best.load();
+      while ( bound < best && !_best.compare_exchange_weak( best, bound ) )
+      {
+      }
+      return;
+    }
+    if ( bound >= _best.load() )
+    {
+      ++pruned;
+      return;
+    }
+
+    for ( auto d = 0u; d < 3u; ++d )
+    {
+      _levels[var_index + 1u] = words;
+      kronecker_variable( _levels[var_index + 1u].data(), words.size(), var_index, decomposition_type( d ), _xor_words );
+      dfs( var_index + 1u, 3u * number + d );
+    }
+  }
+
+private:
+  uint32_t _num_vars;
+  std::vector<std::vector<uint64_t>> _levels; /* truth table after transforming the first i variables */
+  std::atomic<uint64_t>& _best;
+  easy::esop::detail::xor_words_fn _xor_words;
+};
+
+} // namespace detail
+
+/*! \brief Finds the Kronecker decomposition vector with the fewest cubes
+ *
+ * Branch-and-bound search over the 3^n decomposition vectors.  The
+ * variables are decided in order, and the Kronecker spectrum is
+ * transformed in place one variable at a time, such that vectors with
+ * a common prefix share the transforms of the prefix.  A prefix is
+ * pruned if the number of non-zero subfunctions over the undecided
+ * variables is not smaller than the cost of the best vector.  For
+ * multiple threads, the prefixes of the first variables are searched
+ * in parallel and share the best cost.
+ *
+ * The cost of a vector is the number of non-zero coefficients of its
+ * Kronecker spectrum; the returned ESOP form is additionally merged
+ * with distance-1 merging and can have fewer cubes.  Among vectors
+ * with the same cost, the lexicographically smallest is returned.
+ *
+ * \param tt Truth table with at most 20 variables
+ * \param st Statistics
+ * \param ps Parameters
+ */
+template<typename TT>
+inline kronecker_search_result best_kronecker_decomposition( TT const& tt, kronecker_search_statistics& st, kronecker_search_params const& ps = {} )
+{
+  easy::utils::stopwatch t( st.time );
+
+  auto const num_vars = uint32_t( tt.num_vars() );
+  assert( num_vars <= 20u );
+
+  std::vector<uint64_t> const words( tt.cbegin(), tt.cend() );
+
+  auto const num_threads = ps.num_threads == 0u ? easy::utils::hardware_concurrency() : ps.num_threads;
+  auto depth = 0u;
+  uint64_t num_prefixes = 1u;
+  while ( num_threads > 1u && depth < num_vars && num_prefixes < 8u * num_threads )
+  {
+    ++depth;
+    num_prefixes *= 3u;
+  }
+
+  std::atomic<uint64_t> best{std::numeric_limits<uint64_t>::max()};
+  std::atomic<uint64_t> nodes{0}, pruned{0};
+  easy::utils::parallel_for( num_prefixes, num_threads, [&]( uint32_t, uint64_t prefix ) {
+    detail::kronecker_search search( num_vars, best );
+    search.run( words, prefix, depth );
+    nodes += search.nodes;
+    pruned += search.pruned;
+  } );
+
+  st.nodes = nodes;
+  st.pruned = pruned;
+  st.cost = best >> 32u;
+
+  kronecker_search_result result;
+  result.decomposition.resize( num_vars );
+  auto number = best & 0xffffffff;
+  for ( auto v = num_vars; v-- > 0u; number /= 3u )
+  {
+    result.decomposition[v] = decomposition_type( number % 3u );
+  }
+
+  /* cubes of the non-zero coefficients of the spectrum */
+  auto spectrum = words;
+  auto const xor_words = easy::esop::detail::xor_words_function();
+  for ( auto v = 0u; v < num_vars; ++v )
+  {
+    detail::kronecker_variable( spectrum.data(), spectrum.size(), v, result.decomposition[v], xor_words );
+  }
+
+  easy::esop::cube_set cubes( num_vars );
+  for ( auto j = 0u; j < spectrum.size(); ++j )
+  {
+    for ( auto w = spectrum[j]; w; w &= w - 1u )
+    {
+      auto const m = uint32_t( j * 64u + __builtin_ctzll( w ) );
+      kitty::cube c;
+      for ( auto v = 0u; v < num_vars; ++v )
+      {
+        auto const bit = ( m >> v ) & 1u;
+        switch ( result.decomposition[v] )
+        {
+        case decomposition_type::positive_davio:
+          if ( bit )
+          {
+            c.add_literal( v, true );
+          }
+          break;
+        case decomposition_type::negative_davio:
+          if ( bit )
+          {
+            c.add_literal( v, false );
+          }
+          break;
+        case decomposition_type::shannon:
+          c.add_literal( v, bit );
+          break;
+        }
+      }
+      cubes.add( c );
+    }
+  }
+  result.esop = cubes.esop();
+  return result;
+}
+
+/*! \brief Finds the Kronecker decomposition vector with the fewest cubes (see above) */
+template<typename TT>
+inline kronecker_search_result best_kronecker_decomposition( TT const& tt, kronecker_search_params const& ps = {} )
+{
+  kronecker_search_statistics st;
+  return best_kronecker_decomposition( tt, st, ps );
 }
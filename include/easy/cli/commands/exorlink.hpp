@@ -31,7 +31,7 @@ namespace alice
 std::uint32_t k_size[] = {/* 0 */ 0, /* 1 */ 0, /* 2 */ 8, /* 3 */ 54, /* 4 */ 384, /* 5 */ 3000, /* 6 */ 25920};
 std::uint32_t k_incr[] = {/* 0 */ 0, /* 1 */ 0, /* 2 */ 4, /* 3 */ 9, /* 4 */ 16, /* 5 */ 25, /* 6 */ 36};
 
-std::uint32_t* cube_groups[] = {
+std::uint32_t const* cube_groups[] = {
     nullptr, nullptr, &easy::esop::cube_groups2[0], &easy::esop::cube_groups3[0], &easy::esop::cube_groups4[0], &easy::esop::cube_groups5[0], &easy::esop::cube_groups6[0]};
 
 class exorlink_command : public command
@@ -24,6 +24,14 @@
  */
 
 #include <alice/alice.hpp>
+#include <easy/esop/synthesis.hpp>
+#include <easy/utils/thread_pool.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <vector>
 
 namespace alice
 {
@@ -40,181 +48,161 @@ public:
                                                 "\tfixed-size 0\n"
                                                 "\tdownward 1\n"
                                                 "\tupward 2\n" );
+    opts.add_option( "--jobs,-j", number_of_jobs, "Number of worker threads used with --all (default: 1, 0 uses all cores)" );
     opts.add_flag( "--all,-a", all_flag, "Use all functions in the function store" );
+    opts.add_flag( "--incremental,-i", incremental_flag, "Solve all bounds on one incremental SAT-solver (strategies 1 and 2)" );
     opts.add_flag( "--delete,-d", delete_flag, "Do not store any result but delete them" );
   }
 
 protected:
+  rules validity_rules() const
+  {
+    rules rules;
+
+    rules.push_back( {[this]() { return store<function_storee>().size() > 0; }, "function store is empty"} );
+    rules.push_back( {[this]() { return strategy >= 0 && strategy <= 2; }, "unknown strategy"} );
+
+    return rules;
+  }
+
   void execute()
   {
+    const auto function_store_size = store<function_storee>().size();
+    const auto first = all_flag ? 0u : function_store_size - 1u;
+    const auto count = function_store_size - first;
+
+    /* each worker synthesizes into its own slot, results are stored in input order afterwards */
+    std::vector<synthesis_entry> entries( count );
+    const auto start_time = std::chrono::steady_clock::now();
+    easy::utils::parallel_for( count, number_of_jobs == 0u ? easy::utils::hardware_concurrency() : number_of_jobs,
+                               [&]( uint32_t, uint64_t i ) { entries[i] = synthesize( store<function_storee>()[first + i] ); } );
+    const auto end_time = std::chrono::steady_clock::now();
+
     auto number_of_realizable = 0u;
     auto number_of_unrealizable = 0u;
     auto number_of_unknown = 0u;
     auto total_num_terms = 0;
+    auto total_conflicts = int64_t( 0 );
+    std::vector<double> times;
 
-    auto counter = 0;
-    auto total_duration = 0.0;
-
-    const auto function_store_size = store<function_storee>().size();
-    if ( !all_flag )
+    for ( auto i = 0u; i < count; ++i )
     {
-      ++counter;
-
-      const auto& func = store<function_storee>()[function_store_size - 1u];
-
-      auto bits = to_binary( func.bits );
-      auto care = to_binary( func.care );
-      std::reverse( bits.begin(), bits.end() );
-      std::reverse( care.begin(), care.end() );
-
-      const auto start_time = std::chrono::system_clock::now();
-
-      easy::esop::result synthesis_result;
-      if ( strategy == 0 )
-      {
-        easy::esop::simple_synthesizer_params params;
-        params.conflict_limit = number_of_conflicts;
-        params.number_of_terms = number_of_terms;
-
-        easy::esop::simple_synthesizer synthesizer( easy::esop::spec{bits, care} );
-        synthesis_result = synthesizer.synthesize( params );
-      }
-      else if ( strategy == 1 )
-      {
-        easy::esop::minimum_synthesizer_params params;
-        params.conflict_limit = number_of_conflicts;
-        params.begin = number_of_terms;
-        params.next = [&]( uint32_t& i, easy::sat::sat_solver::result sat ) { if ( i <= 1 || sat.is_unsat() ) return false; --i; return true; };
-
-        easy::esop::minimum_synthesizer synthesizer( easy::esop::spec{bits, care} );
-        synthesis_result = synthesizer.synthesize( params );
-      }
-      else if ( strategy == 2 )
-      {
-        easy::esop::minimum_synthesizer_params params;
-        params.conflict_limit = number_of_conflicts;
-        params.begin = 1;
-        params.next = [&]( uint32_t& i, easy::sat::sat_solver::result sat ) { if ( i >= number_of_terms || sat.is_sat() ) return false; ++i; return true; };
-
-        easy::esop::minimum_synthesizer synthesizer( easy::esop::spec{bits, care} );
-        synthesis_result = synthesizer.synthesize( params );
-      }
-      else
-      {
-        std::cout << "[e] unknown strategy" << std::endl;
-        return;
-      }
+      const auto& func = store<function_storee>()[first + i];
+      auto& entry = entries[i];
+      times.emplace_back( entry.time );
+      total_conflicts += entry.conflicts;
 
-      const auto end_time = std::chrono::system_clock::now();
-      total_duration += ( std::chrono::duration_cast<std::chrono::milliseconds>( end_time - start_time ).count() / 1000.0 );
-
-      if ( synthesis_result.is_unknown() )
+      if ( entry.result.is_unknown() )
       {
-        std::cout << "[w] could not synthesize function (conflict limit too tight)" << std::endl;
+        std::cout << "[w] could not synthesize function (conflict limit too tight) " << ( first + i ) << std::endl;
         ++number_of_unknown;
       }
-      else if ( synthesis_result.is_unrealizable() )
+      else if ( entry.result.is_unrealizable() )
       {
         std::cout << "[i] function is unrealizable" << std::endl;
         ++number_of_unrealizable;
       }
       else
       {
-        assert( synthesis_result.is_realizable() );
+        assert( entry.result.is_realizable() );
         ++number_of_realizable;
-        total_num_terms += synthesis_result.esop.size();
+        total_num_terms += entry.result.esop.size();
         if ( !delete_flag )
-          env->store<esop_storee>().extend() = esop_storee{"", synthesis_result.esop, func.number_of_variables, 1};
+          env->store<esop_storee>().extend() = esop_storee{"", std::move( entry.result.esop ), func.number_of_variables, 1, entry.time, entry.conflicts, entry.k};
       }
     }
+
+    const auto total_duration = std::accumulate( times.begin(), times.end(), 0.0 );
+    const auto wall_duration = std::chrono::duration<double>( end_time - start_time ).count();
+    std::sort( times.begin(), times.end() );
+
+    std::cout << "[i] " << rang::style::bold << "results: " << rang::style::reset;
+    std::cout << fmt::format( "#realizable={} / #unrealizable={} / #unknown={} / avg number of terms={} / avg conflicts={}\n",
+                              number_of_realizable, number_of_unrealizable, number_of_unknown, ( double( total_num_terms ) / number_of_realizable ),
+                              ( double( total_conflicts ) / count ) );
+    std::cout << "[i] " << rang::style::bold << "time: " << rang::style::reset;
+    std::cout << fmt::format( "total={}s / wall={}s / avg per func={}s / p50={}s / p95={}s / p99={}s\n",
+                              total_duration, wall_duration, ( total_duration / count ),
+                              percentile( times, 0.50 ), percentile( times, 0.95 ), percentile( times, 0.99 ) );
+  }
+
+private:
+  struct synthesis_entry
+  {
+    easy::esop::result result;
+    double time = 0.0; /* wall time in seconds */
+    int64_t conflicts = 0; /* SAT conflicts over all bounds */
+    uint32_t k = 0; /* last bound on the number of terms that was tried */
+  };
+
+  synthesis_entry synthesize( const function_storee& func ) const
+  {
+    auto bits = to_binary( func.bits );
+    auto care = to_binary( func.care );
+    std::reverse( bits.begin(), bits.end() );
+    std::reverse( care.begin(), care.end() );
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    synthesis_entry entry;
+    nlohmann::json stats;
+    if ( strategy == 0 )
+    {
+      easy::esop::simple_synthesizer_params params;
+      params.conflict_limit = number_of_conflicts;
+      params.number_of_terms = number_of_terms;
+
+      easy::esop::simple_synthesizer synthesizer( easy::esop::spec{bits, care} );
+      entry.result = synthesizer.synthesize( params );
+      stats = synthesizer.stats();
+    }
     else
     {
-      for ( auto i = 0u; i < function_store_size; ++i )
+      const uint32_t max_terms = number_of_terms;
+      easy::esop::minimum_synthesizer_params params;
+      params.conflict_limit = number_of_conflicts;
+      params.incremental = incremental_flag;
+      params.max_number_of_terms = number_of_terms;
+      if ( strategy == 1 )
       {
-        ++counter;
-
-        const auto& func = store<function_storee>()[i];
-
-        auto bits = to_binary( func.bits );
-        auto care = to_binary( func.care );
-        std::reverse( bits.begin(), bits.end() );
-        std::reverse( care.begin(), care.end() );
-
-        const auto start_time = std::chrono::system_clock::now();
-
-        easy::esop::result synthesis_result;
-        if ( strategy == 0 )
-        {
-          easy::esop::simple_synthesizer_params params;
-          params.conflict_limit = number_of_conflicts;
-          params.number_of_terms = number_of_terms;
-
-          easy::esop::simple_synthesizer synthesizer( easy::esop::spec{bits, care} );
-          synthesis_result = synthesizer.synthesize( params );
-        }
-        else if ( strategy == 1 )
-        {
-          easy::esop::minimum_synthesizer_params params;
-          params.conflict_limit = number_of_conflicts;
-          params.begin = number_of_terms;
-          params.next = [&]( uint32_t& i, easy::sat::sat_solver::result sat ) { if ( i <= 1 || sat.is_unsat() ) return false; --i; return true; };
-
-          easy::esop::minimum_synthesizer synthesizer( easy::esop::spec{bits, care} );
-          synthesis_result = synthesizer.synthesize( params );
-        }
-        else if ( strategy == 2 )
-        {
-          easy::esop::minimum_synthesizer_params params;
-          params.conflict_limit = number_of_conflicts;
-          params.begin = 1;
-          params.next = [&]( uint32_t& i, easy::sat::sat_solver::result sat ) { if ( i >= number_of_terms || sat.is_sat() ) return false; ++i; return true; };
-
-          easy::esop::minimum_synthesizer synthesizer( easy::esop::spec{bits, care} );
-          synthesis_result = synthesizer.synthesize( params );
-        }
-        else
-        {
-          std::cout << "[e] unknown strategy" << std::endl;
-          return;
-        }
-
-        const auto end_time = std::chrono::system_clock::now();
-        total_duration += ( std::chrono::duration_cast<std::chrono::milliseconds>( end_time - start_time ).count() / 1000.0 );
-
-        if ( synthesis_result.is_unknown() )
-        {
-          std::cout << "[w] could not synthesize function (conflict limit too tight) " << i << std::endl;
-          ++number_of_unknown;
-        }
-        else if ( synthesis_result.is_unrealizable() )
-        {
-          std::cout << "[i] function is unrealizable" << std::endl;
-          ++number_of_unrealizable;
-        }
-        else
-        {
-          assert( synthesis_result.is_realizable() );
-          ++number_of_realizable;
-          total_num_terms += synthesis_result.esop.size();
-          if ( !delete_flag )
-            env->store<esop_storee>().extend() = esop_storee{"", synthesis_result.esop, func.number_of_variables, 1};
-        }
+        params.begin = number_of_terms;
+        params.next = []( uint32_t& i, easy::sat::sat_solver::result sat ) { if ( i <= 1 || sat.is_unsat() ) return false; --i; return true; };
       }
+      else
+      {
+        params.begin = 1;
+        params.next = [max_terms]( uint32_t& i, easy::sat::sat_solver::result sat ) { if ( i >= max_terms || sat.is_sat() ) return false; ++i; return true; };
+      }
+
+      easy::esop::minimum_synthesizer synthesizer( easy::esop::spec{bits, care} );
+      entry.result = synthesizer.synthesize( params );
+      stats = synthesizer.stats();
     }
 
-    std::cout << "[i] " << rang::style::bold << "results: " << rang::style::reset;
-    std::cout << fmt::format( "#realizable={} / #unrealizable={} / #unknown={} / avg number of terms={}\n",
-                              number_of_realizable, number_of_unrealizable, number_of_unknown, ( double( total_num_terms ) / number_of_realizable ) );
-    std::cout << "[i] " << rang::style::bold << "time: " << rang::style::reset;
-    std::cout << fmt::format( "total={}s / avg per func={}s\n",
-                              total_duration, ( total_duration / counter ) );
+    entry.time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+    entry.conflicts = stats.value( "conflicts", int64_t( 0 ) );
+    entry.k = stats.value( "k", 0u );
+    return entry;
+  }
+
+  /* nearest-rank percentile of sorted values */
+  static double percentile( const std::vector<double>& sorted, double p )
+  {
+    if ( sorted.empty() )
+    {
+      return 0.0;
+    }
+    const auto rank = std::size_t( std::ceil( p * sorted.size() ) );
+    return sorted[std::max<std::size_t>( rank, 1u ) - 1u];
   }
 
 private:
   unsigned number_of_terms = 8u;
   unsigned number_of_conflicts = 10000u;
+  unsigned number_of_jobs = 1u;
   bool all_flag = false;
   bool delete_flag = false;
+  bool incremental_flag = false;
   int strategy = 0;
 }; /* synth_command */
 
@@ -34,6 +34,11 @@ struct esop_storee
   easy::esop::esop_t esop;
   std::size_t number_of_inputs;
   std::size_t number_of_outputs;
+
+  /* synthesis statistics (only set by synth) */
+  double time = 0.0;
+  int64_t conflicts = 0;
+  uint32_t k = 0;
 }; /* esop_storee */
 
 ALICE_ADD_STORE( esop_storee, "esop", "e", "ESOP", "ESOPs" )
@@ -28,6 +28,7 @@
 #include "algorithms/lp.hpp"
 #include "algorithms/kronecker_decomposition.hpp"
 #include "esop/esop.hpp"
+#include "esop/exorcism.hpp"
 #include "esop/exorlink.hpp"
 
 // Local Variables:
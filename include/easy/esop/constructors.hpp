@@ -33,6 +33,7 @@
 #pragma once
 
 #include <easy/esop/esop.hpp>
+#include <easy/esop/esop_from_fprm.hpp>
 #include <easy/esop/esop_from_pprm.hpp>
 #include <easy/esop/esop_from_pkrm.hpp>
 
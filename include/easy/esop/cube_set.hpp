@@ -0,0 +1,227 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file cube_set.hpp
+  \brief Set of cubes with indexed distance-1 lookup
+
+  \author Heinz Riener
+*/
+
+#pragma once
+
+#include <easy/esop/esop.hpp>
+#include <kitty/cube.hpp>
+#include <kitty/hash.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace easy::esop
+{
+
+/*! \brief Set of cubes of an ESOP form
+ *
+ * Adding a cube that is already contained cancels both cubes.  If
+ * distance-1 merging is enabled, a cube that has distance 1 to a
+ * contained cube is merged with it, and the merged cube is added
+ * again (which may cancel or merge further).  The cubes are then
+ * pairwise at distance at least 2.
+ *
+ * To find the distance-1 partner of a cube in expected constant time,
+ * each cube is indexed once per variable by its signature with that
+ * variable removed.  Two different cubes have the same signature for
+ * variable l if and only if they differ only in l, i.e., have
+ * distance 1.  Since no two contained cubes have distance 1, each
+ * signature identifies at most one cube.
+ *
+ * `Cube` is `kitty::cube` or a wide_cube; the signatures of
+ * `kitty::cube` are packed into 64-bit words.
+ */
+template<typename Cube>
+class basic_cube_set
+{
+public:
+  using container_type = std::unordered_set<Cube, kitty::hash<Cube>>;
+  using const_iterator = typename container_type::const_iterator;
+  using signature_type = std::conditional_t<std::is_same_v<Cube, kitty::cube>, uint64_t, Cube>;
+  using signature_hash = std::conditional_t<std::is_same_v<Cube, kitty::cube>, std::hash<uint64_t>, kitty::hash<Cube>>;
+
+public:
+  /*! \brief Constructor
+   *
+   * \param num_vars Number of variables that occur in the cubes
+   * \param distance_one_merging Merge cubes with distance 1
+   */
+  explicit basic_cube_set( uint32_t num_vars = 32u, bool distance_one_merging = true )
+    : _index( distance_one_merging ? num_vars : 0u )
+  {
+    assert( ( !std::is_same_v<Cube, kitty::cube> || num_vars <= 32u ) );
+  }
+
+  /*! \brief Adds a cube with cancellation and distance-1 merging */
+  void add( Cube c )
+  {
+    while ( true )
+    {
+      if ( contains( c ) )
+      {
+        erase( c );
+        return;
+      }
+
+      auto const other = find_distance_one( c );
+      if ( !other )
+      {
+        break;
+      }
+
+      erase( *other );
+      c = c.merge( *other );
+    }
+
+    insert( c );
+  }
+
+  /*! \brief Inserts a cube without cancellation and merging
+   *
+   * The cube must not be contained and must not have a distance-1
+   * partner if distance-1 merging is enabled.
+   */
+  void insert( Cube const& c )
+  {
+    _cubes.insert( c );
+    for ( auto l = 0u; l < _index.size(); ++l )
+    {
+      _index[l][signature( c, l )] = c;
+    }
+  }
+
+  /*! \brief Erases a contained cube */
+  void erase( Cube const& c )
+  {
+    _cubes.erase( c );
+    for ( auto l = 0u; l < _index.size(); ++l )
+    {
+      auto const it = _index[l].find( signature( c, l ) );
+      if ( it != _index[l].end() && it->second == c )
+      {
+        _index[l].erase( it );
+      }
+    }
+  }
+
+  /*! \brief Returns true if the cube is contained */
+  bool contains( Cube const& c ) const
+  {
+    return _cubes.find( c ) != _cubes.end();
+  }
+
+  /*! \brief Returns a contained cube with distance 1 to `c` (requires distance-1 merging) */
+  std::optional<Cube> find_distance_one( Cube const& c ) const
+  {
+    /* prefer partners in the last variables, which are the last ones
+       expanded by the recursive constructors and yield fewer cubes */
+    for ( auto l = _index.size(); l-- > 0u; )
+    {
+      auto const it = _index[l].find( signature( c, l ) );
+      if ( it != _index[l].end() && it->second != c )
+      {
+        return it->second;
+      }
+    }
+    return std::nullopt;
+  }
+
+  void clear()
+  {
+    _cubes.clear();
+    for ( auto& index : _index )
+    {
+      index.clear();
+    }
+  }
+
+  std::size_t size() const
+  {
+    return _cubes.size();
+  }
+
+  bool empty() const
+  {
+    return _cubes.empty();
+  }
+
+  const_iterator begin() const
+  {
+    return _cubes.begin();
+  }
+
+  const_iterator end() const
+  {
+    return _cubes.end();
+  }
+
+  /*! \brief Returns the cubes as ESOP form */
+  basic_esop_t<Cube> esop() const
+  {
+    return basic_esop_t<Cube>( _cubes.begin(), _cubes.end() );
+  }
+
+private:
+  /* the cube with variable l removed */
+  static signature_type signature( Cube const& c, uint32_t l )
+  {
+    if constexpr ( std::is_same_v<Cube, kitty::cube> )
+    {
+      return c._value & ~( ( uint64_t( 1 ) << l ) | ( uint64_t( 1 ) << ( 32u + l ) ) );
+    }
+    else
+    {
+      auto s = c;
+      s.remove_literal( l );
+      return s;
+    }
+  }
+
+private:
+  container_type _cubes;
+  std::vector<std::unordered_map<signature_type, Cube, signature_hash>> _index;
+}; /* basic_cube_set */
+
+using cube_set = basic_cube_set<kitty::cube>;
+
+} /* namespace easy::esop */
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -30,6 +30,7 @@
 #include <kitty/dynamic_truth_table.hpp>
 #include <kitty/print.hpp>
 #include <cassert>
+#include <type_traits>
 #include <vector>
 
 namespace easy::esop
@@ -40,7 +41,11 @@ namespace detail
 static constexpr auto XOR_SYMBOL = "\u2295";
 }
 
-using esop_t = std::vector<kitty::cube>;
+/*! \brief ESOP form over an arbitrary cube type, e.g., wide_cube */
+template<typename Cube>
+using basic_esop_t = std::vector<Cube>;
+
+using esop_t = basic_esop_t<kitty::cube>;
 using esops_t = std::vector<esop_t>;
 
 /*! \brief Minimum pairwise distance
@@ -50,7 +55,8 @@ using esops_t = std::vector<esop_t>;
  * \param esop ESOP
  * \return Minimum pairwise distance
  */
-inline unsigned min_pairwise_distance( const esop_t& esop )
+template<typename Cube>
+inline unsigned min_pairwise_distance( const basic_esop_t<Cube>& esop )
 {
   auto min = std::numeric_limits<unsigned>::max();
   for ( auto i = 0u; i < esop.size(); ++i )
@@ -74,7 +80,8 @@ inline unsigned min_pairwise_distance( const esop_t& esop )
  * \param esop ESOP
  * \return maximum pairwise distance
  */
-inline unsigned max_pairwise_distance( const esop_t& esop )
+template<typename Cube>
+inline unsigned max_pairwise_distance( const basic_esop_t<Cube>& esop )
 {
   unsigned max = 0;
   for ( auto i = 0u; i < esop.size(); ++i )
@@ -98,7 +105,8 @@ inline unsigned max_pairwise_distance( const esop_t& esop )
  * \param esop ESOP
  * \return average pairwise distance
  */
-inline double avg_pairwise_distance( const esop_t& esop )
+template<typename Cube>
+inline double avg_pairwise_distance( const basic_esop_t<Cube>& esop )
 {
   double dist = 0;
   auto counter = 0;
@@ -191,9 +199,10 @@ inline bool implements_function( const esop_t& esop, const kitty::dynamic_truth_
  * \param num_vars Number of variables
  * \param os Output stream
  */
-inline void print_esop_as_exprs( const esop_t& esop, unsigned num_vars, std::ostream& os = std::cout )
+template<typename Cube>
+inline void print_esop_as_exprs( const basic_esop_t<Cube>& esop, unsigned num_vars, std::ostream& os = std::cout )
 {
-  assert( num_vars <= 32 );
+  assert( ( !std::is_same_v<Cube, kitty::cube> || num_vars <= 32 ) );
   os << esop.size() << ' ';
   for ( auto i = 0u; i < esop.size(); ++i )
   {
@@ -208,9 +217,9 @@ inline void print_esop_as_exprs( const esop_t& esop, unsigned num_vars, std::ost
       os << "(";
       for ( auto j = 0u; j < num_vars; ++j )
       {
-        if ( ( c._mask >> j ) & 1 )
+        if ( c.get_mask( j ) )
         {
-          os << ( ( ( c._bits >> j ) & 1 ) ? "x" : "~x" ) << j;
+          os << ( c.get_bit( j ) ? "x" : "~x" ) << j;
           --lit_count;
           if ( lit_count != 0 )
           {
@@ -236,9 +245,10 @@ inline void print_esop_as_exprs( const esop_t& esop, unsigned num_vars, std::ost
  * \param num_vars Number of variables
  * \param os Output stream
  */
-inline void print_esop_as_cubes( const esop_t& esop, unsigned num_vars, std::ostream& os = std::cout )
+template<typename Cube>
+inline void print_esop_as_cubes( const basic_esop_t<Cube>& esop, unsigned num_vars, std::ostream& os = std::cout )
 {
-  assert( num_vars <= 32 );
+  assert( ( !std::is_same_v<Cube, kitty::cube> || num_vars <= 32 ) );
   for ( const auto& c : esop )
   {
     c.print( num_vars, os );
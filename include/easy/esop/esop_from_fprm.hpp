@@ -0,0 +1,305 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file esop_from_fprm.hpp
+  \brief Best fixed-polarity Reed-Muller form
+
+  \author Heinz Riener
+*/
+
+#pragma once
+
+#include <easy/esop/cost.hpp>
+#include <easy/esop/esop.hpp>
+#include <easy/esop/esop_from_pprm.hpp>
+#include <easy/utils/stopwatch.hpp>
+#include <easy/utils/thread_pool.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace easy::esop
+{
+
+enum class fprm_cost
+{
+  cubes,
+  T_count
+};
+
+struct fprm_params
+{
+  fprm_cost cost = fprm_cost::cubes; /*>! Cost function of the FPRM form */
+  uint32_t num_threads = 1u; /*>! Number of threads (0 denotes hardware concurrency) */
+};
+
+struct fprm_statistics
+{
+  uint64_t polarities{0}; /*>! Number of evaluated polarity vectors */
+  uint32_t polarity{0}; /*>! Best polarity vector (bit i is set if variable i is complemented) */
+  uint64_t cost{0}; /*>! Cost of the best FPRM form */
+  utils::stopwatch<>::duration time{0}; /*>! Total time */
+};
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* changes the polarity of variable i in a Reed-Muller spectrum
+ *
+ * With x = 1 ^ x', f = g ^ x h becomes f = ( g ^ h ) ^ x' h, i.e., the
+ * coefficient of each monomial without x is XORed with the coefficient
+ * of the monomial with x.  The change is self-inverse. */
+inline void flip_polarity( uint64_t* words, std::size_t num_words, uint32_t var_index, xor_words_fn xor_words )
+{
+  if ( var_index < 6u )
+  {
+    auto const shift = 1u << var_index;
+    auto const mask = reed_muller_masks[var_index];
+    for ( auto k = 0u; k < num_words; ++k )
+    {
+      words[k] ^= ( words[k] >> shift ) & mask;
+    }
+    return;
+  }
+
+  auto const step = std::size_t( 1 ) << ( var_index - 6u );
+  for ( auto j = 0u; j < num_words; j += 2u * step )
+  {
+    if ( step < 4u )
+    {
+      xor_words_scalar( words + j, words + j + step, step );
+    }
+    else
+    {
+      xor_words( words + j, words + j + step, step );
+    }
+  }
+}
+
+/* the positions in a word whose index has k bits set */
+inline constexpr std::array<uint64_t, 7u> make_literal_count_masks()
+{
+  std::array<uint64_t, 7u> masks{};
+  for ( auto b = 0u; b < 64u; ++b )
+  {
+    auto k = 0u;
+    for ( auto v = b; v; v >>= 1u )
+    {
+      k += v & 1u;
+    }
+    masks[k] |= uint64_t( 1 ) << b;
+  }
+  return masks;
+}
+
+inline constexpr auto literal_count_masks = make_literal_count_masks();
+
+/* cost of the FPRM form of a spectrum; all cubes with the same number
+   of literals have the same cost */
+class fprm_cost_function
+{
+public:
+  explicit fprm_cost_function( fprm_cost cost, uint32_t num_vars )
+    : _cost( cost )
+  {
+    for ( auto k = 0u; k <= num_vars; ++k )
+    {
+      auto const m = k == 32u ? ~0u : ( 1u << k ) - 1u;
+      _weights[k] = T_count( kitty::cube( m, m ), num_vars );
+    }
+  }
+
+  uint64_t operator()( uint64_t const* words, std::size_t num_words ) const
+  {
+    uint64_t cost = 0u;
+    if ( _cost == fprm_cost::cubes )
+    {
+      for ( auto j = 0u; j < num_words; ++j )
+      {
+        cost += __builtin_popcountll( words[j] );
+      }
+      return cost;
+    }
+
+    for ( auto j = 0u; j < num_words; ++j )
+    {
+      if ( words[j] == 0u )
+      {
+        continue;
+      }
+      auto const offset = __builtin_popcountll( j );
+      for ( auto k = 0u; k < 7u; ++k )
+      {
+        cost += __builtin_popcountll( words[j] & literal_count_masks[k] ) * _weights[offset + k];
+      }
+    }
+    return cost;
+  }
+
+private:
+  fprm_cost _cost;
+  std::array<uint64_t, 39u> _weights{};
+};
+
+} // namespace detail
+/*! \endcond */
+
+/*! \brief Computes the fixed-polarity Reed-Muller form of minimum cost
+
+  Evaluates all 2^n polarity vectors.  The Reed-Muller spectrum of the
+  positive polarity is computed once (see pprm_spectrum); the polarity
+  vectors are then visited in Gray-code order, such that each step
+  changes the polarity of a single variable in place with O(2^n) bit
+  operations.  For multiple threads, the polarities of the last
+  variables are fixed per task and the remaining variables are walked
+  in each task.
+
+  Ties are broken by the smaller polarity vector, such that the result
+  does not depend on the number of threads.
+
+  \param tt Truth table
+  \param st Statistics
+  \param ps Parameters
+*/
+template<typename TT>
+inline esop_t esop_from_best_fprm( const TT& tt, fprm_statistics& st, fprm_params const& ps = {} )
+{
+  utils::stopwatch t( st.time );
+
+  auto const num_vars = uint32_t( tt.num_vars() );
+  assert( num_vars <= 32u );
+
+  auto const pprm = pprm_spectrum( tt );
+  std::vector<uint64_t> const spectrum( pprm.begin(), pprm.end() );
+  auto const num_words = spectrum.size();
+  auto const xor_words = detail::xor_words_function();
+  detail::fprm_cost_function const cost( ps.cost, num_vars );
+
+  auto const num_threads = ps.num_threads == 0u ? utils::hardware_concurrency() : ps.num_threads;
+  auto prefix_vars = 0u;
+  while ( num_threads > 1u && prefix_vars < num_vars && ( 1u << prefix_vars ) < 4u * num_threads )
+  {
+    ++prefix_vars;
+  }
+  auto const walk_vars = num_vars - prefix_vars;
+
+  struct best_polarity
+  {
+    uint64_t cost = std::numeric_limits<uint64_t>::max();
+    uint32_t polarity = 0u;
+    uint64_t polarities = 0u;
+  };
+  std::vector<best_polarity> best( num_threads );
+
+  utils::parallel_for( uint64_t( 1 ) << prefix_vars, num_threads, [&]( uint32_t worker, uint64_t prefix ) {
+    auto words = spectrum;
+    auto polarity = uint32_t( prefix << walk_vars );
+    for ( auto v = walk_vars; v < num_vars; ++v )
+    {
+      if ( ( polarity >> v ) & 1u )
+      {
+        detail::flip_polarity( words.data(), num_words, v, xor_words );
+      }
+    }
+
+    auto& b = best[worker];
+    auto const evaluate = [&]() {
+      auto const c = cost( words.data(), num_words );
+      ++b.polarities;
+      if ( c < b.cost || ( c == b.cost && polarity < b.polarity ) )
+      {
+        b.cost = c;
+        b.polarity = polarity;
+      }
+    };
+
+    evaluate();
+    for ( uint64_t k = 1u; k < ( uint64_t( 1 ) << walk_vars ); ++k )
+    {
+      auto const v = uint32_t( __builtin_ctzll( k ) );
+      detail::flip_polarity( words.data(), num_words, v, xor_words );
+      polarity ^= 1u << v;
+      evaluate();
+    }
+  } );
+
+  best_polarity result;
+  for ( const auto& b : best )
+  {
+    result.polarities += b.polarities;
+    if ( b.cost < result.cost || ( b.cost == result.cost && b.polarity < result.polarity ) )
+    {
+      result.cost = b.cost;
+      result.polarity = b.polarity;
+    }
+  }
+  st.polarities = result.polarities;
+  st.polarity = result.polarity;
+  st.cost = result.cost;
+
+  /* the cube of monomial m has a complemented literal for each complemented variable */
+  auto words = spectrum;
+  for ( auto v = 0u; v < num_vars; ++v )
+  {
+    if ( ( result.polarity >> v ) & 1u )
+    {
+      detail::flip_polarity( words.data(), num_words, v, xor_words );
+    }
+  }
+
+  esop_t esop;
+  for ( auto j = 0u; j < num_words; ++j )
+  {
+    auto word = words[j];
+    while ( word )
+    {
+      auto const m = uint32_t( j * 64u + __builtin_ctzll( word ) );
+      esop.emplace_back( m & ~result.polarity, m );
+      word &= word - 1u;
+    }
+  }
+  return esop;
+}
+
+/*! \brief Computes the fixed-polarity Reed-Muller form of minimum cost (see above) */
+template<typename TT>
+inline esop_t esop_from_best_fprm( const TT& tt, fprm_params const& ps = {} )
+{
+  fprm_statistics st;
+  return esop_from_best_fprm( tt, st, ps );
+}
+
+} // namespace easy::esop
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
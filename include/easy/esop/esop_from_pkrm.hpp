@@ -35,15 +35,51 @@
 
 #include <easy/esop/esop.hpp>
 #include <easy/esop/cube_manipulators.hpp>
+#include <easy/esop/cube_set.hpp>
+#include <easy/utils/stopwatch.hpp>
+#include <easy/utils/thread_pool.hpp>
+#include <kitty/dynamic_truth_table.hpp>
 #include <kitty/hash.hpp>
 #include <kitty/operations.hpp>
 #include <kitty/operators.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace easy::esop
 {
 
+struct pkrm_params
+{
+  uint32_t num_threads = 1u; /*>! Number of threads (0 denotes hardware concurrency) */
+  uint64_t cache_capacity = 0u; /*>! Maximum number of cached expansions (0 denotes no limit) */
+  uint32_t cache_shards = 64u; /*>! Number of independently locked parts of the cache */
+};
+
+struct pkrm_statistics
+{
+  uint64_t cache_lookups{0}; /*>! Number of cache lookups */
+  uint64_t cache_hits{0}; /*>! Number of cache lookups that found the expansion */
+  uint64_t cache_evictions{0}; /*>! Number of expansions evicted from the cache */
+  uint64_t peak_cache_size{0}; /*>! Largest number of cached expansions */
+  uint64_t parallel_tasks{0}; /*>! Number of subfunctions expanded in parallel */
+  utils::stopwatch<>::duration time{0}; /*>! Total time */
+
+  /*! \brief Fraction of cache lookups that found the expansion */
+  double hit_rate() const
+  {
+    return cache_lookups == 0u ? 0.0 : double( cache_hits ) / double( cache_lookups );
+  }
+};
+
 /*! \cond PRIVATE */
 namespace detail
 {
@@ -55,80 +91,316 @@ enum class pkrm_decomposition
   shannon
 };
 
-template<typename TT>
-using expansion_cache = std::unordered_map<TT, std::pair<uint32_t, pkrm_decomposition>, kitty::hash<TT>>;
+struct pkrm_expansion
+{
+  uint32_t cost;
+  pkrm_decomposition decomposition;
+};
 
-template<typename TT>
-inline uint32_t find_pkrm_expansions( const TT& tt, expansion_cache<TT>& cache, uint8_t var_index )
+/* bits 0, 2, 4, ... of a word in the lower half */
+inline uint64_t compress_even_bits( uint64_t x )
 {
-  /* terminal cases */
-  if ( is_const0( tt ) )
+  x &= 0x5555555555555555;
+  x = ( x | ( x >> 1 ) ) & 0x3333333333333333;
+  x = ( x | ( x >> 2 ) ) & 0x0f0f0f0f0f0f0f0f;
+  x = ( x | ( x >> 4 ) ) & 0x00ff00ff00ff00ff;
+  x = ( x | ( x >> 8 ) ) & 0x0000ffff0000ffff;
+  x = ( x | ( x >> 16 ) ) & 0x00000000ffffffff;
+  return x;
+}
+
+/* cofactors of variable 0 as truth tables over the remaining variables
+ *
+ * The subfunctions in the expansion of variable i do not depend on the
+ * variables 0, ..., i, such that they are stored with 2^(n-i-1) bits
+ * and the next variable to expand is always variable 0. */
+inline std::pair<kitty::dynamic_truth_table, kitty::dynamic_truth_table> shrink_cofactors( kitty::dynamic_truth_table const& tt )
+{
+  assert( tt.num_vars() > 0u );
+  kitty::dynamic_truth_table tt0( tt.num_vars() - 1u ), tt1( tt.num_vars() - 1u );
+
+  auto const words = tt.cbegin();
+  if ( tt.num_blocks() == 1u )
   {
-    return 0;
+    *tt0.begin() = compress_even_bits( words[0] );
+    *tt1.begin() = compress_even_bits( words[0] >> 1u );
+    return {tt0, tt1};
   }
-  if ( is_const0( ~tt ) )
+
+  auto it0 = tt0.begin(), it1 = tt1.begin();
+  for ( auto j = 0u; j < tt.num_blocks(); j += 2u, ++it0, ++it1 )
   {
-    return 1;
+    *it0 = compress_even_bits( words[j] ) | ( compress_even_bits( words[j + 1u] ) << 32u );
+    *it1 = compress_even_bits( words[j] >> 1u ) | ( compress_even_bits( words[j + 1u] >> 1u ) << 32u );
   }
+  return {tt0, tt1};
+}
 
-  /* already computed */
-  const auto it = cache.find( tt );
-  if ( it != cache.end() )
+/* inverse of compress_even_bits */
+inline uint64_t spread_even_bits( uint64_t x )
+{
+  x &= 0x00000000ffffffff;
+  x = ( x | ( x << 16 ) ) & 0x0000ffff0000ffff;
+  x = ( x | ( x << 8 ) ) & 0x00ff00ff00ff00ff;
+  x = ( x | ( x << 4 ) ) & 0x0f0f0f0f0f0f0f0f;
+  x = ( x | ( x << 2 ) ) & 0x3333333333333333;
+  x = ( x | ( x << 1 ) ) & 0x5555555555555555;
+  return x;
+}
+
+/* inverse of shrink_cofactors */
+inline kitty::dynamic_truth_table merge_cofactors( kitty::dynamic_truth_table const& tt0, kitty::dynamic_truth_table const& tt1 )
+{
+  kitty::dynamic_truth_table tt( tt0.num_vars() + 1u );
+
+  auto const words0 = tt0.cbegin();
+  auto const words1 = tt1.cbegin();
+  auto it = tt.begin();
+  if ( tt.num_blocks() == 1u )
   {
-    return it->second.first;
+    *it = spread_even_bits( words0[0] ) | ( spread_even_bits( words1[0] ) << 1u );
+    return tt;
   }
 
-  const auto tt0 = cofactor0( tt, var_index );
-  const auto tt1 = cofactor1( tt, var_index );
+  for ( auto j = 0u; j < tt0.num_blocks(); ++j )
+  {
+    *it++ = spread_even_bits( words0[j] ) | ( spread_even_bits( words1[j] ) << 1u );
+    *it++ = spread_even_bits( words0[j] >> 32u ) | ( spread_even_bits( words1[j] >> 32u ) << 1u );
+  }
+  return tt;
+}
 
-  const auto ex0 = find_pkrm_expansions( tt0, cache, var_index + 1 );
-  const auto ex1 = find_pkrm_expansions( tt1, cache, var_index + 1 );
-  const auto ex2 = find_pkrm_expansions( tt0 ^ tt1, cache, var_index + 1 );
+/* 128-bit hash of a truth table */
+struct pkrm_cache_key
+{
+  uint64_t lo;
+  uint64_t hi;
 
-  const auto ex_max = std::max( std::max( ex0, ex1 ), ex2 );
+  bool operator==( pkrm_cache_key const& that ) const
+  {
+    return lo == that.lo && hi == that.hi;
+  }
+};
+
+struct pkrm_cache_key_hash
+{
+  std::size_t operator()( pkrm_cache_key const& key ) const
+  {
+    return key.lo;
+  }
+};
 
-  uint32_t cost{};
-  pkrm_decomposition decomp;
+inline uint64_t mix64( uint64_t x )
+{
+  x ^= x >> 30u;
+  x *= 0xbf58476d1ce4e5b9;
+  x ^= x >> 27u;
+  x *= 0x94d049bb133111eb;
+  x ^= x >> 31u;
+  return x;
+}
 
+inline pkrm_cache_key make_pkrm_cache_key( kitty::dynamic_truth_table const& tt )
+{
+  pkrm_cache_key key{0x9e3779b97f4a7c15 ^ tt.num_vars(), 0xc2b2ae3d27d4eb4f ^ tt.num_vars()};
+  for ( auto it = tt.cbegin(); it != tt.cend(); ++it )
+  {
+    key.lo = mix64( key.lo ^ *it );
+    key.hi = mix64( ( key.hi + *it ) * 0xff51afd7ed558ccd );
+  }
+  return key;
+}
+
+/* concurrent cache of expansions with least-recently-used eviction
+ *
+ * The cache is split into shards by hash, each with its own lock, list
+ * of keys in order of use, and share of the capacity.  Entries are
+ * found by 128-bit hash and store the truth table to verify hits. */
+class pkrm_cache
+{
+public:
+  explicit pkrm_cache( uint64_t capacity, uint32_t num_shards )
+    : _shards( std::max( num_shards, 1u ) )
+    , _shard_capacity( capacity == 0u ? 0u : std::max<uint64_t>( capacity / _shards.size(), 1u ) )
+  {
+  }
+
+  std::optional<pkrm_expansion> find( kitty::dynamic_truth_table const& tt, pkrm_cache_key const& key )
+  {
+    ++_lookups;
+    auto& shard = shard_of( key );
+    std::lock_guard<std::mutex> lock( shard.mutex );
+
+    auto const it = shard.entries.find( key );
+    if ( it == shard.entries.end() || !std::equal( tt.cbegin(), tt.cend(), it->second.words.begin(), it->second.words.end() ) )
+    {
+      return std::nullopt;
+    }
+    ++_hits;
+    shard.order.splice( shard.order.begin(), shard.order, it->second.position );
+    return it->second.expansion;
+  }
+
+  void insert( kitty::dynamic_truth_table const& tt, pkrm_cache_key const& key, pkrm_expansion const& expansion )
+  {
+    auto& shard = shard_of( key );
+    std::lock_guard<std::mutex> lock( shard.mutex );
+
+    auto it = shard.entries.find( key );
+    if ( it != shard.entries.end() )
+    {
+      /* hash collision or concurrent expansion */
+      it->second.words.assign( tt.cbegin(), tt.cend() );
+      it->second.expansion = expansion;
+      return;
+    }
+
+    if ( _shard_capacity != 0u && shard.entries.size() >= _shard_capacity )
+    {
+      shard.entries.erase( shard.order.back() );
+      shard.order.pop_back();
+      ++_evictions;
+      --_size;
+    }
+
+    shard.order.push_front( key );
+    shard.entries.emplace( key, entry{std::vector<uint64_t>( tt.cbegin(), tt.cend() ), expansion, shard.order.begin()} );
+
+    auto const size = ++_size;
+    auto peak = _peak_size.load();
+    while ( size > peak && !_peak_size.compare_exchange_weak( peak, size ) )
+    {
+    }
+  }
+
+  void update_statistics( pkrm_statistics& st ) const
+  {
+    st.cache_lookups = _lookups;
+    st.cache_hits = _hits;
+    st.cache_evictions = _evictions;
+    st.peak_cache_size = _peak_size;
+  }
+
+private:
+  struct entry
+  {
+    std::vector<uint64_t> words;
+    pkrm_expansion expansion;
+    std::list<pkrm_cache_key>::iterator position;
+  };
+
+  struct shard
+  {
+    std::mutex mutex;
+    std::unordered_map<pkrm_cache_key, entry, pkrm_cache_key_hash> entries;
+    std::list<pkrm_cache_key> order; /* most recently used first */
+  };
+
+  shard& shard_of( pkrm_cache_key const& key )
+  {
+    return _shards[key.hi % _shards.size()];
+  }
+
+private:
+  std::vector<shard> _shards;
+  uint64_t _shard_capacity;
+
+  std::atomic<uint64_t> _lookups{0};
+  std::atomic<uint64_t> _hits{0};
+  std::atomic<uint64_t> _evictions{0};
+  std::atomic<uint64_t> _size{0};
+  std::atomic<uint64_t> _peak_size{0};
+};
+
+/* number of cubes of the optimum PKRM of a subfunction; expansions
+   that are not cached (anymore) are recomputed */
+inline uint32_t find_pkrm_expansions( kitty::dynamic_truth_table const& tt, pkrm_cache& cache );
+
+inline pkrm_expansion find_pkrm_expansion( kitty::dynamic_truth_table const& tt, pkrm_cache& cache )
+{
+  auto const key = make_pkrm_cache_key( tt );
+  if ( const auto expansion = cache.find( tt, key ) )
+  {
+    return *expansion;
+  }
+
+  const auto [tt0, tt1] = shrink_cofactors( tt );
+
+  const auto ex0 = find_pkrm_expansions( tt0, cache );
+  const auto ex1 = find_pkrm_expansions( tt1, cache );
+  const auto ex2 = find_pkrm_expansions( tt0 ^ tt1, cache );
+
+  const auto ex_max = std::max( std::max( ex0, ex1 ), ex2 );
+
+  /* drop the most expensive of the three subfunctions */
+  pkrm_expansion expansion;
   if ( ex_max == ex0 )
   {
-    cost = ex1 + ex2;
-    decomp = pkrm_decomposition::positive_davio;
+    expansion = {ex1 + ex2, pkrm_decomposition::negative_davio};
   }
   else if ( ex_max == ex1 )
   {
-    cost = ex0 + ex2;
-    decomp = pkrm_decomposition::negative_davio;
+    expansion = {ex0 + ex2, pkrm_decomposition::positive_davio};
   }
   else
   {
-    cost = ex0 + ex1;
-    decomp = pkrm_decomposition::shannon;
+    expansion = {ex0 + ex1, pkrm_decomposition::shannon};
   }
-  cache.insert( {tt, {cost, decomp}} );
-  return cost;
+  cache.insert( tt, key, expansion );
+  return expansion;
 }
 
-template<typename TT>
-inline void optimum_pkrm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& pkrm, const TT& tt, const expansion_cache<TT>& cache, uint8_t var_index, const kitty::cube& c )
+inline uint32_t find_pkrm_expansions( kitty::dynamic_truth_table const& tt, pkrm_cache& cache )
 {
   /* terminal cases */
   if ( is_const0( tt ) )
   {
-    return;
+    return 0;
   }
   if ( is_const0( ~tt ) )
   {
-    add_to_cubes( pkrm, c );
+    return 1;
+  }
+
+  return find_pkrm_expansion( tt, cache ).cost;
+}
+
+/* distinct non-constant subfunctions after expanding `depth` variables */
+inline void collect_pkrm_subfunctions( std::vector<kitty::dynamic_truth_table>& subfunctions, std::unordered_set<pkrm_cache_key, pkrm_cache_key_hash>& visited, kitty::dynamic_truth_table const& tt, uint32_t depth )
+{
+  if ( is_const0( tt ) || is_const0( ~tt ) || !visited.insert( make_pkrm_cache_key( tt ) ).second )
+  {
+    return;
+  }
+  if ( depth == 0u )
+  {
+    subfunctions.push_back( tt );
     return;
   }
 
-  const auto& p = cache.at( tt );
+  const auto [tt0, tt1] = shrink_cofactors( tt );
+  collect_pkrm_subfunctions( subfunctions, visited, tt0, depth - 1u );
+  collect_pkrm_subfunctions( subfunctions, visited, tt1, depth - 1u );
+  collect_pkrm_subfunctions( subfunctions, visited, tt0 ^ tt1, depth - 1u );
+}
 
-  const auto tt0 = cofactor0( tt, var_index );
-  const auto tt1 = cofactor1( tt, var_index );
+inline void optimum_pkrm_rec( cube_set& pkrm, kitty::dynamic_truth_table const& tt, pkrm_cache& cache, uint8_t var_index, const kitty::cube& c )
+{
+  /* terminal cases */
+  if ( is_const0( tt ) )
+  {
+    return;
+  }
+  if ( is_const0( ~tt ) )
+  {
+    pkrm.add( c );
+    return;
+  }
+
+  const auto decomposition = find_pkrm_expansion( tt, cache ).decomposition;
+  const auto [tt0, tt1] = shrink_cofactors( tt );
 
-  switch ( p.second )
+  switch ( decomposition )
   {
   case pkrm_decomposition::positive_davio:
     optimum_pkrm_rec( pkrm, tt0, cache, var_index + 1, c );
@@ -144,6 +416,125 @@ inline void optimum_pkrm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty:
     break;
   }
 }
+/* PKRM expansion of an incompletely specified function together with
+   the completely specified function that it realizes */
+struct isf_pkrm_expansion
+{
+  uint32_t cost;
+  pkrm_decomposition decomposition;
+  kitty::dynamic_truth_table completion;
+};
+
+struct isf_pkrm_cache_hash
+{
+  std::size_t operator()( std::pair<kitty::dynamic_truth_table, kitty::dynamic_truth_table> const& key ) const
+  {
+    auto seed = kitty::hash<kitty::dynamic_truth_table>()( key.first );
+    kitty::hash_combine( seed, kitty::hash<kitty::dynamic_truth_table>()( key.second ) );
+    return seed;
+  }
+};
+
+using isf_pkrm_cache = std::unordered_map<std::pair<kitty::dynamic_truth_table, kitty::dynamic_truth_table>, isf_pkrm_expansion, isf_pkrm_cache_hash>;
+
+/* The three expansions of a function f with cofactors f0 and f1 (and
+ * care sets c0 and c1) are
+ *
+ *   Shannon:          g0 on c0 and g1 on c1, i.e., f = x' g0 ^ x g1,
+ *   positive Davio:   g0 on c0 and h = g0 ^ f1 on c1, i.e., f = g0 ^ x h,
+ *   negative Davio:   g1 on c1 and h = g1 ^ f0 on c0, i.e., f = g1 ^ x' h,
+ *
+ * where the don't cares of h are assigned by the completion of g0
+ * (g1).  The completions are passed upwards, such that the expansion
+ * with the fewest cubes determines the don't cares of the node. */
+inline isf_pkrm_expansion find_isf_pkrm_expansion( kitty::dynamic_truth_table const& on, kitty::dynamic_truth_table const& care, isf_pkrm_cache& cache )
+{
+  /* terminal cases */
+  if ( is_const0( on & care ) )
+  {
+    return {0u, pkrm_decomposition::shannon, on.construct()};
+  }
+  if ( is_const0( ~on & care ) )
+  {
+    return {1u, pkrm_decomposition::shannon, ~on.construct()};
+  }
+
+  auto key = std::make_pair( on & care, care );
+  const auto it = cache.find( key );
+  if ( it != cache.end() )
+  {
+    return it->second;
+  }
+
+  const auto [on0, on1] = shrink_cofactors( key.first );
+  const auto [care0, care1] = shrink_cofactors( care );
+
+  const auto g0 = find_isf_pkrm_expansion( on0, care0, cache );
+  const auto g1 = find_isf_pkrm_expansion( on1, care1, cache );
+  const auto h_pd = find_isf_pkrm_expansion( g0.completion ^ on1, care1, cache );
+  const auto h_nd = find_isf_pkrm_expansion( g1.completion ^ on0, care0, cache );
+
+  const auto cost_sh = g0.cost + g1.cost;
+  const auto cost_pd = g0.cost + h_pd.cost;
+  const auto cost_nd = g1.cost + h_nd.cost;
+
+  isf_pkrm_expansion expansion;
+  if ( cost_pd <= cost_nd && cost_pd <= cost_sh )
+  {
+    expansion = {cost_pd, pkrm_decomposition::positive_davio, merge_cofactors( g0.completion, g0.completion ^ h_pd.completion )};
+  }
+  else if ( cost_nd <= cost_sh )
+  {
+    expansion = {cost_nd, pkrm_decomposition::negative_davio, merge_cofactors( g1.completion ^ h_nd.completion, g1.completion )};
+  }
+  else
+  {
+    expansion = {cost_sh, pkrm_decomposition::shannon, merge_cofactors( g0.completion, g1.completion )};
+  }
+  cache.emplace( std::move( key ), expansion );
+  return expansion;
+}
+
+inline void isf_pkrm_rec( cube_set& pkrm, kitty::dynamic_truth_table const& on, kitty::dynamic_truth_table const& care, isf_pkrm_cache& cache, uint8_t var_index, const kitty::cube& c )
+{
+  /* terminal cases */
+  if ( is_const0( on & care ) )
+  {
+    return;
+  }
+  if ( is_const0( ~on & care ) )
+  {
+    pkrm.add( c );
+    return;
+  }
+
+  const auto decomposition = find_isf_pkrm_expansion( on, care, cache ).decomposition;
+  const auto [on0, on1] = shrink_cofactors( on & care );
+  const auto [care0, care1] = shrink_cofactors( care );
+
+  switch ( decomposition )
+  {
+  case pkrm_decomposition::positive_davio:
+  {
+    const auto g0 = find_isf_pkrm_expansion( on0, care0, cache ).completion;
+    isf_pkrm_rec( pkrm, on0, care0, cache, var_index + 1, c );
+    isf_pkrm_rec( pkrm, g0 ^ on1, care1, cache, var_index + 1, with_literal( c, var_index, true ) );
+  }
+  break;
+  case pkrm_decomposition::negative_davio:
+  {
+    const auto g1 = find_isf_pkrm_expansion( on1, care1, cache ).completion;
+    isf_pkrm_rec( pkrm, on1, care1, cache, var_index + 1, c );
+    isf_pkrm_rec( pkrm, g1 ^ on0, care0, cache, var_index + 1, with_literal( c, var_index, false ) );
+  }
+  break;
+  case pkrm_decomposition::shannon:
+    isf_pkrm_rec( pkrm, on0, care0, cache, var_index + 1, with_literal( c, var_index, false ) );
+    isf_pkrm_rec( pkrm, on1, care1, cache, var_index + 1, with_literal( c, var_index, true ) );
+    break;
+  }
+}
+
 } // namespace detail
 /*! \endcond */
 
@@ -154,18 +545,91 @@ inline void optimum_pkrm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty:
 
   The algorithm applies post-optimization to merge distance-1 cubes.
 
+  The subfunctions are stored over the variables that are not expanded
+  yet and memoized in a concurrent cache, which is bounded by
+  `ps.cache_capacity`; evicted expansions are recomputed when they are
+  needed again.  For multiple threads, the distinct subfunctions after
+  expanding the first variables are expanded in parallel first.
+
   \param tt Truth table
+  \param st Statistics
+  \param ps Parameters
+*/
+template<typename TT>
+inline esop_t esop_from_optimum_pkrm( const TT& tt, pkrm_statistics& st, pkrm_params const& ps = {} )
+{
+  utils::stopwatch t( st.time );
+
+  kitty::dynamic_truth_table root( tt.num_vars() );
+  std::copy( tt.cbegin(), tt.cend(), root.begin() );
+
+  detail::pkrm_cache cache( ps.cache_capacity, ps.cache_shards );
+
+  auto const num_threads = ps.num_threads == 0u ? utils::hardware_concurrency() : ps.num_threads;
+  if ( num_threads > 1u )
+  {
+    /* enough tasks to balance the load */
+    auto depth = 0u;
+    for ( auto tasks = 1u; depth < uint32_t( tt.num_vars() ) && tasks < 8u * num_threads; tasks *= 3u )
+    {
+      ++depth;
+    }
+
+    std::vector<kitty::dynamic_truth_table> subfunctions;
+    std::unordered_set<detail::pkrm_cache_key, detail::pkrm_cache_key_hash> visited;
+    detail::collect_pkrm_subfunctions( subfunctions, visited, root, depth );
+    st.parallel_tasks = subfunctions.size();
+
+    utils::parallel_for( subfunctions.size(), num_threads, [&]( uint32_t, uint64_t index ) {
+      detail::find_pkrm_expansions( subfunctions[index], cache );
+    } );
+  }
+
+  cube_set cubes( tt.num_vars() );
+  detail::find_pkrm_expansions( root, cache );
+  detail::optimum_pkrm_rec( cubes, root, cache, 0, kitty::cube() );
+
+  cache.update_statistics( st );
+  return cubes.esop();
+}
+
+/*! \brief Computes ESOP representation using optimum PKRM (see above) */
+template<typename TT>
+inline esop_t esop_from_optimum_pkrm( const TT& tt, pkrm_params const& ps = {} )
+{
+  pkrm_statistics st;
+  return esop_from_optimum_pkrm( tt, st, ps );
+}
+
+/*! \brief Computes ESOP representation of an incompletely specified function using PKRM
+
+  Heuristic variant of the optimum PKRM for functions with don't cares.
+  At each node, the Shannon, positive Davio, and negative Davio
+  expansions are evaluated with the care sets of the cofactors.  The
+  don't cares of the sub-expansions are assigned bottom-up, and the
+  expansion with the fewest cubes is chosen.  The expansions are
+  memoized by pairs of on-set and care set.
+
+  The resulting ESOP agrees with `bits` on `care`; it can serve as an
+  upper bound or initial solution for exact synthesis.
+
+  \param bits Truth table of the function
+  \param care Truth table of the care set
 */
 template<typename TT>
-inline esop_t esop_from_optimum_pkrm( const TT& tt )
+inline esop_t esop_from_pkrm( const TT& bits, const TT& care )
 {
-  std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
-  detail::expansion_cache<TT> cache;
+  assert( bits.num_vars() == care.num_vars() );
+
+  kitty::dynamic_truth_table on( bits.num_vars() ), dc( care.num_vars() );
+  std::copy( bits.cbegin(), bits.cend(), on.begin() );
+  std::copy( care.cbegin(), care.cend(), dc.begin() );
 
-  detail::find_pkrm_expansions( tt, cache, 0 );
-  detail::optimum_pkrm_rec( cubes, tt, cache, 0, kitty::cube() );
+  cube_set cubes( bits.num_vars() );
+  detail::isf_pkrm_cache cache;
+  detail::isf_pkrm_rec( cubes, on, dc, cache, 0, kitty::cube() );
 
-  return esop_t( cubes.begin(), cubes.end() );
+  return cubes.esop();
 }
 
 } /* namespace easy::esop */
@@ -35,9 +35,19 @@
 
 #include <easy/esop/esop.hpp>
 #include <easy/esop/cube_manipulators.hpp>
+#include <easy/esop/cube_set.hpp>
 #include <kitty/cube.hpp>
+#include <kitty/static_truth_table.hpp>
 
-#include <unordered_set>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define EASY_X86_SIMD 1
+#include <immintrin.h>
+#endif
 
 namespace easy
 {
@@ -49,45 +59,224 @@ namespace esop
 namespace detail
 {
 
-template<typename TT>
-inline void esop_from_pprm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& cubes, const TT& tt, uint8_t var_index, const kitty::cube& c )
+/* projections of the variables 0, ..., 5 onto their negative cofactor */
+static constexpr uint64_t reed_muller_masks[] = {
+    0x5555555555555555, 0x3333333333333333, 0x0f0f0f0f0f0f0f0f,
+    0x00ff00ff00ff00ff, 0x0000ffff0000ffff, 0x00000000ffffffff};
+
+/* Reed-Muller transform of the first min( num_vars, 6 ) variables within a word */
+inline uint64_t reed_muller_word( uint64_t word, uint32_t num_vars )
 {
-  /* terminal cases */
-  if ( is_const0( tt ) )
+  for ( auto i = 0u; i < num_vars && i < 6u; ++i )
   {
-    return;
+    word ^= ( word & reed_muller_masks[i] ) << ( 1u << i );
+  }
+  return word;
+}
+
+inline void xor_words_scalar( uint64_t* dst, uint64_t const* src, std::size_t num_words )
+{
+  for ( auto k = 0u; k < num_words; ++k )
+  {
+    dst[k] ^= src[k];
+  }
+}
+
+#if defined( EASY_X86_SIMD )
+__attribute__( ( target( "avx2" ) ) )
+inline void xor_words_avx2( uint64_t* dst, uint64_t const* src, std::size_t num_words )
+{
+  auto k = 0u;
+  for ( ; k + 4u <= num_words; k += 4u )
+  {
+    auto const a = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( dst + k ) );
+    auto const b = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( src + k ) );
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( dst + k ), _mm256_xor_si256( a, b ) );
+  }
+  xor_words_scalar( dst + k, src + k, num_words - k );
+}
+#endif
+
+using xor_words_fn = void ( * )( uint64_t*, uint64_t const*, std::size_t );
+
+/* XOR of word ranges, vectorized if supported by the machine */
+inline xor_words_fn xor_words_function()
+{
+#if defined( EASY_X86_SIMD )
+  if ( __builtin_cpu_supports( "avx2" ) )
+  {
+    return &xor_words_avx2;
   }
-  if ( is_const0( ~tt ) )
+#endif
+  return &xor_words_scalar;
+}
+
+/* in-place Reed-Muller transform of variable i, which maps the positive
+   cofactor f1 to f0 ^ f1 */
+inline void reed_muller_variable( uint64_t* words, std::size_t num_words, uint32_t var_index, xor_words_fn xor_words )
+{
+  if ( var_index < 6u )
   {
-    /* add to cubes, but do not apply distance-1 merging */
-    add_to_cubes( cubes, c, false );
+    auto const shift = 1u << var_index;
+    auto const mask = reed_muller_masks[var_index];
+    for ( auto k = 0u; k < num_words; ++k )
+    {
+      words[k] ^= ( words[k] & mask ) << shift;
+    }
     return;
   }
 
-  const auto tt0 = cofactor0( tt, var_index );
-  const auto tt1 = cofactor1( tt, var_index );
+  auto const step = std::size_t( 1 ) << ( var_index - 6u );
+  for ( auto j = 0u; j < num_words; j += 2u * step )
+  {
+    if ( step < 4u )
+    {
+      xor_words_scalar( words + j + step, words + j, step );
+    }
+    else
+    {
+      xor_words( words + j + step, words + j, step );
+    }
+  }
+}
+
+/* in-place Reed-Muller transform of a truth table given as words
+ *
+ * The first six variables are transformed within each word using
+ * shifts and masks, the other variables by XORing the lower half of
+ * each block of 2^(i-6) words into the upper half. */
+inline void reed_muller_transform( uint64_t* words, std::size_t num_words, uint32_t num_vars )
+{
+  for ( auto k = 0u; k < num_words; ++k )
+  {
+    words[k] = reed_muller_word( words[k], num_vars );
+  }
 
-  esop_from_pprm_rec( cubes, tt0, var_index + 1, c );
-  esop_from_pprm_rec( cubes, tt0 ^ tt1, var_index + 1, with_literal( c, var_index, true ) );
+  auto const xor_words = xor_words_function();
+  for ( auto i = 6u; i < num_vars; ++i )
+  {
+    reed_muller_variable( words, num_words, i, xor_words );
+  }
 }
 
 } // namespace detail
 /*! \endcond */
 
+/*! \brief Computes the positive-polarity Reed-Muller spectrum of a function
+
+  Bit m of the result is set if and only if the product of the
+  variables in m is a cube of the PPRM representation.  The spectrum is
+  computed in place on a copy of the truth table with O(n 2^n) bit
+  operations.  The transform is self-inverse.
+
+  \param tt Truth table
+*/
+template<typename TT>
+inline TT pprm_spectrum( const TT& tt )
+{
+  auto spectrum = tt;
+  detail::reed_muller_transform( &*spectrum.begin(), std::distance( spectrum.begin(), spectrum.end() ), spectrum.num_vars() );
+  return spectrum;
+}
+
+/*! \cond PRIVATE */
+template<uint32_t NumVars>
+inline kitty::static_truth_table<NumVars, true> pprm_spectrum( const kitty::static_truth_table<NumVars, true>& tt )
+{
+  auto spectrum = tt;
+  spectrum._bits = detail::reed_muller_word( tt._bits, NumVars );
+  return spectrum;
+}
+/*! \endcond */
+
 /*! \brief Computes PPRM representation for a function
 
-  This algorithm applies recursively the positive Davio decomposition which
-  eventually leads into the PPRM representation of a function.
+  Reads the cubes off the positive-polarity Reed-Muller spectrum (see
+  pprm_spectrum); the cubes are ordered by their literals as binary
+  numbers.
 
   \param tt Truth table
 */
 template<typename TT>
 inline esop_t esop_from_pprm( const TT& tt )
 {
-  std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
-  detail::esop_from_pprm_rec( cubes, tt, 0, kitty::cube() );
+  assert( tt.num_vars() <= 32u );
 
-  return esop_t( cubes.begin(), cubes.end() );
+  const auto spectrum = pprm_spectrum( tt );
+
+  esop_t esop;
+  uint64_t offset = 0u;
+  for ( auto it = spectrum.begin(); it != spectrum.end(); ++it, offset += 64u )
+  {
+    auto word = *it;
+    while ( word )
+    {
+      auto const m = uint32_t( offset + __builtin_ctzll( word ) );
+      esop.emplace_back( m, m );
+      word &= word - 1u;
+    }
+  }
+  return esop;
+}
+
+/*! \brief Computes fixed-polarity Reed-Muller form from an ESOP form
+
+  Each complemented (uncomplemented) literal of a variable with
+  positive (negative) polarity is expanded with x' = 1 ^ x, such that a
+  cube with k such literals yields 2^k cubes; equal cubes cancel.  The
+  ESOP form is given as cubes only, so it can be used for functions
+  with more than 32 variables (see wide_cube).
+
+  \param esop ESOP form
+  \param num_vars Number of variables
+  \param negated Variables with negative polarity (empty for PPRM)
+*/
+template<typename Cube>
+inline basic_esop_t<Cube> fprm_from_esop( basic_esop_t<Cube> const& esop, uint32_t num_vars, std::vector<bool> const& negated = {} )
+{
+  assert( negated.empty() || negated.size() == num_vars );
+
+  basic_cube_set<Cube> cubes( num_vars, false );
+  std::vector<uint32_t> expand;
+  for ( const auto& c : esop )
+  {
+    expand.clear();
+    for ( auto v = 0u; v < num_vars; ++v )
+    {
+      if ( c.get_mask( v ) && c.get_bit( v ) == ( !negated.empty() && negated[v] ) )
+      {
+        expand.push_back( v );
+      }
+    }
+    assert( expand.size() < 64u );
+
+    /* subset s of the expanded literals is flipped, the others are removed */
+    for ( uint64_t s = 0u; s < ( uint64_t( 1 ) << expand.size() ); ++s )
+    {
+      auto product = c;
+      for ( auto k = 0u; k < expand.size(); ++k )
+      {
+        if ( ( s >> k ) & 1 )
+        {
+          product.add_literal( expand[k], !product.get_bit( expand[k] ) );
+        }
+        else
+        {
+          product.remove_literal( expand[k] );
+        }
+      }
+      cubes.add( product );
+    }
+  }
+
+  return cubes.esop();
+}
+
+/*! \brief Computes PPRM representation from an ESOP form (see fprm_from_esop) */
+template<typename Cube>
+inline basic_esop_t<Cube> pprm_from_esop( basic_esop_t<Cube> const& esop, uint32_t num_vars )
+{
+  return fprm_from_esop( esop, num_vars );
 }
 
 } // namespace esop
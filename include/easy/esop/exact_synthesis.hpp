@@ -28,6 +28,7 @@
 #include <easy/esop/esop.hpp>
 #include <easy/esop/cube_utils.hpp>
 #include <easy/sat/sat_solver.hpp>
+#include <easy/sat/cnf_symmetry_breaking.hpp>
 #include <easy/sat/gauss.hpp>
 #include <easy/sat/xor_clauses_to_cnf.hpp>
 #include <easy/sat/cnf_writer.hpp>
@@ -47,6 +48,7 @@ inline esops_t exact_synthesis_from_binary_string( const std::string& bits, cons
   const auto max_number_of_cubes = ( config.count( "maximum_cubes" ) > 0u ? unsigned( config["maximum_cubes"] ) : 10 );
   const auto dump = ( config.count( "dump_cnf" ) > 0u ? bool( config["dump_cnf"] ) : false );
   const auto one_esop = ( config.count( "one_esop" ) > 0u ? bool( config["one_esop"] ) : true );
+  const auto symmetry_breaking = ( config.count( "symmetry_breaking" ) > 0u ? bool( config["symmetry_breaking"] ) : false );
 
   const uint32_t num_vars = log2( bits.size() );
   assert( bits.size() == ( 1ull << num_vars ) && "bit-width of bits is not a power of 2" );
@@ -139,6 +141,10 @@ inline esops_t exact_synthesis_from_binary_string( const std::string& bits, cons
 
     sat::gauss_elimination().apply( constraints );
     sat::xor_clauses_to_cnf( sid ).apply( constraints );
+    if ( symmetry_breaking )
+    {
+      sat::cnf_symmetry_breaking( sid, num_vars, k ).apply( constraints );
+    }
 
     if ( dump )
     {
@@ -212,6 +218,26 @@ inline esops_t exact_synthesis_from_binary_string( const std::string& bits, cons
       std::sort( esop.begin(), esop.end(), cube_weight_compare( num_vars ) );
       esops.push_back( esop );
 
+      /* terms are ordered, a single blocking clause suffices */
+      if ( symmetry_breaking )
+      {
+        std::vector<int> blocking_clause;
+        for ( auto j = 0u; j < k; ++j )
+        {
+          for ( auto l = 0u; l < num_vars; ++l )
+          {
+            const auto p_value = result.model[j * num_vars + l] == Glucose::l_True;
+            const auto q_value = result.model[num_vars * k + j * num_vars + l] == Glucose::l_True;
+
+            blocking_clause.push_back( p_value ? -( 1 + j * num_vars + l ) : ( 1 + j * num_vars + l ) );
+            blocking_clause.push_back( q_value ? -( 1 + num_vars * k + j * num_vars + l ) : ( 1 + num_vars * k + j * num_vars + l ) );
+          }
+        }
+
+        constraints.add_clause( blocking_clause );
+        continue;
+      }
+
       /* add one blocking clause for each possible permutation of the cubes */
       do
       {
@@ -257,6 +283,7 @@ esops_t exact_esop( TT const& bits )
 
   nlohmann::json config;
   config["one_esop"] = false;
+  config["symmetry_breaking"] = true;
   return detail::exact_synthesis_from_binary_string( bs, cs, config );
 }
 
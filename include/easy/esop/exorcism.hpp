@@ -0,0 +1,328 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file exorcism.hpp
+  \brief Heuristic ESOP minimization with EXORLINK transformations
+
+  \author Heinz Riener
+*/
+
+#pragma once
+
+#include <easy/esop/cube_set.hpp>
+#include <easy/esop/esop.hpp>
+#include <easy/esop/exorlink.hpp>
+#include <easy/utils/stopwatch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace easy::esop
+{
+
+struct exorcism_params
+{
+  uint32_t max_distance = 4u; /*>! Largest distance of cube pairs to reshape (2, 3, or 4) */
+  uint32_t max_idle_passes = 2u; /*>! Stop a run after this many passes without a reduction */
+  uint32_t num_restarts = 4u; /*>! Number of additional runs from the best ESOP in randomized order */
+  uint64_t max_iterations = 0u; /*>! Maximum number of reshaped cube pairs (0 denotes no limit) */
+  double time_limit = 0.0; /*>! Time limit in seconds (0 denotes no limit) */
+  uint64_t seed = 0xcafeaffe; /*>! Seed of the randomized restarts */
+};
+
+struct exorcism_statistics
+{
+  uint32_t initial_cubes{0}; /*>! Number of cubes of the input ESOP */
+  uint32_t cubes{0}; /*>! Number of cubes of the minimized ESOP */
+  uint32_t passes{0}; /*>! Number of passes over the cube pairs */
+  uint32_t restarts{0}; /*>! Number of randomized restarts */
+  uint64_t pairs{0}; /*>! Number of reshaped cube pairs */
+  uint64_t rewrites{0}; /*>! Number of accepted EXORLINK transformations */
+  utils::stopwatch<>::duration time{0}; /*>! Time spent in minimize */
+};
+
+/*! \brief EXORCISM-style heuristic ESOP minimizer
+ *
+ * Iteratively reshapes pairs of cubes with EXORLINK transformations
+ * [N. Song and M. Perkowski, IEEE Trans. CAD 15(4), 1996, 385-395].
+ * Each pass visits the cube pairs in order of increasing distance;
+ * the pairs of one distance are enumerated per cube on the fly, such
+ * that a pass needs no memory beyond a snapshot of the cubes.  A
+ * distance-d pair is replaced by
+ * the d cubes of one of its EXORLINK transformations; the new cubes
+ * are inserted one by one, cancelling equal cubes and merging
+ * distance-1 cubes.  A transformation is accepted if the number of
+ * cubes does not grow and undone otherwise, such that sideways moves
+ * reshape the ESOP for later reductions.
+ *
+ * A run ends after `max_idle_passes` passes without a reduction.
+ * Each restart continues from the smallest ESOP found so far with the
+ * cubes and transformations visited in randomized order.  The
+ * iteration and time budget bound all runs together.
+ */
+class exorcism_minimizer
+{
+public:
+  explicit exorcism_minimizer( exorcism_statistics& stats, exorcism_params const& ps )
+    : _stats( stats )
+    , _ps( ps )
+    , _rng( ps.seed )
+  {
+    assert( _ps.max_distance >= 2u && _ps.max_distance <= 4u );
+  }
+
+  /*! \brief Minimizes an ESOP form
+   *
+   * \param esop ESOP form
+   * \return A functionally equivalent ESOP form with at most as many cubes
+   */
+  esop_t minimize( esop_t const& esop )
+  {
+    utils::stopwatch t( _stats.time );
+    _start = std::chrono::steady_clock::now();
+
+    _stats.initial_cubes = esop.size();
+
+    uint32_t support = 0u;
+    for ( const auto& c : esop )
+    {
+      support |= c._mask;
+    }
+    _cubes = cube_set( support == 0u ? 0u : 32u - __builtin_clz( support ) );
+
+    esop_t best = esop;
+    for ( auto r = 0u; r <= _ps.num_restarts && !budget_exhausted(); ++r )
+    {
+      auto cubes = best;
+      if ( r > 0u )
+      {
+        std::shuffle( cubes.begin(), cubes.end(), _rng );
+        ++_stats.restarts;
+      }
+
+      run( cubes, r > 0u );
+
+      if ( _cubes.size() < best.size() )
+      {
+        best = _cubes.esop();
+      }
+    }
+
+    _stats.cubes = best.size();
+    return best;
+  }
+
+private:
+  void run( esop_t const& cubes, bool randomize )
+  {
+    _cubes.clear();
+    for ( const auto& c : cubes )
+    {
+      add_cube( c );
+    }
+    _log.clear();
+
+    auto idle_passes = 0u;
+    while ( idle_passes < _ps.max_idle_passes && !budget_exhausted() )
+    {
+      ++_stats.passes;
+      auto const size_before = _cubes.size();
+
+      std::vector<kitty::cube> snapshot( _cubes.begin(), _cubes.end() );
+      if ( randomize )
+      {
+        std::shuffle( snapshot.begin(), snapshot.end(), _rng );
+      }
+
+      for ( auto d = 2u; d <= _ps.max_distance; ++d )
+      {
+        for ( auto i = 0u; i < snapshot.size(); ++i )
+        {
+          /* cubes that have already been reshaped are skipped */
+          for ( auto j = i + 1u; j < snapshot.size() && _cubes.contains( snapshot[i] ); ++j )
+          {
+            if ( uint32_t( snapshot[i].distance( snapshot[j] ) ) != d || !_cubes.contains( snapshot[j] ) )
+            {
+              continue;
+            }
+
+            if ( budget_exhausted() )
+            {
+              return;
+            }
+
+            ++_stats.pairs;
+            reshape( snapshot[i], snapshot[j], d, randomize );
+          }
+        }
+      }
+
+      idle_passes = _cubes.size() < size_before ? 0u : idle_passes + 1u;
+    }
+  }
+
+  /* tries the EXORLINK transformations of a pair until one is accepted */
+  bool reshape( kitty::cube const& c0, kitty::cube const& c1, uint32_t distance, bool randomize )
+  {
+    switch ( distance )
+    {
+    case 2u:
+      return reshape<2u>( c0, c1, randomize );
+    case 3u:
+      return reshape<3u>( c0, c1, randomize );
+    case 4u:
+      return reshape<4u>( c0, c1, randomize );
+    default:
+      assert( false && "only distances 2, 3, and 4 are reshaped" );
+      return false;
+    }
+  }
+
+  template<uint32_t Distance>
+  bool reshape( kitty::cube const& c0, kitty::cube const& c1, bool randomize )
+  {
+    std::array<std::array<kitty::cube, Distance>, exorlink_num_groups<Distance>> transformations;
+    exorlink_all<Distance>( c0, c1, transformations );
+
+    auto const first = randomize ? uint32_t( _rng() % transformations.size() ) : 0u;
+    for ( auto g = 0u; g < transformations.size(); ++g )
+    {
+      auto const size_before = _cubes.size();
+
+      _log.clear();
+      erase_cube( c0 );
+      erase_cube( c1 );
+      for ( const auto& c : transformations[( first + g ) % transformations.size()] )
+      {
+        add_cube( c );
+      }
+
+      if ( _cubes.size() <= size_before )
+      {
+        ++_stats.rewrites;
+        return true;
+      }
+      undo();
+    }
+    return false;
+  }
+
+  /* adds a cube with cancellation and distance-1 merging, see cube_set::add */
+  void add_cube( kitty::cube c )
+  {
+    while ( true )
+    {
+      if ( _cubes.contains( c ) )
+      {
+        erase_cube( c );
+        return;
+      }
+
+      auto const other = _cubes.find_distance_one( c );
+      if ( !other )
+      {
+        break;
+      }
+
+      erase_cube( *other );
+      c = c.merge( *other );
+    }
+
+    _cubes.insert( c );
+    _log.emplace_back( true, c );
+  }
+
+  void erase_cube( kitty::cube const& c )
+  {
+    _cubes.erase( c );
+    _log.emplace_back( false, c );
+  }
+
+  /* reverts the changes since the last transformation */
+  void undo()
+  {
+    for ( auto it = _log.rbegin(); it != _log.rend(); ++it )
+    {
+      if ( it->first )
+      {
+        _cubes.erase( it->second );
+      }
+      else
+      {
+        _cubes.insert( it->second );
+      }
+    }
+    _log.clear();
+  }
+
+  bool budget_exhausted() const
+  {
+    if ( _ps.max_iterations != 0u && _stats.pairs >= _ps.max_iterations )
+    {
+      return true;
+    }
+    if ( _ps.time_limit > 0.0 )
+    {
+      std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - _start;
+      return elapsed.count() >= _ps.time_limit;
+    }
+    return false;
+  }
+
+private:
+  exorcism_statistics& _stats;
+  exorcism_params const& _ps;
+
+  std::mt19937_64 _rng;
+  std::chrono::steady_clock::time_point _start;
+
+  cube_set _cubes;
+  std::vector<std::pair<bool, kitty::cube>> _log; /* (inserted, cube) */
+}; /* exorcism_minimizer */
+
+/*! \brief Minimizes an ESOP form with EXORCISM-style heuristics
+ *
+ * \param esop ESOP form, e.g., from esop_from_pprm or esop_from_optimum_pkrm
+ * \param ps Parameters
+ * \return A functionally equivalent ESOP form with at most as many cubes
+ */
+inline esop_t exorcism( esop_t const& esop, exorcism_params const& ps = {} )
+{
+  exorcism_statistics st;
+  return exorcism_minimizer( st, ps ).minimize( esop );
+}
+
+} /* namespace easy::esop */
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
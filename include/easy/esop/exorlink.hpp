@@ -26,26 +26,292 @@
 #pragma once
 
 #include <easy/esop/esop.hpp>
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <type_traits>
 
 namespace easy::esop
 {
 
-static unsigned cube_groups2[8] = {
-    /* 0 */ 2, 0, 1, 2,
-    /* 4 */ 0, 2, 2, 1};
+/*! \cond PRIVATE */
+namespace detail
+{
+
+constexpr uint32_t factorial( uint32_t n )
+{
+  return n <= 1u ? 1u : n * factorial( n - 1u );
+}
+
+/* positions (by index of the differing literal) that a cube takes from c1 or from neither cube */
+struct exorlink_select
+{
+  uint8_t take_c1 = 0u;
+  uint8_t take_other = 0u;
+};
+
+template<uint32_t Distance>
+constexpr bool next_permutation( std::array<uint32_t, Distance>& perm )
+{
+  int i = int( Distance ) - 2;
+  while ( i >= 0 && perm[i] >= perm[i + 1] )
+  {
+    --i;
+  }
+  if ( i < 0 )
+  {
+    return false;
+  }
+
+  int j = int( Distance ) - 1;
+  while ( perm[j] <= perm[i] )
+  {
+    --j;
+  }
+  auto const tmp = perm[i];
+  perm[i] = perm[j];
+  perm[j] = tmp;
+
+  for ( auto l = i + 1, r = int( Distance ) - 1; l < r; ++l, --r )
+  {
+    auto const t = perm[l];
+    perm[l] = perm[r];
+    perm[r] = t;
+  }
+  return true;
+}
+
+/* One group for each permutation of the differing positions (in
+ * lexicographic order): the i-th cube takes the other literal at
+ * position perm[i], the literals of c1 at the positions perm[0..i-1],
+ * and the literals of c0 at the remaining positions. */
+template<uint32_t Distance>
+constexpr auto make_exorlink_selects()
+{
+  std::array<std::array<exorlink_select, Distance>, factorial( Distance )> selects{};
+
+  std::array<uint32_t, Distance> perm{};
+  for ( auto i = 0u; i < Distance; ++i )
+  {
+    perm[i] = i;
+  }
+
+  auto g = 0u;
+  do
+  {
+    uint8_t take_c1 = 0u;
+    for ( auto i = 0u; i < Distance; ++i )
+    {
+      selects[g][i].take_c1 = take_c1;
+      selects[g][i].take_other = uint8_t( 1u << perm[i] );
+      take_c1 |= uint8_t( 1u << perm[i] );
+    }
+    ++g;
+  } while ( next_permutation<Distance>( perm ) );
+
+  return selects;
+}
+
+/* the selects as digits: 0 (take from c0), 1 (take from c1), 2 (take other) */
+template<uint32_t Distance>
+constexpr auto make_cube_groups()
+{
+  constexpr auto selects = make_exorlink_selects<Distance>();
+
+  std::array<uint32_t, factorial( Distance ) * Distance * Distance> groups{};
+  for ( auto g = 0u; g < selects.size(); ++g )
+  {
+    for ( auto i = 0u; i < Distance; ++i )
+    {
+      for ( auto j = 0u; j < Distance; ++j )
+      {
+        groups[( g * Distance + i ) * Distance + j] = ( ( selects[g][i].take_other >> j ) & 1u ) ? 2u : ( ( selects[g][i].take_c1 >> j ) & 1u );
+      }
+    }
+  }
+  return groups;
+}
+
+} // namespace detail
+/*! \endcond */
+
+/*! \brief Number of EXORLINK transformations of a distance-`Distance` cube pair */
+template<uint32_t Distance>
+inline constexpr uint32_t exorlink_num_groups = detail::factorial( Distance );
+
+/*! \brief EXORLINK transformations of a distance-`Distance` cube pair */
+template<uint32_t Distance>
+inline constexpr auto exorlink_selects = detail::make_exorlink_selects<Distance>();
+
+/*! \brief EXORLINK transformations as digits, `Distance` x `Distance` digits per group */
+inline constexpr auto cube_groups2 = detail::make_cube_groups<2u>();
+inline constexpr auto cube_groups3 = detail::make_cube_groups<3u>();
+inline constexpr auto cube_groups4 = detail::make_cube_groups<4u>();
+inline constexpr auto cube_groups5 = detail::make_cube_groups<5u>();
+inline constexpr auto cube_groups6 = detail::make_cube_groups<6u>();
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* a cube pair prepared for the EXORLINK kernels */
+template<uint32_t Distance>
+struct exorlink_pair
+{
+  exorlink_pair( kitty::cube c0, kitty::cube c1 )
+  {
+    assert( uint32_t( c0.distance( c1 ) ) == Distance );
+    if ( c1 < c0 )
+    {
+      std::swap( c0, c1 );
+    }
 
-static unsigned cube_groups3[54] = {
-    /*  0 */ 2, 0, 0, 1, 2, 0, 1, 1, 2,
-    /*  9 */ 2, 0, 0, 1, 0, 2, 1, 2, 1,
-    /* 18 */ 0, 2, 0, 2, 1, 0, 1, 1, 2,
-    /* 27 */ 0, 2, 0, 0, 1, 2, 2, 1, 1,
-    /* 36 */ 0, 0, 2, 2, 0, 1, 1, 2, 1,
-    /* 45 */ 0, 0, 2, 0, 2, 1, 2, 1, 1};
+    bits0 = c0._bits;
+    mask0 = c0._mask;
+    bits1 = c1._bits;
+    mask1 = c1._mask;
+    bits2 = ~c0._bits & ~c1._bits;
+    mask2 = c0._mask ^ c1._mask;
 
-#include "exorlink4.def"
-#include "exorlink5.def"
-#include "exorlink6.def"
+    uint32_t diff = c0.difference( c1 );
+    for ( auto j = 0u; j < Distance; ++j )
+    {
+      pos[j] = diff & -diff;
+      diff &= diff - 1u;
+    }
+  }
+
+  template<typename CubeArray>
+  void apply( std::array<exorlink_select, Distance> const& selects, CubeArray& result ) const
+  {
+    for ( auto i = 0u; i < Distance; ++i )
+    {
+      uint32_t m1 = 0u, m2 = 0u;
+      for ( auto j = 0u; j < Distance; ++j )
+      {
+        m1 |= -uint32_t( ( selects[i].take_c1 >> j ) & 1u ) & pos[j];
+        m2 |= -uint32_t( ( selects[i].take_other >> j ) & 1u ) & pos[j];
+      }
+      auto const m0 = ~( m1 | m2 );
+      result[i]._bits = ( bits0 & m0 ) | ( bits1 & m1 ) | ( bits2 & m2 );
+      result[i]._mask = ( mask0 & m0 ) | ( mask1 & m1 ) | ( mask2 & m2 );
+    }
+  }
+
+  uint32_t bits0, mask0, bits1, mask1, bits2, mask2;
+  std::array<uint32_t, Distance> pos;
+};
+
+} // namespace detail
+/*! \endcond */
+
+/*! \brief EXORLINK cube transformation
+ *
+ * Transform two cubes with distance `Distance` into a functionally
+ * equivalent set of `Distance` cubes without allocating memory.
+ *
+ * \param c0 First cube
+ * \param c1 Second cube
+ * \param group Index of the transformation (less than ``exorlink_num_groups<Distance>``)
+ * \param result The new cubes which are functionally equivalent to ``c0`` and ``c1``
+ */
+template<uint32_t Distance>
+inline void exorlink( kitty::cube const& c0, kitty::cube const& c1, uint32_t group, std::array<kitty::cube, Distance>& result )
+{
+  assert( group < exorlink_num_groups<Distance> );
+  detail::exorlink_pair<Distance>( c0, c1 ).apply( exorlink_selects<Distance>[group], result );
+}
+
+/*! \brief All EXORLINK cube transformations of a cube pair
+ *
+ * Computes the transformations of all groups in a single pass over
+ * the groups; the differing positions are computed only once.
+ *
+ * \param c0 First cube
+ * \param c1 Second cube
+ * \param results The new cubes of each transformation
+ */
+template<uint32_t Distance>
+inline void exorlink_all( kitty::cube const& c0, kitty::cube const& c1, std::array<std::array<kitty::cube, Distance>, exorlink_num_groups<Distance>>& results )
+{
+  detail::exorlink_pair<Distance> const pair( c0, c1 );
+  for ( auto g = 0u; g < exorlink_num_groups<Distance>; ++g )
+  {
+    pair.apply( exorlink_selects<Distance>[g], results[g] );
+  }
+}
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* generic variant of exorlink_pair for wide cubes */
+template<uint32_t Distance, typename Cube>
+struct wide_exorlink_pair
+{
+  wide_exorlink_pair( Cube const& c0, Cube const& c1 )
+      : c0( c1 < c0 ? c1 : c0 ), c1( c1 < c0 ? c0 : c1 )
+  {
+    assert( uint32_t( c0.distance( c1 ) ) == Distance );
+    auto j = 0u;
+    this->c0.foreach_difference( this->c1, [&]( uint32_t v ) { pos[j++] = v; } );
+  }
+
+  template<typename CubeArray>
+  void apply( std::array<exorlink_select, Distance> const& selects, CubeArray& result ) const
+  {
+    for ( auto i = 0u; i < Distance; ++i )
+    {
+      result[i] = c0;
+      for ( auto j = 0u; j < Distance; ++j )
+      {
+        auto const v = pos[j];
+        if ( ( selects[i].take_c1 >> j ) & 1u )
+        {
+          if ( c1.get_mask( v ) )
+            result[i].add_literal( v, c1.get_bit( v ) );
+          else
+            result[i].remove_literal( v );
+        }
+        else if ( ( selects[i].take_other >> j ) & 1u )
+        {
+          /* the literal that is neither in c0 nor in c1 */
+          if ( c0.get_mask( v ) && c1.get_mask( v ) )
+            result[i].remove_literal( v );
+          else if ( c0.get_mask( v ) )
+            result[i].add_literal( v, !c0.get_bit( v ) );
+          else
+            result[i].add_literal( v, !c1.get_bit( v ) );
+        }
+      }
+    }
+  }
+
+  Cube c0, c1;
+  std::array<uint32_t, Distance> pos;
+};
+
+} // namespace detail
+/*! \endcond */
+
+/*! \brief EXORLINK cube transformation for wide cubes (see exorlink for kitty::cube) */
+template<uint32_t Distance, typename Cube, typename = std::enable_if_t<!std::is_same_v<Cube, kitty::cube>>>
+inline void exorlink( Cube const& c0, Cube const& c1, uint32_t group, std::array<Cube, Distance>& result )
+{
+  assert( group < exorlink_num_groups<Distance> );
+  detail::wide_exorlink_pair<Distance, Cube>( c0, c1 ).apply( exorlink_selects<Distance>[group], result );
+}
+
+/*! \brief All EXORLINK cube transformations for wide cubes (see exorlink_all for kitty::cube) */
+template<uint32_t Distance, typename Cube, typename = std::enable_if_t<!std::is_same_v<Cube, kitty::cube>>>
+inline void exorlink_all( Cube const& c0, Cube const& c1, std::array<std::array<Cube, Distance>, exorlink_num_groups<Distance>>& results )
+{
+  detail::wide_exorlink_pair<Distance, Cube> const pair( c0, c1 );
+  for ( auto g = 0u; g < exorlink_num_groups<Distance>; ++g )
+  {
+    pair.apply( exorlink_selects<Distance>[g], results[g] );
+  }
+}
 
 /*! \brief EXORLINK cube transformation
  *
@@ -53,11 +319,11 @@ static unsigned cube_groups3[54] = {
  *
  * \param c0 First cube
  * \param c1 Second cube
- * \param distance Distance of ``c0`` and ``c1``. Must be less than 4.
- * \param group A group of cube transformations
- * \return An array of up to 5 new cubes which are functionally equivalent to ``c0`` and ``c1``.
+ * \param distance Distance of ``c0`` and ``c1``
+ * \param group A group of cube transformations, e.g., ``&cube_groups4[16]``
+ * \return An array of ``distance`` new cubes which are functionally equivalent to ``c0`` and ``c1``.
  */
-std::vector<kitty::cube> exorlink( kitty::cube c0, kitty::cube c1, std::uint32_t distance, std::uint32_t* group )
+inline std::vector<kitty::cube> exorlink( kitty::cube c0, kitty::cube c1, std::uint32_t distance, std::uint32_t const* group )
 {
   const auto diff = c0.difference( c1 );
 
@@ -112,86 +378,12 @@ std::vector<kitty::cube> exorlink( kitty::cube c0, kitty::cube c1, std::uint32_t
  * \param offset An offset that determines the transformation (must be a value in the series 0, 16, 32, ..., 368)
  * \return An array of 4 new cubes which are functionally equivalent to ``c0`` and ``c1``.
  */
-std::array<kitty::cube, 4> exorlink4( const kitty::cube& c0, const kitty::cube& c1, uint32_t offset )
+inline std::array<kitty::cube, 4> exorlink4( const kitty::cube& c0, const kitty::cube& c1, uint32_t offset )
 {
-  std::uint32_t* group = &cube_groups4[offset];
-  const auto diff = c0.difference( c1 );
+  assert( offset % 16u == 0u );
 
   std::array<kitty::cube, 4> result;
-  const auto bits = ~( c0._bits ) & ~( c1._bits );
-  const auto mask = c0._mask ^ c1._mask;
-
-  if ( c0 < c1 )
-  {
-    for ( auto i = 0; i < 4; ++i )
-    {
-      auto tmp_bits = c0._bits;
-      auto tmp_mask = c0._mask;
-      auto tmp_pos = diff;
-
-      for ( auto j = 0; j < 4; ++j )
-      {
-        /* compute next position */
-        std::uint64_t p = tmp_pos & -tmp_pos;
-        tmp_pos &= tmp_pos - 1;
-        switch ( *group++ )
-        {
-        case 0:
-          /* take from c0 */
-          break;
-        case 1:
-        {
-          /* take from c1 */
-          tmp_bits ^= ( ( c1._bits & p ) ^ tmp_bits ) & p;
-          tmp_mask ^= ( ( c1._mask & p ) ^ tmp_mask ) & p;
-        }
-        break;
-        case 2:
-          /* take other */
-          tmp_bits ^= ( ( bits & p ) ^ tmp_bits ) & p;
-          tmp_mask ^= ( ( mask & p ) ^ tmp_mask ) & p;
-          break;
-        }
-      }
-      result[i]._bits = tmp_bits;
-      result[i]._mask = tmp_mask;
-    }
-  }
-  else
-  {
-    for ( auto i = 0; i < 4; ++i )
-    {
-      auto tmp_bits = c1._bits;
-      auto tmp_mask = c1._mask;
-      auto tmp_pos = diff;
-
-      for ( auto j = 0; j < 4; ++j )
-      {
-        /* compute next position */
-        std::uint64_t p = tmp_pos & -tmp_pos;
-        tmp_pos &= tmp_pos - 1;
-        switch ( *group++ )
-        {
-        case 0:
-          /* take from c0 */
-          break;
-        case 1:
-          /* take from c1 */
-          tmp_bits ^= ( ( c0._bits & p ) ^ tmp_bits ) & p;
-          tmp_mask ^= ( ( c0._mask & p ) ^ tmp_mask ) & p;
-          break;
-        case 2:
-          /* take other */
-          tmp_bits ^= ( ( bits & p ) ^ tmp_bits ) & p;
-          tmp_mask ^= ( ( mask & p ) ^ tmp_mask ) & p;
-          break;
-        }
-      }
-      result[i]._bits = tmp_bits;
-      result[i]._mask = tmp_mask;
-    }
-  }
-
+  exorlink<4u>( c0, c1, offset / 16u, result );
   return result;
 }
 
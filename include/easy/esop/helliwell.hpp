@@ -25,12 +25,24 @@
 
 #pragma once
 
+#include <easy/esop/cube_utils.hpp>
+#include <easy/esop/esop_from_pkrm.hpp>
 #include <easy/sat2/maxsat.hpp>
 #include <easy/sat2/cnf_from_xcnf.hpp>
 #include <easy/utils/dynamic_bitset.hpp>
+#include <easy/utils/gf2_min_weight.hpp>
 
+#include <algorithm>
+#include <istream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <cstdlib>
 
 namespace easy::esop
@@ -39,49 +51,35 @@ namespace easy::esop
 namespace detail
 {
 
-inline int32_t get_lowest_set_bit( int32_t num )
+/*! \brief k-th flip of the Gray code (k = 1, ..., 2^n - 1)
+ *
+ * The k-th flip is the position of the lowest set bit of k.  The
+ * sequence is a palindrome and its prefixes are the sequences for
+ * smaller n, hence it can be shared by all calls.
+ */
+inline uint32_t flip_at( uint32_t k )
 {
-#if WIN32
-  uint32_t mask = 1;
-  for ( int32_t counter = 1; counter <= 32; counter++, mask <<= 1 )
+  assert( k > 0u );
+#if defined( _MSC_VER )
+  uint32_t position = 0u;
+  while ( ( k & 1u ) == 0u )
   {
-    if ( num & mask )
-    {
-      return counter;
-    }
+    k >>= 1u;
+    ++position;
   }
-  return 0;
+  return position;
 #else
-  return ffs( num );
+  return __builtin_ctz( k );
 #endif
 }
 
-std::vector<uint32_t> compute_flips( uint32_t n )
-{
-  auto const size = ( 1u << n );
-  auto const total_flips = size - 1;
-  std::vector<uint32_t> flip_vec( total_flips );
-
-  auto gray_number = 0u;
-  auto temp = 0u;
-  for ( auto i = 1u; i <= total_flips; ++i )
-  {
-    gray_number = i ^ ( i >> 1 );
-    flip_vec[total_flips-i] = get_lowest_set_bit( temp ^ gray_number ) - 1u;
-    temp = gray_number;
-  }
-
-  return flip_vec;
-}
-
-std::vector<kitty::cube> compute_implicants( const kitty::cube& c, uint32_t num_vars )
+inline std::vector<kitty::cube> compute_implicants( const kitty::cube& c, uint32_t num_vars )
 {
-  const auto flips = compute_flips( num_vars );
-
-  std::vector<kitty::cube> impls = { c };
+  std::vector<kitty::cube> impls( 1u << num_vars, c );
   auto copy = c;
-  for ( const auto& flip : flips )
+  for ( auto k = 1u; k < impls.size(); ++k )
   {
+    auto const flip = flip_at( k );
     if ( copy.get_mask( flip ) )
     {
       copy.clear_bit( flip );
@@ -94,112 +92,167 @@ std::vector<kitty::cube> compute_implicants( const kitty::cube& c, uint32_t num_
       {
         copy.set_bit( flip );
       }
-      else
-      {
-        copy.clear_bit( flip );
-      }
     }
-
-    impls.emplace_back( copy );
+    impls[k] = copy;
   }
 
   return impls;
 }
 
+/*! \brief Decision variables g of the Helliwell system
+ *
+ * Each cube is identified by its ternary index (digit 0 for a
+ * negative literal, 1 for a positive literal, and 2 for a missing
+ * literal, see cube_weight), which directly indexes a flat array of
+ * variables.  Variables are created on first use.
+ */
 struct helliwell_decision_variables
 {
 public:
-  explicit helliwell_decision_variables( int& sid )
+  using value_type = std::pair<int, kitty::cube>;
+
+public:
+  explicit helliwell_decision_variables( int& sid, uint32_t num_vars )
     : _sid( sid )
+    , _num_vars( num_vars )
+    , _var_of_index( pow3[num_vars], 0 )
   {}
 
   int lookup_g( const kitty::cube& c ) const
   {
-    return cube_to_g.at( c );
+    auto const v = _var_of_index[cube_weight( c, _num_vars )];
+    assert( v != 0 );
+    return v;
   }
 
   const kitty::cube& lookup_cube( int v ) const
   {
-    return g_to_cube.at( v );
+    auto const it = std::lower_bound( _vars.begin(), _vars.end(), v, []( value_type const& a, int v ){ return a.first < v; } );
+    assert( it != _vars.end() && it->first == v );
+    return it->second;
   }
 
   int operator[]( const kitty::cube& c )
   {
-    return get_or_create_variable( c );
+    return variable_at( cube_weight( c, _num_vars ) );
   }
 
-  std::map<int, kitty::cube>::const_iterator begin() const
+  /*! \brief Returns (or creates) the variable of the cube with ternary index */
+  int variable_at( uint64_t index )
   {
-    return g_to_cube.begin();
+    auto& v = _var_of_index[index];
+    if ( v == 0 )
+    {
+      v = _sid++;
+      _vars.emplace_back( v, cube_at( index ) );
+    }
+    return v;
   }
 
-  std::map<int, kitty::cube>::const_iterator end() const
+  std::vector<value_type>::const_iterator begin() const
   {
-    return g_to_cube.end();
+    return _vars.begin();
+  }
+
+  std::vector<value_type>::const_iterator end() const
+  {
+    return _vars.end();
   }
 
   uint64_t size() const
   {
-    return g_to_cube.size() + 1;
+    return _vars.size() + 1;
   }
 
 protected:
-  int get_or_create_variable( const kitty::cube& c )
+  kitty::cube cube_at( uint64_t index ) const
   {
-    auto it = cube_to_g.find( c );
-    if ( it == cube_to_g.end() )
-    {
-      int variable = _sid++;
-      cube_to_g.emplace( c, variable );
-      g_to_cube.emplace( variable, c );
-      return variable;
-    }
-    else
+    kitty::cube c;
+    for ( auto i = 0u; i < _num_vars; ++i, index /= 3 )
     {
-      return it->second;
+      switch ( index % 3 )
+      {
+      case 1:
+        c.set_bit( i );
+        [[fallthrough]];
+      case 0:
+        c.set_mask( i );
+        break;
+      default:
+        break;
+      }
     }
+    return c;
   }
 
 protected:
   int& _sid;
+  uint32_t _num_vars;
 
-  std::unordered_map<kitty::cube, int, kitty::hash<kitty::cube>> cube_to_g;
-  std::map<int, kitty::cube> g_to_cube;
+  /* variable of each cube (0 if not created yet) */
+  std::vector<int> _var_of_index;
+
+  /* variables and cubes in order of creation */
+  std::vector<value_type> _vars;
 }; /* helliwell_decision_variables */
 
+/*! \brief Appends the implicant variables of a minterm to clause
+ *
+ * Enumerates the implicants in Gray code order and updates their
+ * ternary index incrementally.
+ */
+inline void add_implicant_variables( std::vector<int>& clause, helliwell_decision_variables& g, uint32_t minterm, uint32_t num_vars )
+{
+  uint64_t index = 0u;
+  for ( auto i = 0u; i < num_vars; ++i )
+  {
+    if ( ( minterm >> i ) & 1 )
+    {
+      index += pow3[i];
+    }
+  }
+
+  clause.push_back( g.variable_at( index ) );
+
+  uint32_t dont_cares = 0u;
+  for ( auto k = 1u; k < ( 1u << num_vars ); ++k )
+  {
+    auto const flip = flip_at( k );
+    auto const delta = ( 2u - ( ( minterm >> flip ) & 1 ) ) * pow3[flip];
+    index = ( ( dont_cares >> flip ) & 1 ) ? index - delta : index + delta;
+    dont_cares ^= 1u << flip;
+    clause.push_back( g.variable_at( index ) );
+  }
+}
+
 template<typename TT>
 void derive_xor_clauses( std::vector<std::vector<int>>& xor_clauses, helliwell_decision_variables& g, TT const& bits, TT const& care )
 {
   assert( bits.num_vars() == care.num_vars() );
 
-  kitty::cube minterm;
-  for ( auto i = 0; i < bits.num_vars(); ++i )
-    minterm.set_mask( i );
-
-  do
+  uint32_t const num_vars = bits.num_vars();
+  for ( auto minterm = 0u; minterm < ( 1u << num_vars ); ++minterm )
   {
-    if ( kitty::get_bit( care, minterm._bits ) )
+    if ( !kitty::get_bit( care, minterm ) )
     {
-      std::vector<int> clause;
-      for ( const auto& impl : compute_implicants( minterm, bits.num_vars() ) )
-      {
-        clause.push_back( g[ impl ] );
-      }
+      continue;
+    }
 
-      /* flip the first bit of the xor-clause if the minterm is positive */
-      if ( !kitty::get_bit( bits, minterm._bits ) )
-      {
-        clause[0u] *= -1;
-      }
+    std::vector<int> clause;
+    clause.reserve( 1u << num_vars );
+    add_implicant_variables( clause, g, minterm, num_vars );
 
-      xor_clauses.emplace_back( clause );
+    /* flip the first bit of the xor-clause if the minterm is positive */
+    if ( !kitty::get_bit( bits, minterm ) )
+    {
+      clause[0u] *= -1;
     }
 
-    ++minterm._bits;
-  } while ( minterm._bits < ( 1u << bits.num_vars() ) );
+    xor_clauses.emplace_back( std::move( clause ) );
+  }
 }
 
-esop_t esop_from_model( sat2::model const& m, helliwell_decision_variables const& g )
+inline esop_t esop_from_model( sat2::model const& m, helliwell_decision_variables const& g )
 {
   esop_t esop;
   for ( const auto& v : g )
@@ -212,7 +265,7 @@ esop_t esop_from_model( sat2::model const& m, helliwell_decision_variables const
   return esop;
 }
 
-esop_t esop_from_clause_selectors( std::vector<int> const& sels, helliwell_decision_variables const& g, std::unordered_map<int,int> soft_clause_map )
+inline esop_t esop_from_clause_selectors( std::vector<int> const& sels, helliwell_decision_variables const& g, std::unordered_map<int,int> soft_clause_map )
 {
   esop_t esop;
   for ( const auto& s : sels )
@@ -222,21 +275,296 @@ esop_t esop_from_clause_selectors( std::vector<int> const& sels, helliwell_decis
   return esop;
 }
 
-std::vector<std::vector<int>> translate_to_cnf( int& sid, std::vector<std::vector<int>> const& xcnf, uint32_t num_vars )
+inline std::vector<std::vector<int>> translate_to_cnf( int& sid, std::vector<std::vector<int>> const& xcnf, uint32_t num_vars )
 {
   return sat2::cnf_from_xcnf( sid, xcnf, num_vars ).get();
 }
 
 } /* detail */
 
+/*! \brief Prepared Helliwell system for a fixed number of variables
+ *
+ * The coefficient matrix of the Helliwell system only depends on the
+ * number of variables; the function only determines the right-hand
+ * side.  The template derives and eliminates the system once, with
+ * one parity variable y_m per minterm m in each row:
+ *
+ *   XOR( g_c : c contains m ) XOR y_m = 0
+ *
+ * A function is then selected by assuming y_m = f(m) for each care
+ * minterm m, such that one SAT-solver instance can be used for many
+ * functions.  The decision variables g are 1, ..., 3^n and the parity
+ * variables are 3^n + 1, ..., 3^n + 2^n.
+ */
+class helliwell_template
+{
+public:
+  /*! \brief Derives and eliminates the Helliwell system for num_vars variables */
+  explicit helliwell_template( uint32_t num_vars )
+    : _num_vars( num_vars )
+  {
+    int sid = 1;
+    detail::helliwell_decision_variables g( sid, num_vars );
+
+    std::vector<std::vector<int>> xor_clauses( 1u << num_vars );
+    for ( auto m = 0u; m < xor_clauses.size(); ++m )
+    {
+      detail::add_implicant_variables( xor_clauses[m], g, m, num_vars );
+    }
+
+    _cubes.resize( g.size() - 1u );
+    for ( const auto& v : g )
+    {
+      _cubes[v.first - 1] = v.second;
+    }
+
+    for ( auto m = 0u; m < xor_clauses.size(); ++m )
+    {
+      xor_clauses[m].push_back( -parity_variable( m ) );
+    }
+
+    sid = parity_variable( xor_clauses.size() );
+    sat2::cnf_from_xcnf cnf( sid, xor_clauses, sid );
+    _xor_clauses = cnf.get_reduced_xor_clauses();
+    _clauses = cnf.get();
+    _num_variables = sid - 1;
+  }
+
+  /*! \brief Returns the template for num_vars variables from an in-memory cache
+   *
+   * The template is created on first use.  Thread-safe.
+   */
+  static helliwell_template const& get( uint32_t num_vars )
+  {
+    static std::mutex mutex;
+    static std::map<uint32_t, std::unique_ptr<helliwell_template>> cache;
+
+    std::lock_guard<std::mutex> lock( mutex );
+    auto& t = cache[num_vars];
+    if ( !t )
+    {
+      t = std::make_unique<helliwell_template>( num_vars );
+    }
+    return *t;
+  }
+
+  /*! \brief Number of variables of the functions */
+  uint32_t num_vars() const
+  {
+    return _num_vars;
+  }
+
+  /*! \brief Number of variables used in the encoding (including Tseitin variables) */
+  int num_variables() const
+  {
+    return _num_variables;
+  }
+
+  /*! \brief Number of decision variables (= 3^n) */
+  uint32_t num_cubes() const
+  {
+    return _cubes.size();
+  }
+
+  /*! \brief Cube of decision variable g (1, ..., 3^n) */
+  kitty::cube const& cube( int g ) const
+  {
+    return _cubes.at( g - 1 );
+  }
+
+  /*! \brief Parity variable of minterm m */
+  int parity_variable( uint32_t m ) const
+  {
+    return _cubes.size() + 1 + m;
+  }
+
+  /*! \brief XOR-clauses in reduced row echelon form (the XOR of each clause must be true) */
+  std::vector<std::vector<int>> const& xor_clauses() const
+  {
+    return _xor_clauses;
+  }
+
+  /*! \brief CNF translation of the XOR-clauses */
+  std::vector<std::vector<int>> const& clauses() const
+  {
+    return _clauses;
+  }
+
+  /*! \brief Assumptions on the parity variables that select a function */
+  template<typename TT>
+  std::vector<int> assumptions( TT const& bits, TT const& care ) const
+  {
+    assert( bits.num_vars() == _num_vars && care.num_vars() == _num_vars );
+
+    std::vector<int> assumptions;
+    for ( auto m = 0u; m < ( 1u << _num_vars ); ++m )
+    {
+      if ( kitty::get_bit( care, m ) )
+      {
+        assumptions.push_back( kitty::get_bit( bits, m ) ? parity_variable( m ) : -parity_variable( m ) );
+      }
+    }
+    return assumptions;
+  }
+
+  /*! \brief Extracts the ESOP form from a model of the template */
+  esop_t esop_from_model( sat2::model const& m ) const
+  {
+    esop_t esop;
+    for ( auto g = 1u; g <= _cubes.size(); ++g )
+    {
+      if ( m[g] )
+      {
+        esop.emplace_back( _cubes[g - 1] );
+      }
+    }
+    return esop;
+  }
+
+  /*! \brief Writes the template to an output stream
+   *
+   * The format consists of a header line `helliwell <n> <#cubes>`,
+   * one line per decision variable with its cube, and one line per
+   * XOR-clause with its literals terminated by 0.
+   */
+  void write( std::ostream& os ) const
+  {
+    os << "helliwell " << _num_vars << ' ' << _cubes.size() << '\n';
+    for ( const auto& c : _cubes )
+    {
+      if ( _num_vars == 0u )
+      {
+        os << '-';
+      }
+      c.print( _num_vars, os );
+      os << '\n';
+    }
+    for ( const auto& c : _xor_clauses )
+    {
+      os << 'x';
+      for ( const auto& l : c )
+      {
+        os << ' ' << l;
+      }
+      os << " 0\n";
+    }
+  }
+
+  /*! \brief Reads a template written with `write`
+   *
+   * Only the CNF translation is recomputed; the system is not
+   * derived and eliminated again.  Returns std::nullopt if the input
+   * is not a well-formed template: a wrong keyword, more than 19
+   * variables (3^n + 2^n variable ids must fit into an int), a number
+   * of cubes other than 3^n, a malformed cube, or an XOR-clause with
+   * a literal out of range or without the terminating 0.
+   */
+  static std::optional<helliwell_template> read( std::istream& is )
+  {
+    std::string keyword;
+    uint32_t num_vars, num_cubes;
+    if ( !( is >> keyword >> num_vars >> num_cubes ) || keyword != "helliwell" || num_vars > 19u )
+    {
+      return std::nullopt;
+    }
+
+    uint32_t expected_cubes = 1u;
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      expected_cubes *= 3u;
+    }
+    if ( num_cubes != expected_cubes )
+    {
+      return std::nullopt;
+    }
+
+    helliwell_template t;
+    t._num_vars = num_vars;
+    for ( auto i = 0u; i < num_cubes; ++i )
+    {
+      std::string c;
+      if ( !( is >> c ) || c.size() != std::max( num_vars, 1u ) || c.find_first_not_of( "01-" ) != std::string::npos )
+      {
+        return std::nullopt;
+      }
+      t._cubes.emplace_back( c );
+    }
+
+    int const max_variable = t.parity_variable( ( 1u << num_vars ) - 1u );
+    std::string line;
+    while ( std::getline( is, line ) )
+    {
+      if ( line.empty() )
+      {
+        continue;
+      }
+      if ( line[0] != 'x' )
+      {
+        return std::nullopt;
+      }
+
+      std::istringstream ss( line.substr( 1u ) );
+      std::vector<int> clause;
+      int l;
+      while ( ( ss >> l ) && l != 0 )
+      {
+        if ( std::abs( l ) > max_variable )
+        {
+          return std::nullopt;
+        }
+        clause.push_back( l );
+      }
+      if ( !ss || l != 0 )
+      {
+        return std::nullopt;
+      }
+      t._xor_clauses.emplace_back( clause );
+    }
+
+    int sid = max_variable + 1;
+    std::vector<std::vector<int>> const no_xor_clauses;
+    sat2::cnf_from_xcnf cnf( sid, no_xor_clauses, sid );
+    for ( const auto& c : t._xor_clauses )
+    {
+      if ( c.empty() )
+      {
+        t._clauses.emplace_back();
+      }
+      else
+      {
+        cnf.add_xor_clause( t._clauses, c );
+      }
+    }
+    t._num_variables = sid - 1;
+    return t;
+  }
+
+protected:
+  helliwell_template() = default;
+
+protected:
+  uint32_t _num_vars = 0u;
+  int _num_variables = 0;
+  std::vector<kitty::cube> _cubes;
+  std::vector<std::vector<int>> _xor_clauses;
+  std::vector<std::vector<int>> _clauses;
+}; /* helliwell_template */
+
 struct helliwell_maxsat {};
 
 struct helliwell_maxsat_statistics
 {
+  sat2::portfolio_statistics portfolio; /*>! Statistics of the SAT-solver portfolio (if used) */
+  sat2::maxsat_solver_statistics maxsat; /*>! Statistics of the MAXSAT-solver */
+  bool timeout = false; /*>! The budget was exceeded before the first solution and the ESOP is empty (maxsat_lsu only) */
 };
 
 struct helliwell_maxsat_params
 {
+  bool native_xor = false; /*>! Propagate XOR-clauses natively instead of translating them to clauses */
+  std::vector<sat2::portfolio_solver_config> portfolio; /*>! Race these SAT-solvers on separate threads (empty: Glucose only) */
+  sat2::maxsat_solver_params maxsat; /*>! Parameters of the MAXSAT-solver (the SAT-solver portfolio is taken from portfolio) */
+  bool pkrm_hint = false; /*>! Start the search from the PKRM of the function (maxsat_lsu only) */
 };
 
 template<typename TT, typename Solver>
@@ -249,43 +577,99 @@ public:
   explicit esop_from_tt( helliwell_maxsat_statistics& stats, helliwell_maxsat_params& ps )
     : _stats( stats )
     , _ps( ps )
-    , _solver( _maxsat_stats, _maxsat_ps, _sid )
-  {}
+    , _maxsat_ps( ps.maxsat )
+  {
+    _maxsat_ps.sat.portfolio = ps.portfolio;
+  }
+
+  /*! \brief Constructor from a prepared Helliwell system
+   *
+   * The XOR-clauses are taken from the template instead of being
+   * derived and eliminated for the function.  The MAXSAT-solver is
+   * rebuilt for each function.
+   */
+  explicit esop_from_tt( helliwell_maxsat_statistics& stats, helliwell_maxsat_params& ps, helliwell_template const& t )
+    : _stats( stats )
+    , _ps( ps )
+    , _template( &t )
+    , _maxsat_ps( ps.maxsat )
+  {
+    _maxsat_ps.sat.portfolio = ps.portfolio;
+  }
 
   /*! \brief Synthesizes an ESOP form from an incompletely-specified Boolean function
    *
    * \param bits Truth table of function
    * \param care Truth table of care function
    */
-  esop_t synthesize( TT const& bits, TT const& care, std::function<int(kitty::cube)> const& cost_fn = []( kitty::cube const& cube ){ return 1; } )
+  esop_t synthesize( TT const& bits, TT const& care, std::function<int(kitty::cube)> const& cost_fn = []( kitty::cube const& ){ return 1; } )
   {
     assert( bits.num_vars() == care.num_vars() );
 
-    detail::helliwell_decision_variables g( _sid );
+    if ( _template )
+    {
+      return synthesize_from_template( bits, care, cost_fn );
+    }
+
+    int sid = 1;
+    sat2::maxsat_solver_statistics maxsat_stats;
+    maxsat_solver_t solver( maxsat_stats, _maxsat_ps, sid );
+
+    detail::helliwell_decision_variables g( sid, bits.num_vars() );
 
     /* derive 2^n constraints in 3^n variables */
     std::vector<std::vector<int>> xor_clauses;
     detail::derive_xor_clauses( xor_clauses, g, bits, care );
 
-    /* apply gause algorithm to translate XOR-clauses to clauses */
-    for ( const auto& c : detail::translate_to_cnf( _sid, xor_clauses, g.size() ) )
+    if ( _ps.native_xor )
     {
-      _solver.add_clause( c );
+      for ( const auto& c : xor_clauses )
+      {
+        solver.add_xor_clause( c );
+      }
+    }
+    else
+    {
+      /* apply gause algorithm to translate XOR-clauses to clauses */
+      for ( const auto& c : detail::translate_to_cnf( sid, xor_clauses, g.size() ) )
+      {
+        solver.add_clause( c );
+      }
     }
 
     /* add soft clauses and remember how they map onto g */
     std::unordered_map<int,int> soft_clause_map;
     for ( const auto& v : g )
     {
-      int cid = _solver.add_soft_clause( { -v.first }, cost_fn( v.second ) );
+      int cid = solver.add_soft_clause( { -v.first }, cost_fn( v.second ) );
       soft_clause_map.insert( std::make_pair( cid, v.first ) );
     }
 
+    if constexpr ( std::is_same_v<Solver, sat2::maxsat_lsu> )
+    {
+      if ( _ps.pkrm_hint )
+      {
+        auto const pkrm = pkrm_cubes( bits, care );
+        std::vector<int> hint;
+        for ( const auto& v : g )
+        {
+          hint.emplace_back( pkrm.find( v.second ) != pkrm.end() ? v.first : -v.first );
+        }
+        solver.set_hint( hint );
+      }
+    }
+
     /* extract the esop from the model */
-    auto const state = _solver.solve();
+    auto const state = solver.solve();
+    _stats.portfolio = maxsat_stats.sat.portfolio;
+    _stats.maxsat = maxsat_stats;
+    if constexpr ( std::is_same_v<Solver, sat2::maxsat_lsu> )
+    {
+      _stats.timeout = ( state == maxsat_solver_t::state::timeout );
+    }
     if ( state == maxsat_solver_t::state::success )
     {
-      auto const clause_selectors = _solver.get_disabled_clauses();
+      auto const clause_selectors = solver.get_disabled_clauses();
       return detail::esop_from_clause_selectors( clause_selectors, g, soft_clause_map );
     }
     else
@@ -298,28 +682,111 @@ public:
    *
    * \param bits Truth table of function
    */
-  esop_t synthesize( TT const& bits, std::function<int(kitty::cube)> const& cost_fn = []( kitty::cube const& cube ){ return 1; }  )
+  esop_t synthesize( TT const& bits, std::function<int(kitty::cube)> const& cost_fn = []( kitty::cube const& ){ return 1; }  )
   {
     auto const care = kitty::create<TT>( bits.num_vars() );
     return synthesize( bits, ~care, cost_fn );
   }
 
+protected:
+  static std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> pkrm_cubes( TT const& bits, TT const& care )
+  {
+    auto const esop = kitty::is_const0( ~care ) ? esop::esop_from_optimum_pkrm( bits ) : esop::esop_from_pkrm( bits, care );
+    return std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>( esop.begin(), esop.end() );
+  }
+
+  esop_t synthesize_from_template( TT const& bits, TT const& care, std::function<int(kitty::cube)> const& cost_fn )
+  {
+    assert( bits.num_vars() == _template->num_vars() );
+
+    int sid = _template->num_variables() + 1;
+    sat2::maxsat_solver_statistics maxsat_stats;
+    maxsat_solver_t solver( maxsat_stats, _maxsat_ps, sid );
+
+    if ( _ps.native_xor )
+    {
+      for ( const auto& c : _template->xor_clauses() )
+      {
+        solver.add_xor_clause( c );
+      }
+    }
+    else
+    {
+      for ( const auto& c : _template->clauses() )
+      {
+        solver.add_clause( c );
+      }
+    }
+
+    /* the function is selected by the parity variables */
+    for ( const auto& l : _template->assumptions( bits, care ) )
+    {
+      solver.add_clause( { l } );
+    }
+
+    std::unordered_map<int,int> soft_clause_map;
+    for ( auto g = 1u; g <= _template->num_cubes(); ++g )
+    {
+      int cid = solver.add_soft_clause( { -int( g ) }, cost_fn( _template->cube( g ) ) );
+      soft_clause_map.insert( std::make_pair( cid, g ) );
+    }
+
+    if constexpr ( std::is_same_v<Solver, sat2::maxsat_lsu> )
+    {
+      if ( _ps.pkrm_hint )
+      {
+        auto const pkrm = pkrm_cubes( bits, care );
+        std::vector<int> hint;
+        for ( auto g = 1u; g <= _template->num_cubes(); ++g )
+        {
+          hint.emplace_back( pkrm.find( _template->cube( g ) ) != pkrm.end() ? int( g ) : -int( g ) );
+        }
+        solver.set_hint( hint );
+      }
+    }
+
+    auto const state = solver.solve();
+    _stats.portfolio = maxsat_stats.sat.portfolio;
+    _stats.maxsat = maxsat_stats;
+    if constexpr ( std::is_same_v<Solver, sat2::maxsat_lsu> )
+    {
+      _stats.timeout = ( state == maxsat_solver_t::state::timeout );
+    }
+    if ( state == maxsat_solver_t::state::success )
+    {
+      esop_t esop;
+      for ( const auto& s : solver.get_disabled_clauses() )
+      {
+        esop.push_back( _template->cube( soft_clause_map.at( s ) ) );
+      }
+      return esop;
+    }
+    else
+    {
+      return {};
+    }
+  }
+
 protected:
   helliwell_maxsat_statistics& _stats;
   helliwell_maxsat_params const& _ps;
+  helliwell_template const* _template = nullptr;
 
-  int _sid = 1;
-
-  sat2::maxsat_solver_statistics _maxsat_stats;
   sat2::maxsat_solver_params _maxsat_ps;
-  maxsat_solver_t _solver;
 }; /* esop_from_tt */
 
 struct helliwell_sat {};
 
-struct helliwell_sat_statistics {};
+struct helliwell_sat_statistics
+{
+  sat2::portfolio_statistics portfolio; /*>! Statistics of the SAT-solver portfolio (if used) */
+};
 
-struct helliwell_sat_params {};
+struct helliwell_sat_params
+{
+  bool native_xor = false; /*>! Propagate XOR-clauses natively instead of translating them to clauses */
+  std::vector<sat2::portfolio_solver_config> portfolio; /*>! Race these SAT-solvers on separate threads (empty: Glucose only) */
+};
 
 template<typename TT, typename Solver>
 class esop_from_tt<TT, Solver, helliwell_sat>
@@ -329,7 +796,24 @@ public:
     : _stats( stats )
     , _ps( ps )
     , _solver( _sat_stats, _sat_ps )
-  {}
+  {
+    _sat_ps.portfolio = ps.portfolio;
+  }
+
+  /*! \brief Constructor from a prepared Helliwell system
+   *
+   * The template is added to the SAT-solver once; each call to
+   * synthesize only solves under the assumptions that select the
+   * function, such that learnt clauses are kept across functions.
+   */
+  explicit esop_from_tt( helliwell_sat_statistics& stats, helliwell_sat_params& ps, helliwell_template const& t )
+    : _stats( stats )
+    , _ps( ps )
+    , _template( &t )
+    , _solver( _sat_stats, _sat_ps )
+  {
+    _sat_ps.portfolio = ps.portfolio;
+  }
 
   /*! \brief Synthesizes an ESOP form from an incompletely-specified Boolean function
    *
@@ -340,20 +824,36 @@ public:
   {
     assert( bits.num_vars() == care.num_vars() );
 
-    detail::helliwell_decision_variables g( _sid );
+    if ( _template )
+    {
+      return synthesize_from_template( bits, care );
+    }
+
+    detail::helliwell_decision_variables g( _sid, bits.num_vars() );
 
     /* derive 2^n constraints in 3^n variables */
     std::vector<std::vector<int>> xor_clauses;
     detail::derive_xor_clauses( xor_clauses, g, bits, care );
 
-    /* apply gause algorithm to translate XOR-clauses to clauses */
-    for ( const auto& c : detail::translate_to_cnf( _sid, xor_clauses, g.size() ) )
+    if ( _ps.native_xor )
     {
-      _solver.add_clause( c );
+      for ( const auto& c : xor_clauses )
+      {
+        _solver.add_xor_clause( c );
+      }
+    }
+    else
+    {
+      /* apply gause algorithm to translate XOR-clauses to clauses */
+      for ( const auto& c : detail::translate_to_cnf( _sid, xor_clauses, g.size() ) )
+      {
+        _solver.add_clause( c );
+      }
     }
 
     /* extract the esop from the model */
     auto const state = _solver.solve();
+    _stats.portfolio = _sat_stats.portfolio;
     if ( state == sat2::sat_solver::state::sat )
     {
       auto const model = _solver.get_model();
@@ -376,9 +876,47 @@ public:
     return synthesize( bits, ~care );
   }
 
+protected:
+  esop_t synthesize_from_template( TT const& bits, TT const& care )
+  {
+    assert( bits.num_vars() == _template->num_vars() );
+
+    if ( !_template_added )
+    {
+      if ( _ps.native_xor )
+      {
+        for ( const auto& c : _template->xor_clauses() )
+        {
+          _solver.add_xor_clause( c );
+        }
+      }
+      else
+      {
+        for ( const auto& c : _template->clauses() )
+        {
+          _solver.add_clause( c );
+        }
+      }
+      _template_added = true;
+    }
+
+    auto const state = _solver.solve( _template->assumptions( bits, care ) );
+    _stats.portfolio = _sat_stats.portfolio;
+    if ( state == sat2::sat_solver::state::sat )
+    {
+      return _template->esop_from_model( _solver.get_model() );
+    }
+    else
+    {
+      return {};
+    }
+  }
+
 protected:
   helliwell_sat_statistics& _stats;
   helliwell_sat_params const& _ps;
+  helliwell_template const* _template = nullptr;
+  bool _template_added = false;
 
   int _sid = 1;
 
@@ -387,6 +925,158 @@ protected:
   sat2::sat_solver _solver;
 }; /* esop_from_tt */
 
+struct helliwell_min_weight {};
+
+struct helliwell_min_weight_statistics
+{
+  utils::min_weight_solver_statistics search; /*>! Statistics of the information-set search */
+  uint32_t proof_calls = 0; /*>! Number of SAT-calls to prove optimality */
+  bool optimal = false; /*>! True if the last ESOP is known to be minimum */
+};
+
+struct helliwell_min_weight_params
+{
+  utils::min_weight_solver_params search; /*>! Parameters of the information-set search */
+  bool prove_optimality = false; /*>! Improve the result until a SAT-solver proves it minimum (unit costs only) */
+};
+
+/*! \brief Helliwell via minimum-weight solutions of the XOR-clauses
+ *
+ * The Helliwell system is linear over GF(2), such that a minimum ESOP
+ * is a minimum-weight solution of it.  Instead of a MaxSAT-solver,
+ * this policy searches for such a solution with information-set
+ * decoding (see utils::min_weight_solver), which quickly finds
+ * (near-)minimum ESOPs but in general does not prove optimality.  If
+ * `prove_optimality` is set and all cubes have unit cost, the result
+ * is subsequently improved with a SAT-solver under a cardinality
+ * constraint until the solver proves it minimum.
+ */
+template<typename TT, typename Solver>
+class esop_from_tt<TT, Solver, helliwell_min_weight>
+{
+public:
+  explicit esop_from_tt( helliwell_min_weight_statistics& stats, helliwell_min_weight_params& ps )
+    : _stats( stats )
+    , _ps( ps )
+  {}
+
+  /*! \brief Synthesizes an ESOP form from an incompletely-specified Boolean function
+   *
+   * \param bits Truth table of function
+   * \param care Truth table of care function
+   * \param cost_fn Non-negative cost of each cube
+   */
+  esop_t synthesize( TT const& bits, TT const& care, std::function<int(kitty::cube)> const& cost_fn = []( kitty::cube const& ){ return 1; } )
+  {
+    assert( bits.num_vars() == care.num_vars() );
+
+    int sid = 1;
+    detail::helliwell_decision_variables g( sid, bits.num_vars() );
+
+    /* derive 2^n constraints in 3^n variables */
+    std::vector<std::vector<int>> xor_clauses;
+    detail::derive_xor_clauses( xor_clauses, g, bits, care );
+
+    /* equations over the cubes, variable v is column v - 1 */
+    auto const num_cubes = uint32_t( g.size() - 1u );
+    utils::gf2_matrix equations( xor_clauses.size(), num_cubes + 1u );
+    for ( auto r = 0u; r < xor_clauses.size(); ++r )
+    {
+      for ( const auto& l : xor_clauses[r] )
+      {
+        equations.set( r, std::abs( l ) - 1 );
+      }
+      equations.set( r, num_cubes, xor_clauses[r][0u] > 0 );
+    }
+
+    bool unit_costs = true;
+    std::vector<int64_t> costs( num_cubes );
+    for ( const auto& v : g )
+    {
+      costs[v.first - 1] = cost_fn( v.second );
+      unit_costs = unit_costs && costs[v.first - 1] == 1;
+    }
+
+    utils::min_weight_solver solver( equations, costs, _stats.search, _ps.search );
+    _stats.optimal = false;
+    if ( !solver.solve() )
+    {
+      return {};
+    }
+
+    esop_t esop;
+    for ( const auto& c : solver.solution() )
+    {
+      esop.emplace_back( g.lookup_cube( c + 1 ) );
+    }
+
+    _stats.optimal = solver.is_optimal();
+    if ( !_stats.optimal && _ps.prove_optimality && unit_costs )
+    {
+      prove_optimality( esop, xor_clauses, g, sid );
+    }
+    return esop;
+  }
+
+  /*! \brief Synthesizes an ESOP form from a completely-specified Boolean function
+   *
+   * \param bits Truth table of function
+   */
+  esop_t synthesize( TT const& bits, std::function<int(kitty::cube)> const& cost_fn = []( kitty::cube const& ){ return 1; } )
+  {
+    auto const care = kitty::create<TT>( bits.num_vars() );
+    return synthesize( bits, ~care, cost_fn );
+  }
+
+protected:
+  /*! \brief Decreases an at-most-k constraint until the SAT-solver fails */
+  void prove_optimality( esop_t& esop, std::vector<std::vector<int>> const& xor_clauses, detail::helliwell_decision_variables const& g, int& sid )
+  {
+    sat2::sat_solver_statistics sat_stats;
+    sat2::sat_solver_params sat_ps;
+    sat2::sat_solver solver( sat_stats, sat_ps );
+    for ( const auto& c : xor_clauses )
+    {
+      solver.add_xor_clause( c );
+    }
+
+    std::vector<int> lits;
+    for ( const auto& v : g )
+    {
+      lits.emplace_back( v.first );
+    }
+
+    auto bound = uint32_t( esop.size() );
+    std::vector<std::vector<int>> clauses;
+    auto const totalizer = sat2::create_totalizer( clauses, sid, lits, bound );
+    for ( const auto& c : clauses )
+    {
+      solver.add_clause( c );
+    }
+
+    while ( bound > 0u )
+    {
+      /* at most bound - 1 cubes */
+      solver.add_clause( { -totalizer->vars[bound - 1u] } );
+
+      ++_stats.proof_calls;
+      if ( solver.solve() != sat2::sat_solver::state::sat )
+      {
+        break;
+      }
+
+      esop = detail::esop_from_model( solver.get_model(), g );
+      assert( esop.size() < bound );
+      bound = esop.size();
+    }
+    _stats.optimal = true;
+  }
+
+protected:
+  helliwell_min_weight_statistics& _stats;
+  helliwell_min_weight_params const& _ps;
+}; /* esop_from_tt */
+
 } /* namespace easy::esop */
 
 // Local Variables:
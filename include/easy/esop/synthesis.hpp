@@ -27,8 +27,10 @@
 
 #include <easy/esop/esop.hpp>
 #include <easy/esop/exact_synthesis.hpp>
+#include <easy/sat/cnf_symmetry_breaking.hpp>
 #include <easy/sat/gauss.hpp>
 #include <easy/sat/xor_clauses_to_cnf.hpp>
+#include <kitty/algorithm.hpp>
 #include <json/json.hpp>
 
 namespace easy::esop
@@ -48,8 +50,8 @@ inline esop_t esop_from_model( const sat::sat_solver::model_t& model, unsigned n
     bool cancel_cube = false;
     for ( auto l = 0u; l < num_vars; ++l )
     {
-      const auto p_value = model[j * num_vars + l] == l_True;
-      const auto q_value = model[num_vars * num_terms + j * num_vars + l] == l_True;
+      const auto p_value = model[j * num_vars + l] == Glucose::l_True;
+      const auto q_value = model[num_vars * num_terms + j * num_vars + l] == Glucose::l_True;
 
       if ( p_value && q_value )
       {
@@ -113,6 +115,221 @@ struct result
   esop_t esop;
 }; /* result */
 
+namespace detail
+{
+
+/*! \brief Encodes the value of an ESOP with `num_terms` terms on one minterm
+ *
+ * Variables 1, ..., num_vars * num_terms are the positive literals
+ * p_j,l and the following ones the negative literals q_j,l of the
+ * terms.  One fresh variable z_j per term, starting at `sid`, is true
+ * iff term j contains `minterm`, and the XOR of all z_j is `value`.
+ */
+inline void add_minterm( sat::constraints& constraints, int& sid, uint32_t num_vars, uint32_t num_terms, uint32_t minterm, bool value )
+{
+  std::vector<int> z_vars( num_terms, 0u );
+  for ( auto j = 0u; j < num_terms; ++j )
+  {
+    z_vars[j] = sid++;
+  }
+
+  for ( auto j = 0u; j < num_terms; ++j )
+  {
+    const int z = z_vars[j];
+
+    // positive
+    for ( auto l = 0u; l < num_vars; ++l )
+    {
+      if ( ( minterm >> l ) & 1 )
+      {
+        constraints.add_clause( {-z, -int( 1 + num_vars * num_terms + num_vars * j + l )} ); // -z_j, -q_j,l
+      }
+      else
+      {
+        constraints.add_clause( {-z, -int( 1 + num_vars * j + l )} ); // -z_j, -p_j,l
+      }
+    }
+
+    // negative
+    std::vector<int> clause = {z};
+    for ( auto l = 0u; l < num_vars; ++l )
+    {
+      if ( ( minterm >> l ) & 1 )
+      {
+        clause.push_back( 1 + num_vars * num_terms + num_vars * j + l ); // q_j,l
+      }
+      else
+      {
+        clause.push_back( 1 + num_vars * j + l ); // p_j,l
+      }
+    }
+
+    constraints.add_clause( clause );
+  }
+
+  constraints.add_xor_clause( z_vars, value );
+}
+
+/*! \brief Encodes all care minterms of the specification for `num_terms` terms */
+inline void add_care_minterms( sat::constraints& constraints, int& sid, const spec& spec, uint32_t num_vars, uint32_t num_terms )
+{
+  for ( auto minterm = 0u; minterm < ( 1u << num_vars ); ++minterm )
+  {
+    /* skip don't cares */
+    if ( ( spec.bits[minterm] != '0' && spec.bits[minterm] != '1' ) || spec.care[minterm] != '1' )
+    {
+      continue;
+    }
+
+    add_minterm( constraints, sid, num_vars, num_terms, minterm, spec.bits[minterm] == '1' );
+  }
+}
+
+/*! \brief Lazy encoding of the minterm constraints
+ *
+ * Instead of encoding all care minterms of the specification up
+ * front, the constraints start from a sample of the minterms and are
+ * refined with counterexamples (CEGAR): each candidate ESOP is
+ * simulated bit-parallel on the full specification and only the
+ * violated minterms are added to the same incremental solver.  Since
+ * the sample is a subset of the specification, UNSAT on the sample
+ * implies UNSAT on the specification.
+ */
+class cegar_encoder
+{
+public:
+  explicit cegar_encoder( const spec& spec, uint32_t num_vars, uint32_t num_terms, int& sid )
+      : _spec( spec ), _num_vars( num_vars ), _num_terms( num_terms ), _sid( sid ), _bits( num_vars ), _care( num_vars ), _sampled( 1ull << num_vars, false )
+  {
+    for ( auto i = 0u; i < _spec.bits.size(); ++i )
+    {
+      if ( ( _spec.bits[i] == '0' || _spec.bits[i] == '1' ) && _spec.care[i] == '1' )
+      {
+        kitty::set_bit( _care, i );
+        if ( _spec.bits[i] == '1' )
+        {
+          kitty::set_bit( _bits, i );
+        }
+      }
+    }
+  }
+
+  /*! \brief Adds `sample_size` care minterms, evenly spread over the specification */
+  void add_sample( sat::constraints& constraints, uint32_t sample_size )
+  {
+    add_spread( constraints, care_minterms( _care ), sample_size );
+  }
+
+  /*! \brief Solves and refines until a candidate implements the specification
+   *
+   * The XOR-constraints added since the last call are either passed
+   * to the solver natively or translated into clauses.  If the result
+   * is SAT, `esop` implements the specification.  All refinements
+   * share `conflict_limit` conflicts (-1 for no limit); each solver
+   * call gets the remaining conflicts as its budget, and the result is
+   * undefined once they are used up.
+   */
+  sat::sat_solver::result solve( sat::sat_solver& solver, sat::constraints& constraints, const sat::sat_solver::assumptions_t& assumptions, bool native_xor, uint32_t max_counterexamples, int conflict_limit, esop_t& esop )
+  {
+    const auto conflicts_before = solver.get_conflicts();
+    while ( true )
+    {
+      sat::gauss_elimination().apply( constraints );
+      if ( native_xor )
+      {
+        solver.set_native_xor( true );
+      }
+      else
+      {
+        sat::xor_clauses_to_cnf( _sid ).apply( constraints );
+      }
+
+      if ( conflict_limit != -1 )
+      {
+        const auto remaining = conflict_limit - ( solver.get_conflicts() - conflicts_before );
+        if ( remaining <= 0 )
+        {
+          return sat::sat_solver::result( Glucose::l_Undef );
+        }
+        solver.set_conflict_budget_per_call( remaining );
+      }
+
+      ++_iterations;
+      auto result = solver.solve( constraints, assumptions );
+      if ( !result.is_sat() )
+      {
+        return result;
+      }
+
+      esop = esop_from_model( result.model, _num_terms, _num_vars );
+
+      auto tt = _bits.construct();
+      kitty::create_from_cubes( tt, esop, true );
+      auto const counterexamples = care_minterms( ( tt ^ _bits ) & _care );
+      if ( counterexamples.empty() )
+      {
+        return result;
+      }
+      add_spread( constraints, counterexamples, max_counterexamples == 0u ? counterexamples.size() : max_counterexamples );
+    }
+  }
+
+  /*! \brief Number of solver calls */
+  uint32_t num_iterations() const
+  {
+    return _iterations;
+  }
+
+  /*! \brief Number of encoded minterms */
+  uint32_t sample_size() const
+  {
+    return _sample_size;
+  }
+
+private:
+  std::vector<uint32_t> care_minterms( const kitty::dynamic_truth_table& tt ) const
+  {
+    std::vector<uint32_t> minterms;
+    kitty::for_each_one_bit( tt, [&]( auto bit ) { minterms.emplace_back( uint32_t( bit ) ); } );
+    return minterms;
+  }
+
+  /* adds `count` of the minterms at equidistant positions */
+  void add_spread( sat::constraints& constraints, const std::vector<uint32_t>& minterms, std::size_t count )
+  {
+    count = std::min( count, minterms.size() );
+    for ( auto i = 0u; i < count; ++i )
+    {
+      auto const minterm = minterms[i * minterms.size() / count];
+      if ( !_sampled[minterm] )
+      {
+        add_minterm( constraints, minterm );
+      }
+    }
+  }
+
+  void add_minterm( sat::constraints& constraints, uint32_t minterm )
+  {
+    _sampled[minterm] = true;
+    ++_sample_size;
+    detail::add_minterm( constraints, _sid, _num_vars, _num_terms, minterm, kitty::get_bit( _bits, minterm ) );
+  }
+
+private:
+  const spec& _spec;
+  const uint32_t _num_vars;
+  const uint32_t _num_terms;
+  int& _sid;
+
+  kitty::dynamic_truth_table _bits;
+  kitty::dynamic_truth_table _care;
+  std::vector<bool> _sampled;
+  uint32_t _sample_size = 0u;
+  uint32_t _iterations = 0u;
+}; /* cegar_encoder */
+
+} // namespace detail
+
 /*! \brief Compute a cover from a truth table.
  *
  * Convert each minterm of the specification into one cube.
@@ -142,6 +359,19 @@ struct simple_synthesizer_params
   /*! A fixed number of product terms (= k) */
   unsigned number_of_terms;
   int conflict_limit = -1;
+  /*! Require the terms to be in strict lexicographic order */
+  bool symmetry_breaking = false;
+  /*! Propagate the XOR-clauses natively in the SAT-solver instead of translating them to clauses */
+  bool native_xor = false;
+  /*! Race these SAT-solvers on separate threads (empty: Glucose only) */
+  std::vector<sat2::portfolio_solver_config> portfolio;
+  /*! Encode the minterms lazily: start from a sample and add the
+      minterms violated by each candidate ESOP (CEGAR) */
+  bool cegar = false;
+  /*! Number of minterms in the initial sample (CEGAR) */
+  uint32_t cegar_sample_size = 16u;
+  /*! Maximum number of violated minterms added per iteration (CEGAR, 0 adds all) */
+  uint32_t cegar_counterexamples = 4u;
 }; /* simple_synthesizer_params */
 
 /*! \brief Simple ESOP synthesizer
@@ -189,84 +419,38 @@ public:
     {
       solver.set_conflict_limit( params.conflict_limit );
     }
+    solver.set_portfolio( params.portfolio );
 
-    /* add constraints */
-    kitty::cube minterm = kitty::cube::neg_cube( num_vars );
-
-    auto sample_counter = 0u;
-    do
+    if ( params.cegar )
     {
-      /* skip don't cares */
-      if ( ( _spec.bits[minterm._bits] != '0' && _spec.bits[minterm._bits] != '1' ) || _spec.care[minterm._bits] != '1' )
-      {
-        ++minterm._bits;
-        continue;
-      }
-
-      std::vector<int> z_vars( num_terms, 0u );
-      for ( auto j = 0u; j < num_terms; ++j )
-      {
-        assert( uint32_t(sid) == 1 + 2 * num_vars * num_terms + sample_counter * num_terms + j );
-        z_vars[j] = sid++;
-      }
-
-      for ( auto j = 0u; j < num_terms; ++j )
-      {
-        const int z = z_vars[j];
-
-        // positive
-        for ( auto l = 0u; l < num_vars; ++l )
-        {
-          if ( minterm.get_bit( l ) )
-          {
-            std::vector<int> clause;
-            clause.push_back( -z );                                               // - z_j
-            clause.push_back( -( 1 + num_vars * num_terms + num_vars * j + l ) ); // -q_j,l
-
-            constraints.add_clause( clause );
-          }
-          else
-          {
-            std::vector<int> clause;
-            clause.push_back( -z );                        // -z_j
-            clause.push_back( -( 1 + num_vars * j + l ) ); // -p_j,l
-
-            constraints.add_clause( clause );
-          }
-        }
-      }
-
-      for ( auto j = 0u; j < num_terms; ++j )
-      {
-        const int z = z_vars[j];
-
-        // negative
-        std::vector<int> clause = {z};
-        for ( auto l = 0u; l < num_vars; ++l )
-        {
-          if ( minterm.get_bit( l ) )
-          {
-            clause.push_back( 1 + num_vars * num_terms + num_vars * j + l ); // q_j,l
-          }
-          else
-          {
-            clause.push_back( 1 + num_vars * j + l ); // p_j,l
-          }
-        }
-
-        constraints.add_clause( clause );
-      }
-
-      constraints.add_xor_clause( z_vars, _spec.bits[minterm._bits] == '1' );
+      return synthesize_cegar( params, solver, num_vars );
+    }
 
-      ++sample_counter;
-      ++minterm._bits;
-    } while ( minterm._bits < ( 1 << num_vars ) );
+    /* add constraints */
+    detail::add_care_minterms( constraints, sid, _spec, num_vars, num_terms );
 
     sat::gauss_elimination().apply( constraints );
-    sat::xor_clauses_to_cnf( sid ).apply( constraints );
+    if ( params.native_xor )
+    {
+      solver.set_native_xor( true );
+    }
+    else
+    {
+      sat::xor_clauses_to_cnf( sid ).apply( constraints );
+    }
+    if ( params.symmetry_breaking )
+    {
+      sat::cnf_symmetry_breaking( sid, num_vars, num_terms ).apply( constraints );
+    }
 
     const auto sat = solver.solve( constraints );
+    _stats["k"] = num_terms;
+    _stats["conflicts"] = solver.get_conflicts();
+    if ( !params.portfolio.empty() )
+    {
+      _stats["winner"] = solver.get_portfolio_statistics().last_winner_name();
+    }
+
     if ( sat.is_undef() )
     {
       return result();
@@ -292,6 +476,49 @@ public:
   }
 
 private:
+  /*! \brief synthesize_cegar
+   *
+   * Same as synthesize, but encodes the minterms lazily (see
+   * detail::cegar_encoder).
+   */
+  result synthesize_cegar( const simple_synthesizer_params& params, sat::sat_solver& solver, uint32_t num_vars )
+  {
+    const auto num_terms = params.number_of_terms;
+    int sid = 1 + 2 * num_vars * num_terms;
+
+    sat::constraints constraints;
+    detail::cegar_encoder encoder( _spec, num_vars, num_terms, sid );
+    encoder.add_sample( constraints, params.cegar_sample_size );
+    if ( params.symmetry_breaking )
+    {
+      sat::cnf_symmetry_breaking( sid, num_vars, num_terms ).apply( constraints );
+    }
+
+    esop_t esop;
+    const auto sat = encoder.solve( solver, constraints, {}, params.native_xor, params.cegar_counterexamples, params.conflict_limit, esop );
+    _stats["k"] = num_terms;
+    _stats["conflicts"] = solver.get_conflicts();
+    _stats["cegar_iterations"] = encoder.num_iterations();
+    _stats["sample_size"] = encoder.sample_size();
+    if ( !params.portfolio.empty() )
+    {
+      _stats["winner"] = solver.get_portfolio_statistics().last_winner_name();
+    }
+
+    if ( sat.is_undef() )
+    {
+      return result();
+    }
+    else if ( sat.is_unsat() )
+    {
+      return result( unrealizable );
+    }
+    else
+    {
+      return result( esop );
+    }
+  }
+
   /*! \brief make_esop
    *
    * Extract the ESOP from a satisfying assignments.
@@ -335,6 +562,24 @@ struct minimum_synthesizer_params
       terminate, and updates the value */
   std::function<bool( uint32_t&, sat::sat_solver::result )> next;
   int conflict_limit = -1;
+  /*! Require the terms to be in strict lexicographic order */
+  bool symmetry_breaking = false;
+  /*! Encode the constraints once for the maximum number of terms and
+      solve all bounds on one incremental SAT-solver instance */
+  bool incremental = false;
+  /*! Maximum number of terms considered in incremental mode (0 uses begin) */
+  uint32_t max_number_of_terms = 0;
+  /*! Propagate the XOR-clauses natively in the SAT-solver instead of translating them to clauses */
+  bool native_xor = false;
+  /*! Race these SAT-solvers on separate threads (empty: Glucose only) */
+  std::vector<sat2::portfolio_solver_config> portfolio;
+  /*! Encode the minterms lazily: start from a sample and add the
+      minterms violated by each candidate ESOP (CEGAR) */
+  bool cegar = false;
+  /*! Number of minterms in the initial sample (CEGAR) */
+  uint32_t cegar_sample_size = 16u;
+  /*! Maximum number of violated minterms added per iteration (CEGAR, 0 adds all) */
+  uint32_t cegar_counterexamples = 4u;
 }; /* minimum_synthesizer_params */
 
 /*! \brief Minimum ESOP synthesizer
@@ -370,11 +615,21 @@ public:
     assert( _spec.care.size() == ( 1ull << num_vars ) && "bit-width of care is not a power of 2" );
     assert( num_vars <= 32 && "cube data structure cannot store more than 32 variables" );
 
+    if ( params.incremental )
+    {
+      return synthesize_incremental( params, num_vars );
+    }
+    if ( params.cegar )
+    {
+      return synthesize_cegar( params, num_vars );
+    }
+
     esop_t esop;
     sat::sat_solver::result result;
     bool all_unsat = true;
 
     uint32_t k = params.begin;
+    _stats["conflicts"] = 0;
     do
     {
       assert( k != 0 && "synthesis of constants not supported" );
@@ -387,89 +642,121 @@ public:
       {
         solver.set_conflict_limit( params.conflict_limit );
       }
+      solver.set_portfolio( params.portfolio );
 
       /* add constraints */
-      kitty::cube minterm = kitty::cube::neg_cube( num_vars );
+      detail::add_care_minterms( constraints, sid, _spec, num_vars, k );
 
-      auto sample_counter = 0u;
-      do
+      sat::gauss_elimination().apply( constraints );
+      if ( params.native_xor )
       {
-        /* skip don't cares */
-        if ( ( _spec.bits[minterm._bits] != '0' && _spec.bits[minterm._bits] != '1' ) || _spec.care[minterm._bits] != '1' )
-        {
-          ++minterm._bits;
-          continue;
-        }
+        solver.set_native_xor( true );
+      }
+      else
+      {
+        sat::xor_clauses_to_cnf( sid ).apply( constraints );
+      }
+      if ( params.symmetry_breaking )
+      {
+        sat::cnf_symmetry_breaking( sid, num_vars, k ).apply( constraints );
+      }
 
-        std::vector<int> z_vars( k, 0u );
-        for ( auto j = 0u; j < k; ++j )
-        {
-          assert( uint32_t(sid) == 1 + 2 * num_vars * k + sample_counter * k + j );
-          z_vars[j] = sid++;
-        }
+      result = solver.solve( constraints );
+      _stats["k"] = k;
+      _stats["conflicts"] = _stats["conflicts"].get<int64_t>() + solver.get_conflicts();
+      if ( !params.portfolio.empty() )
+      {
+        _stats["winners"].push_back( {{"k", k}, {"winner", solver.get_portfolio_statistics().last_winner_name()}} );
+      }
 
-        for ( auto j = 0u; j < k; ++j )
-        {
-          const int z = z_vars[j];
+      if ( result.is_sat() )
+      {
+        esop = make_esop( result.model, k, num_vars );
+      }
 
-          // positive
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                                       // - z_j
-              clause.push_back( -( 1 + num_vars * k + num_vars * j + l ) ); // -q_j,l
+      if ( !result.is_unsat() )
+      {
+        all_unsat = false;
+      }
+    } while ( params.next( k, result ) );
 
-              constraints.add_clause( clause );
-            }
-            else
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                        // -z_j
-              clause.push_back( -( 1 + num_vars * j + l ) ); // -p_j,l
+    /* no ESOP constructed, either UNSAT or UNREALIZABLE */
+    if ( esop.size() == 0u )
+    {
+      if ( all_unsat )
+        return easy::esop::result( unrealizable );
+      else
+        return easy::esop::result();
+    }
 
-              constraints.add_clause( clause );
-            }
-          }
-        }
+    return esop;
+  }
 
-        for ( auto j = 0u; j < k; ++j )
-        {
-          const int z = z_vars[j];
+  /*! \brief stats
+   *
+   * \Return A json log with statistics logged during the synthesis
+   */
+  nlohmann::json stats() const
+  {
+    return _stats;
+  }
 
-          // negative
-          std::vector<int> clause = {z};
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              clause.push_back( 1 + num_vars * k + num_vars * j + l ); // q_j,l
-            }
-            else
-            {
-              clause.push_back( 1 + num_vars * j + l ); // p_j,l
-            }
-          }
+private:
+  /*! \brief synthesize_cegar
+   *
+   * Same as synthesize, but encodes the minterms lazily for each
+   * bound (see detail::cegar_encoder).
+   *
+   * \params params Parameters
+   * \params num_vars Number of variables
+   * \return An ESOP form
+   */
+  result synthesize_cegar( const minimum_synthesizer_params& params, uint32_t num_vars )
+  {
+    esop_t esop;
+    sat::sat_solver::result result;
+    bool all_unsat = true;
 
-          constraints.add_clause( clause );
-        }
+    uint32_t cegar_iterations = 0u;
+    _stats["conflicts"] = 0;
 
-        constraints.add_xor_clause( z_vars, _spec.bits[minterm._bits] == '1' );
+    uint32_t k = params.begin;
+    do
+    {
+      assert( k != 0 && "synthesis of constants not supported" );
+      int sid = 1 + 2 * num_vars * k;
 
-        ++sample_counter;
-        ++minterm._bits;
-      } while ( minterm._bits < ( 1 << num_vars ) );
+      sat::constraints constraints;
+      sat::sat_solver solver;
 
-      sat::gauss_elimination().apply( constraints );
-      sat::xor_clauses_to_cnf( sid ).apply( constraints );
-      // sat::cnf_symmetry_breaking( sid ).apply( constraints );
+      if ( params.conflict_limit != -1 )
+      {
+        solver.set_conflict_limit( params.conflict_limit );
+      }
+      solver.set_portfolio( params.portfolio );
 
-      result = solver.solve( constraints );
+      detail::cegar_encoder encoder( _spec, num_vars, k, sid );
+      encoder.add_sample( constraints, params.cegar_sample_size );
+      if ( params.symmetry_breaking )
+      {
+        sat::cnf_symmetry_breaking( sid, num_vars, k ).apply( constraints );
+      }
+
+      esop_t candidate;
+      result = encoder.solve( solver, constraints, {}, params.native_xor, params.cegar_counterexamples, params.conflict_limit, candidate );
+      cegar_iterations += encoder.num_iterations();
+
+      _stats["k"] = k;
+      _stats["conflicts"] = _stats["conflicts"].get<int64_t>() + solver.get_conflicts();
+      _stats["sample_size"] = encoder.sample_size();
+      if ( !params.portfolio.empty() )
+      {
+        _stats["winners"].push_back( {{"k", k}, {"winner", solver.get_portfolio_statistics().last_winner_name()}} );
+      }
 
       if ( result.is_sat() )
       {
-        esop = make_esop( result.model, k, num_vars );
+        esop = candidate;
       }
 
       if ( !result.is_unsat() )
@@ -478,6 +765,8 @@ public:
       }
     } while ( params.next( k, result ) );
 
+    _stats["cegar_iterations"] = cegar_iterations;
+
     /* no ESOP constructed, either UNSAT or UNREALIZABLE */
     if ( esop.size() == 0u )
     {
@@ -490,16 +779,150 @@ public:
     return esop;
   }
 
-  /*! \brief stats
+  /*! \brief synthesize_incremental
    *
-   * \Return A json log with statistics logged during the synthesis
+   * Encodes the constraints once for the maximum number of terms
+   * k_max and guards each term j with an activation literal a_j.  A
+   * term is disabled by assuming !a_j, which forces p_j,0 and q_j,0 to
+   * be true and thus cancels the term.  All bounds k are solved under
+   * assumptions on the same solver instance, such that learnt clauses
+   * are kept between bounds.
+   *
+   * \params params Parameters
+   * \params num_vars Number of variables
+   * \return An ESOP form
    */
-  nlohmann::json stats() const
+  result synthesize_incremental( const minimum_synthesizer_params& params, uint32_t num_vars )
   {
-    return _stats;
+    assert( num_vars > 0 && "synthesis of constants not supported" );
+
+    const uint32_t k_max = std::max( uint32_t( params.begin ), params.max_number_of_terms );
+    assert( k_max != 0 && "synthesis of constants not supported" );
+
+    int sid = 1 + 2 * num_vars * k_max;
+
+    sat::constraints constraints;
+    sat::sat_solver solver;
+
+    /* each bound gets the conflict limit, as without incremental mode */
+    if ( params.conflict_limit != -1 )
+    {
+      solver.set_conflict_budget_per_call( params.conflict_limit );
+    }
+    solver.set_portfolio( params.portfolio );
+
+    detail::cegar_encoder encoder( _spec, num_vars, k_max, sid );
+    if ( params.cegar )
+    {
+      encoder.add_sample( constraints, params.cegar_sample_size );
+    }
+    else
+    {
+      /* add constraints */
+      detail::add_care_minterms( constraints, sid, _spec, num_vars, k_max );
+
+      sat::gauss_elimination().apply( constraints );
+      if ( params.native_xor )
+      {
+        solver.set_native_xor( true );
+      }
+      else
+      {
+        sat::xor_clauses_to_cnf( sid ).apply( constraints );
+      }
+    }
+
+    /* activation literals: !a_j -> ( p_j,0 & q_j,0 ) */
+    std::vector<int> activation( k_max );
+    for ( auto j = 0u; j < k_max; ++j )
+    {
+      activation[j] = sid++;
+      constraints.add_clause( {activation[j], int( 1 + num_vars * j )} );
+      constraints.add_clause( {activation[j], int( 1 + num_vars * k_max + num_vars * j )} );
+    }
+
+    if ( params.symmetry_breaking )
+    {
+      sat::cnf_symmetry_breaking( sid, num_vars, k_max, activation ).apply( constraints );
+    }
+
+    esop_t esop;
+    sat::sat_solver::result result;
+    bool all_unsat = true;
+
+    _stats["incremental"] = true;
+    _stats["max_number_of_terms"] = k_max;
+    _stats["bounds"] = nlohmann::json::array();
+
+    uint32_t k = params.begin;
+    do
+    {
+      assert( k != 0 && "synthesis of constants not supported" );
+      assert( k <= k_max && "number of terms exceeds the encoded maximum" );
+
+      /* disable the terms k, ..., k_max-1 */
+      sat::sat_solver::assumptions_t assumptions;
+      for ( auto j = k; j < k_max; ++j )
+      {
+        assumptions.push_back( -activation[j] );
+      }
+
+      const auto learnts_before = solver.get_num_learnts();
+      const auto conflicts_before = solver.get_conflicts();
+
+      if ( params.cegar )
+      {
+        esop_t candidate;
+        result = encoder.solve( solver, constraints, assumptions, params.native_xor, params.cegar_counterexamples, params.conflict_limit, candidate );
+        if ( result.is_sat() )
+        {
+          esop = candidate;
+        }
+      }
+      else
+      {
+        result = solver.solve( constraints, assumptions );
+        if ( result.is_sat() )
+        {
+          esop = make_esop( result.model, k_max, num_vars );
+        }
+      }
+
+      if ( !result.is_unsat() )
+      {
+        all_unsat = false;
+      }
+
+      _stats["bounds"].push_back( {{"k", k},
+                                   {"state", result.is_sat() ? "sat" : ( result.is_unsat() ? "unsat" : "unknown" )},
+                                   {"conflicts", solver.get_conflicts() - conflicts_before},
+                                   {"learnts_kept", learnts_before}} );
+      if ( !params.portfolio.empty() )
+      {
+        _stats["bounds"].back()["winner"] = solver.get_portfolio_statistics().last_winner_name();
+      }
+      _stats["k"] = k;
+    } while ( params.next( k, result ) );
+
+    _stats["conflicts"] = solver.get_conflicts();
+    if ( params.cegar )
+    {
+      _stats["cegar_iterations"] = encoder.num_iterations();
+      _stats["sample_size"] = encoder.sample_size();
+    }
+
+    /* no ESOP constructed, either UNSAT or UNREALIZABLE */
+    if ( esop.size() == 0u )
+    {
+      if ( all_unsat )
+        return easy::esop::result( unrealizable );
+      else
+        return easy::esop::result();
+    }
+
+    return esop;
   }
 
-private:
   /*! \brief make_esop
    *
    * Extract the ESOP from a satisfying assignments.
@@ -543,6 +966,16 @@ struct minimum_all_synthesizer_params
       terminate, and updates the value */
   std::function<bool( uint32_t&, sat::sat_solver::result )> next;
   int conflict_limit = -1;
+  /*! Require the terms to be in strict lexicographic order, such that
+      only one blocking clause per solution is required */
+  bool symmetry_breaking = false;
+  /*! Encode the minterms lazily: start from a sample and add the
+      minterms violated by each candidate ESOP (CEGAR) */
+  bool cegar = false;
+  /*! Number of minterms in the initial sample (CEGAR) */
+  uint32_t cegar_sample_size = 16u;
+  /*! Maximum number of violated minterms added per iteration (CEGAR, 0 adds all) */
+  uint32_t cegar_counterexamples = 4u;
 }; /* minimum_all_synthesizer_params */
 
 /*! \brief Minimum ESOP synthesizer
@@ -583,93 +1016,53 @@ public:
 
     std::unique_ptr<sat::constraints> constraints;
     std::unique_ptr<sat::sat_solver> solver;
+    std::unique_ptr<detail::cegar_encoder> encoder;
 
-    uint32_t k = params.begin;
-    do
-    {
-      int sid = 1 + 2 * num_vars * k;
+    int sid = 1;
+    uint32_t cegar_iterations = 0u;
+
+    /* encodes the minterms for k terms on a fresh solver */
+    auto const encode = [&]( uint32_t k ) {
+      sid = 1 + 2 * num_vars * k;
 
       constraints.reset( new sat::constraints );
       solver.reset( new sat::sat_solver );
 
-      /* add constraints */
-      kitty::cube minterm = kitty::cube::neg_cube( num_vars );
-
-      auto sample_counter = 0u;
-      do
+      if ( params.cegar )
       {
-        /* skip don't cares */
-        if ( ( _spec.bits[minterm._bits] != '0' && _spec.bits[minterm._bits] != '1' ) || _spec.care[minterm._bits] != '1' )
-        {
-          ++minterm._bits;
-          continue;
-        }
-
-        std::vector<int> z_vars( k, 0u );
-        for ( auto j = 0u; j < k; ++j )
+        if ( encoder )
         {
-          assert( uint32_t(sid) == 1 + 2 * num_vars * k + sample_counter * k + j );
-          z_vars[j] = sid++;
+          cegar_iterations += encoder->num_iterations();
         }
+        encoder.reset( new detail::cegar_encoder( _spec, num_vars, k, sid ) );
+        encoder->add_sample( *constraints, params.cegar_sample_size );
+      }
+      else
+      {
+        add_minterm_constraints( *constraints, sid, num_vars, k );
+      }
 
-        for ( auto j = 0u; j < k; ++j )
-        {
-          const int z = z_vars[j];
-
-          // positive
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                                       // - z_j
-              clause.push_back( -( 1 + num_vars * k + num_vars * j + l ) ); // -q_j,l
-
-              constraints->add_clause( clause );
-            }
-            else
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                        // -z_j
-              clause.push_back( -( 1 + num_vars * j + l ) ); // -p_j,l
-
-              constraints->add_clause( clause );
-            }
-          }
-        }
-
-        for ( auto j = 0u; j < k; ++j )
-        {
-          const int z = z_vars[j];
-
-          // negative
-          std::vector<int> clause = {z};
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              clause.push_back( 1 + num_vars * k + num_vars * j + l ); // q_j,l
-            }
-            else
-            {
-              clause.push_back( 1 + num_vars * j + l ); // p_j,l
-            }
-          }
-
-          constraints->add_clause( clause );
-        }
-
-        constraints->add_xor_clause( z_vars, _spec.bits[minterm._bits] == '1' );
-
-        ++sample_counter;
-        ++minterm._bits;
-      } while ( minterm._bits < ( 1 << num_vars ) );
+      if ( params.symmetry_breaking )
+      {
+        sat::cnf_symmetry_breaking( sid, num_vars, k ).apply( *constraints );
+      }
+    };
 
-      sat::gauss_elimination().apply( *constraints );
-      sat::xor_clauses_to_cnf( sid ).apply( *constraints );
-      // sat::cnf_symmetry_breaking( sid ).apply( *constraints );
+    /* solves and, for CEGAR, refines until the model implements the specification */
+    auto const solve = [&]() {
+      if ( params.cegar )
+      {
+        esop_t candidate;
+        return encoder->solve( *solver, *constraints, {}, false, params.cegar_counterexamples, -1, candidate );
+      }
+      return solver->solve( *constraints );
+    };
 
-      if ( ( result = solver->solve( *constraints ) ) )
+    uint32_t k = params.begin;
+    do
+    {
+      encode( k );
+      if ( ( result = solve() ) )
       {
         esop = make_esop( result.model, k, num_vars );
       }
@@ -679,93 +1072,12 @@ public:
     if ( k < esop.size() )
     {
       k = esop.size();
-
-      int sid = 1 + 2 * num_vars * k;
-
-      constraints.reset( new sat::constraints );
-      solver.reset( new sat::sat_solver );
-
-      /* add constraints */
-      kitty::cube minterm = kitty::cube::neg_cube( num_vars );
-
-      auto sample_counter = 0u;
-      do
-      {
-        /* skip don't cares */
-        if ( ( _spec.bits[minterm._bits] != '0' && _spec.bits[minterm._bits] != '1' ) || _spec.care[minterm._bits] != '1' )
-        {
-          ++minterm._bits;
-          continue;
-        }
-
-        std::vector<int> z_vars( k, 0u );
-        for ( auto j = 0u; j < k; ++j )
-        {
-          assert( uint32_t(sid) == 1 + 2 * num_vars * k + sample_counter * k + j );
-          z_vars[j] = sid++;
-        }
-
-        for ( auto j = 0u; j < k; ++j )
-        {
-          const int z = z_vars[j];
-
-          // positive
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                                       // - z_j
-              clause.push_back( -( 1 + num_vars * k + num_vars * j + l ) ); // -q_j,l
-
-              constraints->add_clause( clause );
-            }
-            else
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                        // -z_j
-              clause.push_back( -( 1 + num_vars * j + l ) ); // -p_j,l
-
-              constraints->add_clause( clause );
-            }
-          }
-        }
-
-        for ( auto j = 0u; j < k; ++j )
-        {
-          const int z = z_vars[j];
-
-          // negative
-          std::vector<int> clause = {z};
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              clause.push_back( 1 + num_vars * k + num_vars * j + l ); // q_j,l
-            }
-            else
-            {
-              clause.push_back( 1 + num_vars * j + l ); // p_j,l
-            }
-          }
-
-          constraints->add_clause( clause );
-        }
-
-        constraints->add_xor_clause( z_vars, _spec.bits[minterm._bits] == '1' );
-
-        ++sample_counter;
-        ++minterm._bits;
-      } while ( minterm._bits < ( 1 << num_vars ) );
-
-      sat::gauss_elimination().apply( *constraints );
-      sat::xor_clauses_to_cnf( sid ).apply( *constraints );
-      // sat::cnf_symmetry_breaking( sid ).apply( *constraints );
+      encode( k );
     }
 
     /* enumerate solutions */
     esops_t esops;
-    while ( auto result = solver->solve( *constraints ) )
+    while ( auto result = solve() )
     {
       std::vector<int> blocking_clause;
       std::vector<unsigned> vs;
@@ -779,36 +1091,72 @@ public:
 
       std::sort( esop.begin(), esop.end(), cube_weight_compare( num_vars ) );
 
-      /* add one blocking clause for each possible permutation of the cubes */
-      do
+      /* terms are ordered, a single blocking clause suffices */
+      if ( params.symmetry_breaking )
       {
         std::vector<int> blocking_clause;
-        for ( auto j = 0u; j < vs.size(); ++j )
+        for ( auto j = 0u; j < k; ++j )
         {
           for ( auto l = 0u; l < num_vars; ++l )
           {
-            const auto p_value = result.model[j * num_vars + l] == l_True;
-            const auto q_value = result.model[num_vars * k + j * num_vars + l] == l_True;
+            const auto p_value = result.model[j * num_vars + l] == Glucose::l_True;
+            const auto q_value = result.model[num_vars * k + j * num_vars + l] == Glucose::l_True;
 
             /* do not consider all possibilities for canceled cubes */
             if ( p_value && q_value )
             {
-              constraints->add_clause( {int( -( 1 + vs[j] * num_vars + l ) ), int( -( 1 + num_vars * k + vs[j] * num_vars + l ) )} );
+              for ( auto i = 0u; i < k; ++i )
+              {
+                constraints->add_clause( {int( -( 1 + i * num_vars + l ) ), int( -( 1 + num_vars * k + i * num_vars + l ) )} );
+              }
               continue;
             }
 
-            blocking_clause.push_back( p_value ? -( 1 + vs[j] * num_vars + l ) : ( 1 + vs[j] * num_vars + l ) );
-            blocking_clause.push_back( q_value ? -( 1 + num_vars * k + vs[j] * num_vars + l ) : ( 1 + num_vars * k + vs[j] * num_vars + l ) );
+            blocking_clause.push_back( p_value ? -( 1 + j * num_vars + l ) : ( 1 + j * num_vars + l ) );
+            blocking_clause.push_back( q_value ? -( 1 + num_vars * k + j * num_vars + l ) : ( 1 + num_vars * k + j * num_vars + l ) );
           }
         }
         constraints->add_clause( blocking_clause );
-      } while ( std::next_permutation( vs.begin(), vs.end() ) );
+      }
+      else
+      {
+        /* add one blocking clause for each possible permutation of the cubes */
+        do
+        {
+          std::vector<int> blocking_clause;
+          for ( auto j = 0u; j < vs.size(); ++j )
+          {
+            for ( auto l = 0u; l < num_vars; ++l )
+            {
+              const auto p_value = result.model[j * num_vars + l] == Glucose::l_True;
+              const auto q_value = result.model[num_vars * k + j * num_vars + l] == Glucose::l_True;
+
+              /* do not consider all possibilities for canceled cubes */
+              if ( p_value && q_value )
+              {
+                constraints->add_clause( {int( -( 1 + vs[j] * num_vars + l ) ), int( -( 1 + num_vars * k + vs[j] * num_vars + l ) )} );
+                continue;
+              }
+
+              blocking_clause.push_back( p_value ? -( 1 + vs[j] * num_vars + l ) : ( 1 + vs[j] * num_vars + l ) );
+              blocking_clause.push_back( q_value ? -( 1 + num_vars * k + vs[j] * num_vars + l ) : ( 1 + num_vars * k + vs[j] * num_vars + l ) );
+            }
+          }
+          constraints->add_clause( blocking_clause );
+        } while ( std::next_permutation( vs.begin(), vs.end() ) );
+      }
 
       if ( esop.size() < k )
         continue;
       esops.push_back( esop );
     }
 
+    if ( params.cegar )
+    {
+      _stats["cegar_iterations"] = cegar_iterations + encoder->num_iterations();
+      _stats["sample_size"] = encoder->sample_size();
+    }
+
     return esops;
   }
 
@@ -835,6 +1183,23 @@ private:
     return detail::esop_from_model( model, num_terms, num_vars );
   }
 
+  /*! \brief add_minterm_constraints
+   *
+   * Encodes all care minterms of the specification for k terms.
+   *
+   * \param constraints Constraints
+   * \param sid Next free variable id
+   * \param num_vars Number of variables
+   * \param k Number of terms
+   */
+  void add_minterm_constraints( sat::constraints& constraints, int& sid, uint32_t num_vars, uint32_t k )
+  {
+    detail::add_care_minterms( constraints, sid, _spec, num_vars, k );
+
+    sat::gauss_elimination().apply( constraints );
+    sat::xor_clauses_to_cnf( sid ).apply( constraints );
+  }
+
 private:
   const spec _spec;
   nlohmann::json _stats;
@@ -0,0 +1,329 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file wide_cube.hpp
+  \brief Cubes with more than 32 variables
+
+  \author Heinz Riener
+*/
+
+#pragma once
+
+#include <kitty/cube.hpp>
+#include <kitty/hash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace easy::esop
+{
+
+/*! \brief Cube over `NumVars` variables
+ *
+ * Same interface as `kitty::cube` with the bits and the mask stored in
+ * 64-bit words.  `NumVars` must be a multiple of 64; if it is 0, the
+ * number of words is determined at runtime (see `dynamic_cube`), and
+ * the operations require cubes of the same width.
+ */
+template<uint32_t NumVars>
+class wide_cube
+{
+  static_assert( NumVars % 64u == 0u, "number of variables must be a multiple of 64" );
+
+public:
+  using words_type = std::conditional_t<NumVars == 0u, std::vector<uint64_t>, std::array<uint64_t, NumVars / 64u>>;
+
+public:
+  /*! \brief Constructs the empty cube */
+  wide_cube()
+  {
+    clear();
+  }
+
+  /*! \brief Constructs the empty cube over `num_vars` variables */
+  explicit wide_cube( uint32_t num_vars )
+  {
+    if constexpr ( NumVars == 0u )
+    {
+      _bits.resize( ( num_vars + 63u ) / 64u );
+      _mask.resize( _bits.size() );
+    }
+    else
+    {
+      assert( num_vars <= NumVars );
+      (void)num_vars;
+    }
+    clear();
+  }
+
+  /*! \brief Constructs a cube from a string
+   *
+   * Each character corresponds to one literal in the cube: '1' is a
+   * positive literal, '0' a negative literal, and all other
+   * characters are don't cares.
+   */
+  wide_cube( std::string const& str ) /* NOLINT */
+      : wide_cube( uint32_t( str.size() ) )
+  {
+    assert( str.size() <= num_vars() );
+    for ( auto i = 0u; i < str.size(); ++i )
+    {
+      if ( str[i] == '0' || str[i] == '1' )
+      {
+        add_literal( i, str[i] == '1' );
+      }
+    }
+  }
+
+  /*! \brief Constructs a cube from a 32-bit cube */
+  explicit wide_cube( kitty::cube const& c, uint32_t n = NumVars == 0u ? 32u : NumVars )
+      : wide_cube( n )
+  {
+    assert( num_vars() >= 32u );
+    _bits[0] = c._bits;
+    _mask[0] = c._mask;
+  }
+
+  /*! \brief Returns the number of variables */
+  uint32_t num_vars() const
+  {
+    return uint32_t( _bits.size() ) * 64u;
+  }
+
+  /*! \brief Returns number of literals */
+  int num_literals() const
+  {
+    auto count = 0;
+    for ( const auto& w : _mask )
+    {
+      count += __builtin_popcountll( w );
+    }
+    return count;
+  }
+
+  /*! \brief Returns the difference to another cube */
+  words_type difference( wide_cube const& that ) const
+  {
+    assert( _bits.size() == that._bits.size() );
+    auto diff = _bits;
+    for ( auto i = 0u; i < diff.size(); ++i )
+    {
+      diff[i] = ( _bits[i] ^ that._bits[i] ) | ( _mask[i] ^ that._mask[i] );
+    }
+    return diff;
+  }
+
+  /*! \brief Returns the distance to another cube */
+  int distance( wide_cube const& that ) const
+  {
+    assert( _bits.size() == that._bits.size() );
+    auto count = 0;
+    for ( auto i = 0u; i < _bits.size(); ++i )
+    {
+      count += __builtin_popcountll( ( _bits[i] ^ that._bits[i] ) | ( _mask[i] ^ that._mask[i] ) );
+    }
+    return count;
+  }
+
+  /*! \brief Calls `fn( var_index )` for each variable in which the cubes differ */
+  template<typename Fn>
+  void foreach_difference( wide_cube const& that, Fn&& fn ) const
+  {
+    assert( _bits.size() == that._bits.size() );
+    for ( auto i = 0u; i < _bits.size(); ++i )
+    {
+      auto d = ( _bits[i] ^ that._bits[i] ) | ( _mask[i] ^ that._mask[i] );
+      while ( d )
+      {
+        fn( uint32_t( i * 64u + __builtin_ctzll( d ) ) );
+        d &= d - 1u;
+      }
+    }
+  }
+
+  /*! \brief Checks whether two cubes are equivalent */
+  bool operator==( wide_cube const& that ) const
+  {
+    return _bits == that._bits && _mask == that._mask;
+  }
+
+  /*! \brief Checks whether two cubes are not equivalent */
+  bool operator!=( wide_cube const& that ) const
+  {
+    return !( *this == that );
+  }
+
+  /*! \brief Default comparison operator */
+  bool operator<( wide_cube const& that ) const
+  {
+    return std::tie( _mask, _bits ) < std::tie( that._mask, that._bits );
+  }
+
+  /*! \brief Merges two cubes of distance-1 */
+  wide_cube merge( wide_cube const& that ) const
+  {
+    auto result = *this;
+    for ( auto i = 0u; i < _bits.size(); ++i )
+    {
+      auto const d = ( _bits[i] ^ that._bits[i] ) | ( _mask[i] ^ that._mask[i] );
+      result._bits[i] = _bits[i] ^ ( ~that._bits[i] & d );
+      result._mask[i] = _mask[i] ^ ( that._mask[i] & d );
+    }
+    return result;
+  }
+
+  /*! \brief Adds literal to cube */
+  void add_literal( uint32_t var_index, bool polarity = true )
+  {
+    set_mask( var_index );
+    if ( polarity )
+    {
+      set_bit( var_index );
+    }
+    else
+    {
+      clear_bit( var_index );
+    }
+  }
+
+  /*! \brief Removes literal from cube */
+  void remove_literal( uint32_t var_index )
+  {
+    clear_mask( var_index );
+    clear_bit( var_index );
+  }
+
+  /*! \brief Prints a cube */
+  void print( unsigned length, std::ostream& os = std::cout ) const
+  {
+    for ( auto i = 0u; i < length; ++i )
+    {
+      os << ( get_mask( i ) ? ( get_bit( i ) ? '1' : '0' ) : '-' );
+    }
+  }
+
+  /*! \brief Gets bit at index */
+  bool get_bit( uint32_t index ) const
+  {
+    return ( ( _bits[index >> 6] >> ( index & 63u ) ) & 1u ) != 0u;
+  }
+
+  /*! \brief Gets mask at index */
+  bool get_mask( uint32_t index ) const
+  {
+    return ( ( _mask[index >> 6] >> ( index & 63u ) ) & 1u ) != 0u;
+  }
+
+  /*! \brief Sets bit at index */
+  void set_bit( uint32_t index )
+  {
+    _bits[index >> 6] |= uint64_t( 1 ) << ( index & 63u );
+  }
+
+  /*! \brief Sets mask at index */
+  void set_mask( uint32_t index )
+  {
+    _mask[index >> 6] |= uint64_t( 1 ) << ( index & 63u );
+  }
+
+  /*! \brief Clears bit at index */
+  void clear_bit( uint32_t index )
+  {
+    _bits[index >> 6] &= ~( uint64_t( 1 ) << ( index & 63u ) );
+  }
+
+  /*! \brief Clears mask at index */
+  void clear_mask( uint32_t index )
+  {
+    _mask[index >> 6] &= ~( uint64_t( 1 ) << ( index & 63u ) );
+  }
+
+  /*! \brief Flips bit at index */
+  void flip_bit( uint32_t index )
+  {
+    _bits[index >> 6] ^= uint64_t( 1 ) << ( index & 63u );
+  }
+
+  /*! \brief Flips mask at index */
+  void flip_mask( uint32_t index )
+  {
+    _mask[index >> 6] ^= uint64_t( 1 ) << ( index & 63u );
+  }
+
+private:
+  void clear()
+  {
+    std::fill( _bits.begin(), _bits.end(), 0u );
+    std::fill( _mask.begin(), _mask.end(), 0u );
+  }
+
+public:
+  /* cube data */
+  words_type _bits;
+  words_type _mask;
+}; /* wide_cube */
+
+using cube64 = wide_cube<64u>;
+using cube128 = wide_cube<128u>;
+using cube256 = wide_cube<256u>;
+using dynamic_cube = wide_cube<0u>;
+
+} /* namespace easy::esop */
+
+namespace kitty
+{
+
+/*! \cond PRIVATE */
+template<uint32_t NumVars>
+struct hash<easy::esop::wide_cube<NumVars>>
+{
+  std::size_t operator()( easy::esop::wide_cube<NumVars> const& c ) const
+  {
+    std::size_t seed = 0u;
+    for ( auto i = 0u; i < c._bits.size(); ++i )
+    {
+      hash_combine( seed, hash_block( c._bits[i] ) );
+      hash_combine( seed, hash_block( c._mask[i] ) );
+    }
+    return seed;
+  }
+};
+/*! \endcond */
+
+} /* namespace kitty */
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -33,13 +33,15 @@ namespace easy
 
 /*! \brief lorina reader callback for PLA files
  *
- * Reads a PLA file and stores the terms as esop_t.
+ * Reads a PLA file and stores the terms as esop_t, or as ESOP form
+ * over wide cubes for more than 32 inputs.
  *
  */
+template<typename Cube = kitty::cube>
 class esop_storage_reader : public lorina::pla_reader
 {
 public:
-  esop_storage_reader( esop::esop_t& esop, unsigned& num_vars )
+  esop_storage_reader( esop::basic_esop_t<Cube>& esop, unsigned& num_vars )
       : _esop( esop ), _num_vars( num_vars )
   {
   }
@@ -64,7 +66,7 @@ public:
     return false;
   }
 
-  esop::esop_t& _esop;
+  esop::basic_esop_t<Cube>& _esop;
   unsigned& _num_vars;
 }; /* esop_storage_reader */
 
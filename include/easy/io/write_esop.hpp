@@ -39,7 +39,8 @@ namespace easy
  * \param esop ESOP form
  * \param num_vars Number of variables
  */
-inline void write_esop( std::ostream& os, esop::esop_t const& esop, unsigned num_vars )
+template<typename Cube>
+inline void write_esop( std::ostream& os, esop::basic_esop_t<Cube> const& esop, unsigned num_vars )
 {
   lorina::pla_writer writer( os );
   writer.on_number_of_inputs( num_vars );
@@ -61,7 +62,8 @@ inline void write_esop( std::ostream& os, esop::esop_t const& esop, unsigned num
  * \param esop ESOP form
  * \param num_vars Number of variables
  */
-inline void write_esop( std::string const& filename, esop::esop_t const& esop, unsigned num_vars )
+template<typename Cube>
+inline void write_esop( std::string const& filename, esop::basic_esop_t<Cube> const& esop, unsigned num_vars )
 {
   std::ofstream os( filename.c_str(), std::ofstream::out );
   write_esop( os, esop, num_vars );
@@ -0,0 +1,142 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <easy/sat/sat_solver.hpp>
+#include <cmath>
+
+namespace easy::sat
+{
+
+/*! \brief Symmetry breaking for the p/q encoding of ESOP synthesis
+ *
+ * The terms of a k-ESOP are encoded by the variables p_j,l (at
+ * 1 + n*j + l) and q_j,l (at 1 + n*k + n*j + l) for j = 0, ..., k-1
+ * and l = 0, ..., n-1.  Any permutation of the terms yields the same
+ * ESOP.  This stage adds clauses that require the term vectors
+ * (p_j, q_j) to be in strict lexicographic order, such that only one
+ * of the k! permutations remains.
+ *
+ * Canceled terms (p_j,l = q_j,l = 1 for some l) have 4^n - 3^n
+ * distinct encodings, hence at most that many terms may be canceled.
+ *
+ * Optionally, an activation literal per term can be passed.  The
+ * order between term j and j+1 is then only enforced if term j+1 is
+ * active, which allows to disable a suffix of the terms with
+ * assumptions.
+ */
+class cnf_symmetry_breaking
+{
+public:
+  cnf_symmetry_breaking( int& sid, uint32_t num_vars, uint32_t num_terms, std::vector<int> const& activation = {} )
+      : _sid( sid )
+      , _num_vars( num_vars )
+      , _num_terms( num_terms )
+      , _activation( activation )
+  {
+    assert( _activation.empty() || _activation.size() == _num_terms );
+    assert( ( _num_vars > 1 || _num_terms <= 1 ) && "strict ordering requires at least two variables" );
+    assert( ( _num_vars > 4 || _num_terms <= std::pow( 4, _num_vars ) - std::pow( 3, _num_vars ) ) && "too many terms for strict ordering" );
+  }
+
+  inline void apply( constraints& constraints )
+  {
+    for ( auto j = 1u; j < _num_terms; ++j )
+    {
+      add_lex_less( constraints, term_vector( j - 1 ), term_vector( j ), _activation.empty() ? 0 : _activation[j] );
+    }
+  }
+
+protected:
+  /* returns the variables p_j,0, ..., p_j,n-1, q_j,0, ..., q_j,n-1 */
+  inline std::vector<int> term_vector( uint32_t j ) const
+  {
+    std::vector<int> v( 2 * _num_vars );
+    for ( auto l = 0u; l < _num_vars; ++l )
+    {
+      v[l] = 1 + _num_vars * j + l;
+      v[_num_vars + l] = 1 + _num_vars * _num_terms + _num_vars * j + l;
+    }
+    return v;
+  }
+
+  /* a <_lex b (guarded by act, if act != 0)
+   *
+   * e_i denotes that the first i positions of a and b are equal,
+   * e_0 is true and e_m must be false. */
+  inline void add_lex_less( constraints& constraints, std::vector<int> const& a, std::vector<int> const& b, int act )
+  {
+    auto guarded = [act]( std::vector<int> clause ) {
+      if ( act != 0 )
+      {
+        clause.push_back( -act );
+      }
+      return clause;
+    };
+
+    int e = 0; /* 0 denotes the constant true */
+    for ( auto i = 0u; i < a.size(); ++i )
+    {
+      const int e_next = _sid++;
+
+      std::vector<int> le = {-a[i], b[i]};
+      std::vector<int> eq1 = {-a[i], -b[i], e_next};
+      std::vector<int> eq0 = {a[i], b[i], e_next};
+      if ( e != 0 )
+      {
+        le.push_back( -e );
+        eq1.push_back( -e );
+        eq0.push_back( -e );
+      }
+
+      /* e_i -> a_i <= b_i */
+      constraints.add_clause( guarded( le ) );
+
+      /* e_i & ( a_i == b_i ) -> e_i+1 */
+      constraints.add_clause( eq1 );
+      constraints.add_clause( eq0 );
+
+      e = e_next;
+    }
+
+    /* strict: not all positions equal */
+    constraints.add_clause( guarded( {-e} ) );
+  }
+
+protected:
+  int& _sid;
+  uint32_t _num_vars;
+  uint32_t _num_terms;
+  std::vector<int> _activation;
+}; /* cnf_symmetry_breaking */
+
+} // namespace easy::sat
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -26,10 +26,18 @@
 #pragma once
 
 #include <easy/sat/sat_solver.hpp>
+#include <easy/utils/gf2_matrix.hpp>
 
 namespace easy::sat
 {
 
+/*! \brief Gauss-Jordan elimination of XOR-clauses
+ *
+ * Replaces the XOR-clauses by an equivalent system in reduced row
+ * echelon form.  Variables with fewer occurrences are preferred as
+ * pivots, which avoids fill-in for the sparse systems that arise
+ * from ESOP synthesis.
+ */
 class gauss_elimination
 {
 public:
@@ -38,110 +46,89 @@ public:
   bool apply( constraints& constraints )
   {
     auto A = make_matrix( constraints );
-    matrix_make_upper_triangular_binary( A );
+    auto const num_pivot_cols = A.num_cols() - 1u;
+    auto const rank = A.reduced_row_echelon_form( num_pivot_cols ).size();
 
     /* reconstruct xor_clauses */
     constraints.clear_xor_clauses();
 
-    for ( const auto& row : A )
+    for ( auto r = 0u; r < A.num_rows(); ++r )
     {
-      std::vector<int> clause;
-      for ( auto i = 0; i < int( row.size() - 1u ); ++i )
+      bool const value = A.get( r, num_pivot_cols );
+      if ( r >= rank )
       {
-        if ( row[i] )
+        if ( value )
         {
-          clause.push_back( i + 1 );
+          constraints.clear_clauses();
+          constraints.add_clause( {  1 } );
+          constraints.add_clause( { -1 } );
+          return true;
         }
+        continue;
       }
 
-      if ( clause.empty() && row[ row.size() - 1u ] )
-      {
-        constraints.clear_clauses();
-        constraints.add_clause( {  1 } );
-        constraints.add_clause( { -1 } );
-        return true;
-      }
-      else if ( !clause.empty() )
-      {
-        constraints.add_weighted_xor_clause( sat::wclause_t{clause, 0u}, row[row.size() - 1u] );
-      }
+      std::vector<int> clause;
+      A.foreach_one( r, [&]( uint32_t col ){
+          if ( col < num_pivot_cols )
+          {
+            clause.push_back( _col_to_var[col] );
+          }
+        });
+      constraints.add_weighted_xor_clause( sat::wclause_t{clause, 0u}, value );
     }
 
     return false;
   }
 
 protected:
-  inline std::vector<std::vector<bool>> make_matrix( const constraints& constraints )
+  inline utils::gf2_matrix make_matrix( const constraints& constraints )
   {
-    auto num_variables = constraints.num_variables();
-    std::vector<std::vector<bool>> matrix;
+    /* order columns by number of occurrences */
+    std::vector<uint32_t> occurrences( constraints.num_variables() + 1u, 0u );
+    auto num_rows = 0u;
     constraints.foreach_xor_clause( [&]( xor_clause_t const& cl ){
-        std::vector<bool> row( num_variables + 1 );
-        auto sum = 0u;
         for ( const auto& l : cl.clause )
         {
-          row[abs( l ) - 1] = 1;
-          sum += l < 0;
+          ++occurrences[abs( l )];
         }
-        sum += cl.value;
-        row[row.size() - 1] = sum % 2;
-        matrix.emplace_back( row );
+        ++num_rows;
       });
-    return matrix;
-  }
 
-  inline void matrix_make_upper_triangular_binary( std::vector<std::vector<bool>>& A )
-  {
-    const auto num_rows = A.size();
-    auto index = 0u;
-    for ( auto i = 0u; i < num_rows; ++i )
+    _col_to_var.clear();
+    for ( auto v = 1u; v < occurrences.size(); ++v )
     {
-      /* find next row */
-      auto next_row = i;
-      if ( !A[i][index] )
+      if ( occurrences[v] > 0u )
       {
-        for ( auto k = i + 1; k < num_rows; ++k )
-        {
-          if ( A[k][index] )
-          {
-            next_row = k;
-          }
-        }
-
-        if ( !A[next_row][i] )
-        {
-          ++index;
-          continue;
-        }
+        _col_to_var.push_back( v );
       }
+    }
+    std::stable_sort( _col_to_var.begin(), _col_to_var.end(), [&]( int a, int b ){ return occurrences[a] < occurrences[b]; } );
 
-      /* swap current i and next_row */
-      if ( next_row != i )
-      {
-        // std::cout << "swap " << i << " and " << next_row << std::endl;
-        for ( auto j = 0u; j < A[i].size(); ++j )
-        {
-          bool temp = A[i][j];
-          A[i][j] = A[next_row][j];
-          A[next_row][j] = temp;
-        }
-      }
+    std::vector<uint32_t> var_to_col( occurrences.size() );
+    for ( auto i = 0u; i < _col_to_var.size(); ++i )
+    {
+      var_to_col[_col_to_var[i]] = i;
+    }
 
-      // add current row to all other rows
-      for ( auto k = i + 1; k < num_rows; ++k )
-      {
-        if ( !A[k][index] )
-          continue;
-        // std::cout << "add " << i << " to " << k << std::endl;
-        for ( auto j = 0u; j < A[k].size(); ++j )
+    /* the last column is the right-hand side */
+    utils::gf2_matrix matrix( num_rows, _col_to_var.size() + 1u );
+    auto r = 0u;
+    constraints.foreach_xor_clause( [&]( xor_clause_t const& cl ){
+        auto sum = 0u;
+        for ( const auto& l : cl.clause )
         {
-          A[k][j] = A[k][j] ^ ( A[i][j] );
+          matrix.flip( r, var_to_col[abs( l )] );
+          sum += l < 0;
         }
-      }
-
-      ++index;
-    }
+        sum += cl.value;
+        matrix.set( r, _col_to_var.size(), sum % 2 );
+        ++r;
+      });
+    return matrix;
   }
+
+protected:
+  std::vector<int> _col_to_var;
 }; /* gauss_elimination */
 
 } // namespace easy::sat
@@ -26,7 +26,11 @@
 #pragma once
 
 #include <easy/sat/constraints.hpp>
+#include <easy/sat2/portfolio.hpp>
+#include <easy/sat2/xor_propagator.hpp>
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -66,14 +70,35 @@ struct sat_solver
   void reset();
 
   void set_conflict_limit( int limit );
+  void set_conflict_budget_per_call( int budget );
+  void set_native_xor( bool native_xor );
+  void set_portfolio( std::vector<sat2::portfolio_solver_config> const& configs );
+  sat2::portfolio_statistics const& get_portfolio_statistics() const;
   int get_conflicts() const;
+  int get_num_learnts() const;
 
   unsigned _num_vars = 0;
 
   /* -1 indicates no conflict limit */
   int _conflict_limit = -1;
 
+  /* conflicts available to each call to solve, -1 indicates no budget */
+  int _conflict_budget_per_call = -1;
+
+  /* if true, xor clauses are propagated natively instead of requiring a CNF translation */
+  bool _native_xor = false;
+
   std::unique_ptr<Glucose::Solver> _solver;
+  std::unique_ptr<sat2::xor_propagator> _xor;
+
+  /* if non-empty, the configured solvers race instead of Glucose */
+  std::vector<sat2::portfolio_solver_config> _portfolio_configs;
+  sat2::portfolio_statistics _portfolio_stats;
+  std::unique_ptr<sat2::portfolio_solver> _portfolio;
+
+protected:
+  result solve_portfolio( constraints& constraints, const assumptions_t& assumptions );
+  int64_t conflict_budget( int64_t conflicts ) const;
 };
 
 inline sat_solver::sat_solver()
@@ -84,6 +109,11 @@ inline sat_solver::sat_solver()
 inline void sat_solver::reset()
 {
   _solver = std::make_unique<Glucose::Solver>();
+  _xor.reset();
+  if ( _portfolio )
+  {
+    _portfolio = std::make_unique<sat2::portfolio_solver>( _portfolio_configs, _portfolio_stats );
+  }
   _num_vars = 0;
   _solver->budgetOff();
 }
@@ -94,13 +124,125 @@ inline void sat_solver::set_conflict_limit( int limit )
   _solver->setConfBudget( limit );
 }
 
+/*! \brief Limits the conflicts of each call to solve
+ *
+ * Unlike set_conflict_limit, which bounds the conflicts over the
+ * lifetime of the solver, every call starts with a fresh budget.
+ * Both limits can be combined.
+ */
+inline void sat_solver::set_conflict_budget_per_call( int budget )
+{
+  _conflict_budget_per_call = budget;
+}
+
+/* conflicts available to the next call, given the conflicts so far (-1 if unlimited) */
+inline int64_t sat_solver::conflict_budget( int64_t conflicts ) const
+{
+  int64_t budget = _conflict_budget_per_call;
+  if ( _conflict_limit != -1 )
+  {
+    auto const remaining = std::max<int64_t>( int64_t( _conflict_limit ) - conflicts, 0 );
+    budget = budget == -1 ? remaining : std::min( budget, remaining );
+  }
+  return budget;
+}
+
+inline void sat_solver::set_native_xor( bool native_xor )
+{
+  _native_xor = native_xor;
+}
+
+/*! \brief Races the given solvers on separate threads instead of using Glucose
+ *
+ * XOR-clauses are translated into clauses (see sat2::portfolio_solver).
+ */
+inline void sat_solver::set_portfolio( std::vector<sat2::portfolio_solver_config> const& configs )
+{
+  _portfolio_configs = configs;
+  _portfolio = configs.empty() ? nullptr : std::make_unique<sat2::portfolio_solver>( _portfolio_configs, _portfolio_stats );
+}
+
+inline sat2::portfolio_statistics const& sat_solver::get_portfolio_statistics() const
+{
+  return _portfolio_stats;
+}
+
 inline int sat_solver::get_conflicts() const
 {
+  if ( _portfolio )
+  {
+    return _portfolio->num_conflicts();
+  }
   return _solver->conflicts;
 }
 
+/*! \brief Number of learnt clauses of Glucose
+ *
+ * Returns 0 with a portfolio, whose solvers keep their learnt clauses
+ * to themselves.
+ */
+inline int sat_solver::get_num_learnts() const
+{
+  if ( _portfolio )
+  {
+    return 0;
+  }
+  return _solver->nLearnts();
+}
+
+inline sat_solver::result sat_solver::solve_portfolio( constraints& constraints, const assumptions_t& assumptions )
+{
+  auto const update_num_vars = [&]( std::vector<int> const& lits ) {
+    for ( const auto& l : lits )
+    {
+      _num_vars = std::max( _num_vars, unsigned( abs( l ) ) );
+    }
+  };
+
+  constraints.foreach_clause( [&]( constraints::clause_t const& c ){
+      update_num_vars( c );
+      _portfolio->add_clause( c );
+    });
+  constraints.clear_clauses();
+
+  constraints.foreach_xor_clause( [&]( xor_clause_t const& c ){
+      update_num_vars( c.clause );
+      _portfolio->add_xor_clause( c.clause, c.value );
+    });
+  constraints.clear_xor_clauses();
+
+  update_num_vars( assumptions );
+  auto const budget = conflict_budget( _portfolio->num_conflicts() );
+  if ( budget == 0 )
+  {
+    return result( Glucose::l_Undef );
+  }
+  switch ( _portfolio->solve( assumptions, budget ) )
+  {
+  case sat2::portfolio_solver::state::sat:
+    {
+      auto const m = _portfolio->get_model();
+      model_t model( _num_vars, Glucose::l_False );
+      for ( auto i = 0u; i < m.size(); ++i )
+      {
+        model[i] = m[i] ? Glucose::l_True : Glucose::l_False;
+      }
+      return result( model );
+    }
+  case sat2::portfolio_solver::state::unsat:
+    return result( Glucose::l_False );
+  default:
+    return result( Glucose::l_Undef );
+  }
+}
+
 inline sat_solver::result sat_solver::solve( constraints& constraints, const assumptions_t& assumptions )
 {
+  if ( _portfolio )
+  {
+    return solve_portfolio( constraints, assumptions );
+  }
+
   /* add clauses to solver & remove them from constraints */
   constraints.foreach_clause( [&]( constraints::clause_t const& c ){
       Glucose::vec<Glucose::Lit> clause;
@@ -119,7 +261,42 @@ inline sat_solver::result sat_solver::solve( constraints& constraints, const ass
   constraints.clear_clauses();
 
   /* add xor clauses to solver & remove them from constraints */
-  assert( constraints.num_xor_clauses() == 0u );
+  assert( _native_xor || constraints.num_xor_clauses() == 0u );
+  if ( constraints.num_xor_clauses() > 0u )
+  {
+    if ( !_xor )
+    {
+      _xor = std::make_unique<sat2::xor_propagator>();
+    }
+
+    constraints.foreach_xor_clause( [&]( xor_clause_t const& c ){
+        for ( const auto& l : c.clause )
+        {
+          const unsigned var = abs( l ) - 1;
+          while ( _num_vars <= var )
+          {
+            _solver->newVar();
+            ++_num_vars;
+          }
+        }
+        _xor->add_xor_clause( c.clause, c.value );
+      });
+    constraints.clear_xor_clauses();
+
+    std::vector<int> units;
+    if ( !_xor->build( units ) )
+    {
+      _solver->addEmptyClause();
+    }
+    else
+    {
+      for ( const auto& l : units )
+      {
+        _solver->addClause( Glucose::mkLit( abs( l ) - 1, l < 0 ) );
+      }
+      _solver->setExternalPropagator( _xor->num_rows() > 0 ? _xor.get() : nullptr );
+    }
+  }
 
   bool sat;
 
@@ -138,14 +315,24 @@ inline sat_solver::result sat_solver::solve( constraints& constraints, const ass
     }
   }
 
-  if ( _conflict_limit == -1 )
+  if ( _conflict_limit == -1 && _conflict_budget_per_call == -1 )
   {
     sat = _solver->solve( assume );
   }
   else
   {
+    const auto conflicts_before = _solver->conflicts;
+    const auto budget = conflict_budget( conflicts_before );
+    if ( budget == 0 )
+    {
+      return result( Glucose::l_Undef );
+    }
+    _solver->setConfBudget( budget );
+
     const auto solver_result = _solver->solveLimited( assume );
-    if ( solver_result == Glucose::l_Undef || int32_t(_solver->conflicts) >= _conflict_limit )
+    if ( solver_result == Glucose::l_Undef ||
+         ( _conflict_limit != -1 && int32_t( _solver->conflicts ) >= _conflict_limit ) ||
+         ( _conflict_budget_per_call != -1 && int32_t( _solver->conflicts - conflicts_before ) >= _conflict_budget_per_call ) )
     {
       return result( Glucose::l_Undef );
     }
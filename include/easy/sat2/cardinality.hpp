@@ -25,22 +25,48 @@
 
 /*!
   \file cardinality.hpp
-  \brief Iterative totalizer cardinality constraints
+  \brief Cardinality constraints
 
   \author Heinz Riener
 
-  This implementation is based on the code of Antonio Morgado and
-  Alexey S. Ignatiev in [1]. For a seminal reference, see [2].
+  The iterative totalizer is based on the code of Antonio Morgado and
+  Alexey S. Ignatiev in [1]. For a seminal reference, see [2].  The
+  sequential counter, the cardinality network, the modulo totalizer,
+  and the generalized totalizer follow [3], [4], [5], and [6],
+  respectively.
 
   [1] https://github.com/pysathq/pysat/blob/master/cardenc/itot.hh.
 
   [2] Ruben Martins, Saurabh Joshi, Vasco M. Manquinho, Inês Lynce:
   Incremental Cardinality Constraints for MaxSAT. CP 2014: 531-548
+
+  [3] Carsten Sinz: Towards an Optimal CNF Encoding of Boolean
+  Cardinality Constraints. CP 2005: 827-831
+
+  [4] Roberto Asín, Robert Nieuwenhuis, Albert Oliveras, Enric
+  Rodríguez-Carbonell: Cardinality Networks: a theoretical and
+  empirical study. Constraints 16(2): 195-221 (2011)
+
+  [5] Toru Ogawa, Yangyang Liu, Ryuzo Hasegawa, Miyuki Koshimura,
+  Hiroshi Fujita: Modulo Based CNF Encoding of Cardinality Constraints
+  and Its Application to MaxSAT Solvers. ICTAI 2013: 9-17
+
+  [6] Saurabh Joshi, Ruben Martins, Vasco M. Manquinho: Generalized
+  Totalizer Encoding for Pseudo-Boolean Constraints. CP 2015: 200-209
 */
 
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <deque>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace easy::sat2
 {
@@ -201,4 +227,778 @@ inline std::shared_ptr<totalizer_tree> extend_totalizer( std::vector<std::vector
   return merge_totalizer( dest, sid, ta, tb, rhs );
 }
 
+
+/*! \brief Encodings of cardinality constraints */
+enum class cardinality_encoding
+{
+  totalizer = 0, /* [2], O(n*k) clauses */
+  sequential_counter = 1, /* [3], O(n*k) clauses */
+  cardinality_network = 2, /* [4], O(n*log^2(k)) clauses */
+  modulo_totalizer = 3, /* [5], O(n*sqrt(k)) clauses */
+  automatic = 4, /* smallest encoding (see select_cardinality_encoding) */
+}; /* cardinality_encoding */
+
+/*! \brief Outputs of a cardinality constraint
+ *
+ * Counts the true literals among `num_inputs` literals.  The outputs
+ * bound the count by any k <= rhs (see bound_cardinality_constraint).
+ *
+ * In the totalizer, the sequential counter, and the cardinality
+ * network, vars[j] is true if at least j+1 inputs are true.  The
+ * modulo totalizer represents the count as q*modulo + r with upper[j]
+ * true if q >= j+1 and lower[j] true if r >= j+1.
+ *
+ * All encodings only propagate from the inputs to the outputs, which
+ * suffices for upper bounds.
+ */
+struct cardinality_constraint
+{
+  cardinality_encoding encoding{cardinality_encoding::totalizer};
+  uint32_t num_inputs{0};
+  uint32_t rhs{0};
+  std::vector<int> vars;
+  uint32_t modulo{0};
+  std::vector<int> upper;
+  std::vector<int> lower;
+}; /* cardinality_constraint */
+
+/*! \brief Size of an encoding */
+struct cardinality_encoding_size
+{
+  uint64_t clauses{0};
+  uint64_t variables{0};
+}; /* cardinality_encoding_size */
+
+namespace detail
+{
+
+inline std::vector<int> create_sequential_counter( std::vector<std::vector<int>>& dest, int& sid, std::vector<int> const& lhs, uint32_t rhs )
+{
+  if ( lhs.empty() )
+  {
+    return {};
+  }
+
+  /* r[j] is true if at least j+1 of the first i+1 inputs are true */
+  uint32_t const m = std::min( rhs + 1u, uint32_t( lhs.size() ) );
+  std::vector<int> r{ lhs[0] };
+  for ( auto i = 1u; i < lhs.size(); ++i )
+  {
+    std::vector<int> s( std::min( i + 1u, m ) );
+    for ( auto& v : s )
+    {
+      v = sid++;
+    }
+
+    dest.emplace_back( std::vector<int>{ -lhs[i], s[0] } );
+    for ( auto j = 0u; j < r.size(); ++j )
+    {
+      dest.emplace_back( std::vector<int>{ -r[j], s[j] } );
+    }
+    for ( auto j = 1u; j < s.size(); ++j )
+    {
+      dest.emplace_back( std::vector<int>{ -lhs[i], -r[j - 1u], s[j] } );
+    }
+    r = s;
+  }
+  return r;
+}
+
+/* half comparator (0 denotes the constant false) */
+inline std::pair<int, int> half_comparator( std::vector<std::vector<int>>& dest, int& sid, int a, int b )
+{
+  if ( a == 0 )
+  {
+    return { b, 0 };
+  }
+  if ( b == 0 )
+  {
+    return { a, 0 };
+  }
+
+  int const max = sid++;
+  int const min = sid++;
+  dest.emplace_back( std::vector<int>{ -a, max } );
+  dest.emplace_back( std::vector<int>{ -b, max } );
+  dest.emplace_back( std::vector<int>{ -a, -b, min } );
+  return { max, min };
+}
+
+/* elements at the even (offset 0) or odd (offset 1) positions */
+inline std::vector<int> interleaved_elements( std::vector<int> const& v, uint32_t offset )
+{
+  std::vector<int> result;
+  for ( auto i = offset; i < v.size(); i += 2u )
+  {
+    result.emplace_back( v[i] );
+  }
+  return result;
+}
+
+/* merges two sorted sequences if one of them is constant */
+inline std::vector<int> concatenate_sorted( std::vector<int> const& a, std::vector<int> const& b, uint32_t size )
+{
+  std::vector<int> c( a[0] == 0 ? b : a );
+  c.resize( size, 0 );
+  return c;
+}
+
+/* merges two sorted sequences of the same power-of-two length */
+inline std::vector<int> half_merge( std::vector<std::vector<int>>& dest, int& sid, std::vector<int> const& a, std::vector<int> const& b )
+{
+  auto const s = a.size();
+  if ( a[0] == 0 || b[0] == 0 )
+  {
+    return concatenate_sorted( a, b, 2u * s );
+  }
+  if ( s == 1u )
+  {
+    auto const [max, min] = half_comparator( dest, sid, a[0], b[0] );
+    return { max, min };
+  }
+
+  auto const d = half_merge( dest, sid, interleaved_elements( a, 0u ), interleaved_elements( b, 0u ) );
+  auto const e = half_merge( dest, sid, interleaved_elements( a, 1u ), interleaved_elements( b, 1u ) );
+
+  std::vector<int> c( 2u * s );
+  c[0] = d[0];
+  for ( auto i = 1u; i < s; ++i )
+  {
+    std::tie( c[2u * i - 1u], c[2u * i] ) = half_comparator( dest, sid, d[i], e[i - 1u] );
+  }
+  c[2u * s - 1u] = e[s - 1u];
+  return c;
+}
+
+/* sorts a sequence of power-of-two length */
+inline std::vector<int> half_sort( std::vector<std::vector<int>>& dest, int& sid, std::vector<int> const& a )
+{
+  if ( a.size() == 1u )
+  {
+    return a;
+  }
+
+  auto const h = a.size() / 2u;
+  auto const d = half_sort( dest, sid, std::vector<int>( a.begin(), a.begin() + h ) );
+  auto const e = half_sort( dest, sid, std::vector<int>( a.begin() + h, a.end() ) );
+  return half_merge( dest, sid, d, e );
+}
+
+/* merges two sorted sequences of the same power-of-two length s into the first s+1 outputs */
+inline std::vector<int> simplified_merge( std::vector<std::vector<int>>& dest, int& sid, std::vector<int> const& a, std::vector<int> const& b )
+{
+  auto const s = a.size();
+  if ( a[0] == 0 || b[0] == 0 )
+  {
+    return concatenate_sorted( a, b, s + 1u );
+  }
+  if ( s == 1u )
+  {
+    auto const [max, min] = half_comparator( dest, sid, a[0], b[0] );
+    return { max, min };
+  }
+
+  auto const d = simplified_merge( dest, sid, interleaved_elements( a, 0u ), interleaved_elements( b, 0u ) );
+  auto const e = simplified_merge( dest, sid, interleaved_elements( a, 1u ), interleaved_elements( b, 1u ) );
+
+  std::vector<int> c( s + 1u );
+  c[0] = d[0];
+  for ( auto i = 1u; i <= s / 2u; ++i )
+  {
+    std::tie( c[2u * i - 1u], c[2u * i] ) = half_comparator( dest, sid, d[i], e[i - 1u] );
+  }
+  return c;
+}
+
+/* first m sorted outputs of a sequence whose length is a multiple of m (a power of two) */
+inline std::vector<int> create_cardinality_network( std::vector<std::vector<int>>& dest, int& sid, std::vector<int> const& a, uint32_t m )
+{
+  if ( a.size() == m )
+  {
+    return half_sort( dest, sid, a );
+  }
+
+  auto const split = ( a.size() / m / 2u ) * m;
+  auto const d = create_cardinality_network( dest, sid, std::vector<int>( a.begin(), a.begin() + split ), m );
+  auto const e = create_cardinality_network( dest, sid, std::vector<int>( a.begin() + split, a.end() ), m );
+  auto c = simplified_merge( dest, sid, d, e );
+  c.pop_back();
+  return c;
+}
+
+/* smallest power of two that is at least n */
+inline uint32_t next_power_of_two( uint32_t n )
+{
+  uint32_t m = 1u;
+  while ( m < n )
+  {
+    m <<= 1u;
+  }
+  return m;
+}
+
+/* the sizes of the network functions follow the number of leading
+   non-constant elements (p) of the sorted sequences */
+
+/* comparators of d[i] and e[i-1] for i = 1..k; returns the non-constant outputs */
+inline uint64_t half_comparators_size( cardinality_encoding_size& size, uint64_t k, uint64_t pd, uint64_t pe )
+{
+  auto const both = pd == 0u ? 0u : std::min( { k, pd - 1u, pe } );
+  auto const either = std::min( k, std::max( pd == 0u ? 0u : pd - 1u, pe ) );
+  size.clauses += 3u * both;
+  size.variables += 2u * both;
+  return both + either;
+}
+
+inline uint64_t half_merge_size( cardinality_encoding_size& size, uint64_t s, uint64_t pa, uint64_t pb )
+{
+  if ( pa == 0u || pb == 0u || s == 1u )
+  {
+    if ( s == 1u && pa != 0u && pb != 0u )
+    {
+      half_comparators_size( size, 1u, 2u, 1u );
+    }
+    return pa + pb;
+  }
+
+  auto const pd = half_merge_size( size, s / 2u, ( pa + 1u ) / 2u, ( pb + 1u ) / 2u );
+  auto const pe = half_merge_size( size, s / 2u, pa / 2u, pb / 2u );
+  return std::min<uint64_t>( pd, 1u ) + half_comparators_size( size, s - 1u, pd, pe ) + ( pe == s ? 1u : 0u );
+}
+
+inline uint64_t half_sort_size( cardinality_encoding_size& size, uint64_t s, uint64_t p )
+{
+  if ( s == 1u || p == 0u )
+  {
+    return p;
+  }
+
+  auto const h = s / 2u;
+  auto const pd = half_sort_size( size, h, std::min( p, h ) );
+  auto const pe = half_sort_size( size, h, p - std::min( p, h ) );
+  return half_merge_size( size, h, pd, pe );
+}
+
+inline uint64_t simplified_merge_size( cardinality_encoding_size& size, uint64_t s, uint64_t pa, uint64_t pb )
+{
+  if ( pa == 0u || pb == 0u || s == 1u )
+  {
+    if ( s == 1u && pa != 0u && pb != 0u )
+    {
+      half_comparators_size( size, 1u, 2u, 1u );
+    }
+    return std::min( s + 1u, pa + pb );
+  }
+
+  auto const pd = simplified_merge_size( size, s / 2u, ( pa + 1u ) / 2u, ( pb + 1u ) / 2u );
+  auto const pe = simplified_merge_size( size, s / 2u, pa / 2u, pb / 2u );
+  return std::min<uint64_t>( pd, 1u ) + half_comparators_size( size, s / 2u, pd, pe );
+}
+
+inline uint64_t cardinality_network_size( cardinality_encoding_size& size, uint64_t n, uint64_t p, uint64_t m )
+{
+  if ( n == m || p == 0u )
+  {
+    return half_sort_size( size, m, p );
+  }
+
+  auto const split = ( n / m / 2u ) * m;
+  auto const pd = cardinality_network_size( size, split, std::min( p, split ), m );
+  auto const pe = cardinality_network_size( size, n - split, p - std::min( p, split ), m );
+  return std::min( m, simplified_merge_size( size, m, pd, pe ) );
+}
+
+struct modulo_totalizer_node
+{
+  uint32_t num_inputs;
+  std::vector<int> upper;
+  std::vector<int> lower;
+}; /* modulo_totalizer_node */
+
+inline modulo_totalizer_node merge_modulo_totalizer( std::vector<std::vector<int>>& dest, int& sid, modulo_totalizer_node const& a, modulo_totalizer_node const& b, uint32_t modulo, uint32_t max_upper )
+{
+  modulo_totalizer_node t;
+  t.num_inputs = a.num_inputs + b.num_inputs;
+
+  uint32_t const la = a.lower.size(), lb = b.lower.size();
+  uint32_t const ua = a.upper.size(), ub = b.upper.size();
+
+  t.lower.resize( std::min( la + lb, modulo - 1u ) );
+  for ( auto& v : t.lower )
+  {
+    v = sid++;
+  }
+  int const carry = la + lb >= modulo ? sid++ : 0;
+  t.upper.resize( std::min( ua + ub + ( carry != 0 ? 1u : 0u ), max_upper ) );
+  for ( auto& v : t.upper )
+  {
+    v = sid++;
+  }
+
+  /* lower digit: i + j without carry, or i + j - modulo with carry */
+  for ( auto i = 0u; i <= la; ++i )
+  {
+    for ( auto j = 0u; j <= lb; ++j )
+    {
+      if ( i + j == 0u )
+      {
+        continue;
+      }
+
+      std::vector<int> clause;
+      if ( i > 0u )
+      {
+        clause.emplace_back( -a.lower[i - 1u] );
+      }
+      if ( j > 0u )
+      {
+        clause.emplace_back( -b.lower[j - 1u] );
+      }
+
+      if ( i + j < modulo )
+      {
+        if ( carry != 0 )
+        {
+          clause.emplace_back( carry );
+        }
+        clause.emplace_back( t.lower[i + j - 1u] );
+      }
+      else if ( i + j == modulo )
+      {
+        clause.emplace_back( carry );
+      }
+      else
+      {
+        clause.emplace_back( t.lower[i + j - modulo - 1u] );
+      }
+      dest.emplace_back( clause );
+    }
+  }
+
+  /* upper digit: i + j, plus 1 with carry */
+  for ( auto i = 0u; i <= ua; ++i )
+  {
+    for ( auto j = 0u; j <= ub; ++j )
+    {
+      std::vector<int> clause;
+      if ( i > 0u )
+      {
+        clause.emplace_back( -a.upper[i - 1u] );
+      }
+      if ( j > 0u )
+      {
+        clause.emplace_back( -b.upper[j - 1u] );
+      }
+
+      if ( i + j > 0u && i + j <= t.upper.size() )
+      {
+        auto cl = clause;
+        cl.emplace_back( t.upper[i + j - 1u] );
+        dest.emplace_back( cl );
+      }
+      if ( carry != 0 && i + j + 1u <= t.upper.size() )
+      {
+        clause.emplace_back( -carry );
+        clause.emplace_back( t.upper[i + j] );
+        dest.emplace_back( clause );
+      }
+    }
+  }
+
+  return t;
+}
+
+/* number of pairs 0 <= i <= a, 0 <= j <= b with i + j <= t */
+inline uint64_t num_pairs_up_to( uint64_t a, uint64_t b, int64_t t )
+{
+  uint64_t count = 0u;
+  for ( int64_t i = 0; i <= int64_t( a ) && i <= t; ++i )
+  {
+    count += std::min<int64_t>( b, t - i ) + 1;
+  }
+  return count;
+}
+
+inline uint32_t default_modulo( uint32_t rhs )
+{
+  return std::max( 2u, uint32_t( std::ceil( std::sqrt( double( rhs ) + 1.0 ) ) ) );
+}
+
+} /* namespace detail */
+
+inline cardinality_encoding select_cardinality_encoding( uint32_t n, uint32_t rhs );
+
+/*! \brief Returns the number of clauses and variables of an encoding
+ *
+ * The numbers are exact for the constraints created by
+ * create_cardinality_constraint for n literals and the largest bound
+ * rhs (without the clauses of bound_cardinality_constraint).
+ */
+inline cardinality_encoding_size compute_cardinality_encoding_size( cardinality_encoding encoding, uint32_t n, uint32_t rhs )
+{
+  cardinality_encoding_size size;
+  if ( n == 0u )
+  {
+    return size;
+  }
+
+  switch ( encoding )
+  {
+  case cardinality_encoding::totalizer:
+    {
+      /* follows the nodes of create_totalizer */
+      std::deque<std::pair<uint64_t, uint64_t>> queue( n, { 1u, 1u } ); /* (inputs, outputs) */
+      while ( queue.size() > 1u )
+      {
+        auto const a = queue.front();
+        queue.pop_front();
+        auto const b = queue.front();
+        queue.pop_front();
+
+        auto const o = std::min<uint64_t>( rhs + 1u, a.first + b.first );
+        size.variables += o;
+        size.clauses += std::min( o, b.second ) + std::min( o, a.second );
+        for ( auto i = 1u; i <= std::min( o, a.second ); ++i )
+        {
+          size.clauses += std::min( o - i, b.second );
+        }
+        queue.emplace_back( a.first + b.first, o );
+      }
+    }
+    break;
+
+  case cardinality_encoding::sequential_counter:
+    {
+      uint64_t const m = std::min( rhs + 1u, n );
+      uint64_t w = 1u;
+      for ( auto i = 1u; i < n; ++i )
+      {
+        auto const next = std::min<uint64_t>( i + 1u, m );
+        size.variables += next;
+        size.clauses += w + next;
+        w = next;
+      }
+    }
+    break;
+
+  case cardinality_encoding::cardinality_network:
+    {
+      auto const m = detail::next_power_of_two( std::min( rhs + 1u, n ) );
+      detail::cardinality_network_size( size, uint64_t( ( n + m - 1u ) / m ) * m, n, m );
+    }
+    break;
+
+  case cardinality_encoding::modulo_totalizer:
+    {
+      /* follows the nodes of create_cardinality_constraint */
+      auto const p = detail::default_modulo( rhs );
+      uint64_t const max_upper = rhs / p + 1u;
+
+      struct node
+      {
+        uint64_t inputs, upper, lower;
+      };
+      std::deque<node> queue( n, node{ 1u, 0u, 1u } );
+      while ( queue.size() > 1u )
+      {
+        auto const a = queue.front();
+        queue.pop_front();
+        auto const b = queue.front();
+        queue.pop_front();
+
+        auto const carry = a.lower + b.lower >= p ? 1u : 0u;
+        node t{ a.inputs + b.inputs, 0u, std::min<uint64_t>( a.lower + b.lower, p - 1u ) };
+        t.upper = std::min( a.upper + b.upper + carry, max_upper );
+
+        size.variables += t.lower + t.upper + carry;
+        size.clauses += ( a.lower + 1u ) * ( b.lower + 1u ) - 1u;
+        size.clauses += detail::num_pairs_up_to( a.upper, b.upper, t.upper ) - 1u;
+        if ( carry )
+        {
+          size.clauses += detail::num_pairs_up_to( a.upper, b.upper, int64_t( t.upper ) - 1 );
+        }
+        queue.push_back( t );
+      }
+    }
+    break;
+
+  case cardinality_encoding::automatic:
+    return compute_cardinality_encoding_size( select_cardinality_encoding( n, rhs ), n, rhs );
+  }
+
+  return size;
+}
+
+/*! \brief Selects the encoding with the fewest clauses
+ *
+ * Ties are broken by the number of variables and then by the order of
+ * cardinality_encoding.
+ */
+inline cardinality_encoding select_cardinality_encoding( uint32_t n, uint32_t rhs )
+{
+  auto best = cardinality_encoding::totalizer;
+  auto best_size = compute_cardinality_encoding_size( best, n, rhs );
+  for ( auto const encoding : { cardinality_encoding::sequential_counter, cardinality_encoding::cardinality_network, cardinality_encoding::modulo_totalizer } )
+  {
+    auto const size = compute_cardinality_encoding_size( encoding, n, rhs );
+    if ( std::make_pair( size.clauses, size.variables ) < std::make_pair( best_size.clauses, best_size.variables ) )
+    {
+      best = encoding;
+      best_size = size;
+    }
+  }
+  return best;
+}
+
+/*! \brief Creates a cardinality constraint
+ *
+ * Creates the outputs to bound the number of true literals in `lhs`
+ * by any k <= rhs.  The bound can be tightened incrementally by
+ * bounding the same constraint with smaller values of k.
+ *
+ * \param dest Destination of the clauses
+ * \param sid Next free variable
+ * \param lhs Literals
+ * \param rhs Largest bound
+ * \param encoding Encoding of the constraint (automatic selects the smallest)
+ */
+inline cardinality_constraint create_cardinality_constraint( std::vector<std::vector<int>>& dest, int& sid, std::vector<int> const& lhs, uint32_t rhs, cardinality_encoding encoding = cardinality_encoding::automatic )
+{
+  cardinality_constraint c;
+  c.encoding = encoding == cardinality_encoding::automatic ? select_cardinality_encoding( lhs.size(), rhs ) : encoding;
+  c.num_inputs = lhs.size();
+  c.rhs = rhs;
+  if ( lhs.empty() )
+  {
+    return c;
+  }
+
+  switch ( c.encoding )
+  {
+  case cardinality_encoding::totalizer:
+    c.vars = create_totalizer( dest, sid, lhs, rhs )->vars;
+    break;
+
+  case cardinality_encoding::sequential_counter:
+    c.vars = detail::create_sequential_counter( dest, sid, lhs, rhs );
+    break;
+
+  case cardinality_encoding::cardinality_network:
+    {
+      /* pad the inputs with constants to a multiple of m */
+      uint32_t const num_outputs = std::min( rhs + 1u, c.num_inputs );
+      auto const m = detail::next_power_of_two( num_outputs );
+      auto inputs = lhs;
+      inputs.resize( ( ( inputs.size() + m - 1u ) / m ) * m, 0 );
+      c.vars = detail::create_cardinality_network( dest, sid, inputs, m );
+      c.vars.resize( num_outputs );
+    }
+    break;
+
+  case cardinality_encoding::modulo_totalizer:
+    {
+      c.modulo = detail::default_modulo( rhs );
+      std::deque<detail::modulo_totalizer_node> queue;
+      for ( const auto& l : lhs )
+      {
+        queue.push_back( detail::modulo_totalizer_node{ 1u, {}, { l } } );
+      }
+      while ( queue.size() > 1u )
+      {
+        auto const a = queue.front();
+        queue.pop_front();
+        auto const b = queue.front();
+        queue.pop_front();
+        queue.push_back( detail::merge_modulo_totalizer( dest, sid, a, b, c.modulo, rhs / c.modulo + 1u ) );
+      }
+      c.upper = queue.front().upper;
+      c.lower = queue.front().lower;
+    }
+    break;
+
+  case cardinality_encoding::automatic:
+    break;
+  }
+
+  return c;
+}
+
+/*! \brief Bounds a cardinality constraint by at most k
+ *
+ * Returns the assumptions that enforce at most k true literals.  For
+ * the modulo totalizer, a clause with a new activation literal may be
+ * added to `dest`.
+ *
+ * \param dest Destination of the clauses
+ * \param sid Next free variable
+ * \param c Cardinality constraint
+ * \param k Bound (at most c.rhs)
+ */
+inline std::vector<int> bound_cardinality_constraint( std::vector<std::vector<int>>& dest, int& sid, cardinality_constraint const& c, uint32_t k )
+{
+  if ( k >= c.num_inputs )
+  {
+    return {};
+  }
+  assert( k <= c.rhs );
+
+  if ( c.encoding != cardinality_encoding::modulo_totalizer )
+  {
+    return { -c.vars[k] };
+  }
+
+  /* k = q * modulo + r: the quotient is at most q, and at most r if it is q */
+  auto const q = k / c.modulo;
+  auto const r = k % c.modulo;
+
+  std::vector<int> assumptions;
+  if ( q < c.upper.size() )
+  {
+    assumptions.emplace_back( -c.upper[q] );
+  }
+  if ( r < c.lower.size() )
+  {
+    if ( q == 0u )
+    {
+      assumptions.emplace_back( -c.lower[r] );
+    }
+    else if ( q <= c.upper.size() )
+    {
+      int const a = sid++;
+      dest.emplace_back( std::vector<int>{ -a, -c.upper[q - 1u], -c.lower[r] } );
+      assumptions.emplace_back( a );
+    }
+  }
+  return assumptions;
+}
+
+/*! \brief Outputs of a pseudo-Boolean constraint
+ *
+ * Sums the weights of the true literals with the generalized
+ * totalizer.  Each node of the tree has one output per distinct sum
+ * of the weights below it, and all sums above rhs are merged into
+ * rhs + 1, such that the size depends on the number of distinct sums
+ * rather than on the weights.  vars[j] is true if the weights of the
+ * true literals add up to sums[j] (sorted in increasing order).  The
+ * outputs bound the sum by any k <= rhs (see bound_pb_constraint).
+ */
+struct pb_constraint
+{
+  uint64_t rhs{0};
+  std::vector<uint64_t> sums;
+  std::vector<int> vars;
+}; /* pb_constraint */
+
+namespace detail
+{
+
+/* merges the outputs of two nodes of the generalized totalizer */
+inline pb_constraint merge_generalized_totalizer( std::vector<std::vector<int>>& dest, int& sid, pb_constraint const& a, pb_constraint const& b, uint64_t rhs )
+{
+  std::map<uint64_t, int> outputs;
+  auto const output = [&]( uint64_t sum ) {
+    auto it = outputs.find( std::min( sum, rhs + 1u ) );
+    if ( it == outputs.end() )
+    {
+      it = outputs.emplace( std::min( sum, rhs + 1u ), sid++ ).first;
+    }
+    return it->second;
+  };
+
+  for ( auto i = 0u; i < a.sums.size(); ++i )
+  {
+    dest.emplace_back( std::vector<int>{ -a.vars[i], output( a.sums[i] ) } );
+  }
+  for ( auto j = 0u; j < b.sums.size(); ++j )
+  {
+    dest.emplace_back( std::vector<int>{ -b.vars[j], output( b.sums[j] ) } );
+  }
+  for ( auto i = 0u; i < a.sums.size(); ++i )
+  {
+    for ( auto j = 0u; j < b.sums.size(); ++j )
+    {
+      /* the sum is already merged into rhs + 1 by the clauses above */
+      if ( a.sums[i] > rhs || b.sums[j] > rhs )
+      {
+        continue;
+      }
+      dest.emplace_back( std::vector<int>{ -a.vars[i], -b.vars[j], output( a.sums[i] + b.sums[j] ) } );
+    }
+  }
+
+  pb_constraint t;
+  t.rhs = rhs;
+  for ( const auto& [sum, var] : outputs )
+  {
+    t.sums.emplace_back( sum );
+    t.vars.emplace_back( var );
+  }
+  return t;
+}
+
+} /* namespace detail */
+
+/*! \brief Creates a pseudo-Boolean constraint
+ *
+ * Creates the outputs to bound the sum of the weights of the true
+ * literals in `lhs` by any k <= rhs.  The bound can be tightened
+ * incrementally by bounding the same constraint with smaller values
+ * of k.  Literals of weight 0 are ignored.
+ *
+ * \param dest Destination of the clauses
+ * \param sid Next free variable
+ * \param lhs Literals
+ * \param weights Weights of the literals
+ * \param rhs Largest bound
+ */
+inline pb_constraint create_pb_constraint( std::vector<std::vector<int>>& dest, int& sid, std::vector<int> const& lhs, std::vector<uint64_t> const& weights, uint64_t rhs )
+{
+  assert( lhs.size() == weights.size() );
+
+  std::deque<pb_constraint> queue;
+  for ( auto i = 0u; i < lhs.size(); ++i )
+  {
+    if ( weights[i] > 0u )
+    {
+      queue.push_back( pb_constraint{ rhs, { std::min( weights[i], rhs + 1u ) }, { lhs[i] } } );
+    }
+  }
+  if ( queue.empty() )
+  {
+    return pb_constraint{ rhs, {}, {} };
+  }
+
+  while ( queue.size() > 1u )
+  {
+    auto const a = queue.front();
+    queue.pop_front();
+    auto const b = queue.front();
+    queue.pop_front();
+    queue.push_back( detail::merge_generalized_totalizer( dest, sid, a, b, rhs ) );
+  }
+  return queue.front();
+}
+
+/*! \brief Bounds a pseudo-Boolean constraint by at most k
+ *
+ * Returns the assumptions that enforce a sum of at most k.
+ *
+ * \param c Pseudo-Boolean constraint
+ * \param k Bound (at most c.rhs)
+ */
+inline std::vector<int> bound_pb_constraint( pb_constraint const& c, uint64_t k )
+{
+  assert( k <= c.rhs );
+
+  std::vector<int> assumptions;
+  for ( auto j = 0u; j < c.sums.size(); ++j )
+  {
+    if ( c.sums[j] > k )
+    {
+      assumptions.emplace_back( -c.vars[j] );
+    }
+  }
+  return assumptions;
+}
+
 } /* namespace easy::sat2 */
@@ -26,13 +26,23 @@
 #pragma once
 
 #include <easy/sat/sat_solver.hpp>
-#include <easy/utils/dynamic_bitset.hpp>
+#include <easy/utils/gf2_matrix.hpp>
 
+#include <algorithm>
 #include <queue>
 
 namespace easy::sat2
 {
 
+/*! \brief Translates XOR-clauses into clauses
+ *
+ * The XOR of the literals of each XOR-clause must be true.  The
+ * system is brought into reduced row echelon form with Gauss-Jordan
+ * elimination and each row is translated into a chain of Tseitin
+ * clauses.  Variables with fewer occurrences are preferred as
+ * pivots to avoid fill-in.  An inconsistent system is translated
+ * into the empty clause.
+ */
 class cnf_from_xcnf
 {
 public:
@@ -42,112 +52,68 @@ public:
     , _num_vars( num_vars )
   {
     auto matrix = make_matrix( xor_clauses );
-    // simplify_matrix( matrix );
+    simplify_matrix( matrix );
 
     cnf_from_matrix( _clauses, matrix );
     // cnf_from_xor_clauses( _clauses, xor_clauses );
   }
 
-  std::vector<utils::dynamic_bitset<>> make_matrix( std::vector<std::vector<int>> const& xor_clauses )
+  /* the last column is the right-hand side */
+  utils::gf2_matrix make_matrix( std::vector<std::vector<int>> const& xor_clauses )
   {
-    std::vector<utils::dynamic_bitset<>> matrix;
+    /* order columns by number of occurrences */
+    std::vector<uint32_t> occurrences( _num_vars, 0u );
     for ( const auto& cl : xor_clauses )
     {
-      utils::dynamic_bitset<> row;
-      row.resize( _num_vars );
-
-      auto sum = 0u;
       for ( const auto& l : cl )
       {
-        assert( abs( l ) < _num_vars );
-        row.set_bit( abs( l ) - 1 );
-        sum += l < 0;
+        assert( uint32_t( abs( l ) ) < _num_vars );
+        ++occurrences[abs( l )];
       }
-
-      if ( sum % 2 == 1 )
-        row.set_bit( row.num_bits() - 1 );
-
-      matrix.emplace_back( row );
     }
-    return matrix;
-  }
-
-  void simplify_matrix( std::vector<utils::dynamic_bitset<>>& matrix )
-  {
-    auto const num_rows = matrix.size();
 
-    auto index = 0u;
-    for ( auto i = 0u; i < num_rows; ++i )
+    _col_to_var.clear();
+    for ( auto v = 1u; v < _num_vars; ++v )
     {
-      /* find next row */
-      auto next_row = i;
-      if ( !matrix[i][index] )
+      if ( occurrences[v] > 0u )
       {
-        for ( auto k = i + 1; k < num_rows; ++k )
-        {
-          if ( matrix[k][index] )
-          {
-            ++index;
-            continue;
-          }
-        }
-
-        if ( !matrix[next_row][i] )
-        {
-          ++index;
-          continue;
-        }
+        _col_to_var.push_back( v );
       }
+    }
+    std::stable_sort( _col_to_var.begin(), _col_to_var.end(), [&]( int a, int b ){ return occurrences[a] < occurrences[b]; } );
 
-      /* swap current i and next_row */
-      if ( next_row != i )
-      {
-        // std::cout << "swap " << i << " and " << next_row << std::endl;
-        for ( auto j = 0u; j < matrix[i].num_bits(); ++j )
-        {
-          bool const temp = matrix[i][j];
-          if ( matrix[next_row][j] )
-            matrix[i].set_bit( j );
-          else
-            matrix[i].reset_bit( j );
-
-          if ( temp )
-            matrix[next_row].set_bit( j );
-          else
-            matrix[next_row].reset_bit( j );
-        }
-      }
+    std::vector<uint32_t> var_to_col( _num_vars );
+    for ( auto i = 0u; i < _col_to_var.size(); ++i )
+    {
+      var_to_col[_col_to_var[i]] = i;
+    }
 
-      /* add current row to all other rows */
-      for ( auto k = i + 1; k < num_rows; ++k )
+    utils::gf2_matrix matrix( xor_clauses.size(), _col_to_var.size() + 1u );
+    for ( auto r = 0u; r < xor_clauses.size(); ++r )
+    {
+      auto sum = 1u;
+      for ( const auto& l : xor_clauses[r] )
       {
-        if ( !matrix[k][index] ) continue;
-
-        // std::cout << "add " << i << " to " << k << std::endl;
-        for ( auto j = 0u; j < matrix[k].num_bits(); ++j )
-        {
-          if ( matrix[k][j] ^ matrix[i][j] )
-          {
-            matrix[k].set_bit( j );
-          }
-          else
-          {
-            matrix[k].reset_bit( j );
-          }
-        }
+        matrix.flip( r, var_to_col[abs( l )] );
+        sum += l < 0;
       }
-
-      ++index;
+      matrix.set( r, _col_to_var.size(), sum % 2 );
     }
+    return matrix;
+  }
+
+  void simplify_matrix( utils::gf2_matrix& matrix )
+  {
+    _rank = matrix.reduced_row_echelon_form( matrix.num_cols() - 1u ).size();
   }
 
-  void print_matrix( std::ostream& os, std::vector<utils::dynamic_bitset<>> const& matrix ) const
+  void print_matrix( std::ostream& os, utils::gf2_matrix const& matrix ) const
   {
-    for ( const auto& m : matrix )
+    for ( auto r = 0u; r < matrix.num_rows(); ++r )
     {
-      for ( auto i = 0; i < m.num_bits(); ++i )
+      for ( auto c = 0u; c < matrix.num_cols(); ++c )
       {
-        os << m[i];
+        os << matrix.get( r, c );
       }
       os << std::endl;
     }
@@ -183,28 +149,38 @@ public:
     clauses.emplace_back( std::vector<int>{ lits.front() } );
   }
 
-  void cnf_from_matrix( std::vector<std::vector<int>>& clauses, std::vector<utils::dynamic_bitset<>> const& matrix )
+  void cnf_from_matrix( std::vector<std::vector<int>>& clauses, utils::gf2_matrix const& matrix )
   {
-    for ( const auto& row : matrix )
+    auto const rhs = matrix.num_cols() - 1u;
+    for ( auto r = 0u; r < matrix.num_rows(); ++r )
     {
-      std::vector<int> clause;
-      for ( auto i = 0; i < row.num_bits()-1u; ++i )
+      if ( r >= _rank )
       {
-        if ( row[i] )
+        /* zero row */
+        if ( matrix.get( r, rhs ) )
         {
-          clause.push_back( i+1 );
+          clauses.emplace_back();
+          _reduced_xor_clauses.emplace_back();
+          return;
         }
+        continue;
       }
 
-      if ( !clause.empty() )
-      {
-        if ( row[row.num_bits() - 1u] )
-        {
-          clause[0] *= -1;
-        }
+      std::vector<int> clause;
+      matrix.foreach_one( r, [&]( uint32_t col ){
+          if ( col != rhs )
+          {
+            clause.push_back( _col_to_var[col] );
+          }
+        });
 
-        add_xor_clause( _clauses, clause );
+      if ( !matrix.get( r, rhs ) )
+      {
+        clause[0] *= -1;
       }
+
+      _reduced_xor_clauses.emplace_back( clause );
+      add_xor_clause( clauses, clause );
     }
   }
 
@@ -221,13 +197,27 @@ public:
     return _clauses;
   }
 
+  /*! \brief Returns the XOR-clauses in reduced row echelon form
+   *
+   * The XOR of the literals of each XOR-clause must be true.  If the
+   * system is inconsistent, the empty XOR-clause is returned.
+   */
+  std::vector<std::vector<int>> get_reduced_xor_clauses() const
+  {
+    return _reduced_xor_clauses;
+  }
+
 protected:
   int& _sid;
 
   std::vector<std::vector<int>> const& _xor_clauses;
   uint32_t _num_vars;
 
+  std::vector<int> _col_to_var;
+  uint32_t _rank = 0u;
+
   std::vector<std::vector<int>> _clauses;
+  std::vector<std::vector<int>> _reduced_xor_clauses;
 }; /* cnf_from_xcnf */
 
 } // namespace easy::sat
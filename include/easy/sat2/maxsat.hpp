@@ -35,7 +35,12 @@
 #include <easy/sat2/sat_solver.hpp>
 #include <easy/sat2/core_utils.hpp>
 #include <easy/sat2/cardinality.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
 #include <map>
+#include <numeric>
 
 namespace easy::sat2
 {
@@ -43,6 +48,9 @@ namespace easy::sat2
 struct maxsat_linear {};
 struct maxsat_uc {};
 struct maxsat_rc2 {};
+struct maxsat_oll {};
+struct maxsat_pmres {};
+struct maxsat_lsu {};
 
 template<typename Algorithm>
 class maxsat_solver;
@@ -80,12 +88,112 @@ protected:
   std::unordered_map<int, std::vector<int>> _map;
 }; /* clause_to_block_vars */
 
+namespace detail
+{
+
+/* \brief Table of values indexed by literals
+ *
+ * A literal l is stored at index 2 * |l| + (l < 0); the table grows
+ * on access as new variables are allocated.
+ */
+template<typename T>
+class literal_table
+{
+public:
+  T& operator[]( int l )
+  {
+    auto const index = 2u * uint32_t( std::abs( l ) ) + ( l < 0 ? 1u : 0u );
+    if ( index >= _data.size() )
+    {
+      _data.resize( std::max<std::size_t>( index + 1u, 2u * _data.size() ) );
+    }
+    return _data[index];
+  }
+
+protected:
+  std::vector<T> _data;
+}; /* literal_table */
+
+/* \brief Next weight level of a stratification
+ *
+ * Among the positive weights below the current level, the highest
+ * weight is taken and lowered (as in pysat's RC2Stratified) until
+ * either the weight exceeds the total weight of the remaining clauses
+ * below it (Boolean lexicographic optimization), or the number of
+ * remaining clauses per remaining distinct weight exceeds the
+ * diversity ratio.
+ *
+ * Returns 0 if no weight is below the current level.
+ */
+inline int next_weight_level( std::vector<int> weights, int level, double diversity_ratio )
+{
+  weights.erase( std::remove_if( weights.begin(), weights.end(), [level]( int w ){ return w <= 0 || w >= level; } ), weights.end() );
+  if ( weights.empty() )
+  {
+    return 0;
+  }
+
+  std::sort( weights.begin(), weights.end(), std::greater<int>() );
+  std::vector<int> levels( weights.begin(), weights.end() );
+  levels.erase( std::unique( levels.begin(), levels.end() ), levels.end() );
+
+  auto index = 0u;
+  auto below = 0u; /* first clause with a weight below levels[index] */
+  for ( ; index + 1u < levels.size(); ++index )
+  {
+    while ( below < weights.size() && weights[below] >= levels[index] )
+    {
+      ++below;
+    }
+
+    auto const num_clauses = weights.size() - below;
+    int64_t sum_weights = 0;
+    for ( auto i = below; i < weights.size(); ++i )
+    {
+      sum_weights += weights[i];
+    }
+
+    if ( sum_weights != 0 && levels[index] > sum_weights )
+    {
+      break;
+    }
+    if ( double( num_clauses ) / double( levels.size() - index - 1u ) > diversity_ratio )
+    {
+      break;
+    }
+  }
+  return levels[index];
+}
+
+} /* namespace detail */
+
 struct maxsat_solver_statistics
 {
+  sat_solver_statistics sat; /*>! Statistics of the underlying SAT-solver */
+  uint32_t iterations{0}; /*>! Number of SAT-solver calls on the soft clauses (RC2, OLL, PM-RES) */
+  uint32_t cores{0}; /*>! Number of processed UNSAT cores (RC2, OLL, PM-RES) */
+  uint32_t exhausted{0}; /*>! Number of bound increases by core exhaustion (RC2) */
+  uint32_t levels{0}; /*>! Number of activated weight levels (RC2, OLL, PM-RES) */
+  uint64_t removed_literals{0}; /*>! Number of literals removed from cores by trimming and minimization (RC2, OLL, PM-RES) */
+  int64_t cost{0}; /*>! Cost of the optimum (RC2, OLL, PM-RES) or of the best solution (LSU) */
+  uint32_t improvements{0}; /*>! Number of improving solutions (LSU) */
+  bool optimal{false}; /*>! The best solution is proven optimal (LSU) */
 }; /* maxsat_solver_statistics */
 
 struct maxsat_solver_params
 {
+  sat_solver_params sat; /*>! Parameters of the underlying SAT-solver (e.g., a solver portfolio) */
+  bool stratification = true; /*>! Assume soft clauses in levels of decreasing weight (RC2, OLL, PM-RES, LSU) */
+  double diversity_ratio = 1.8; /*>! Merge weight levels until the clauses per weight exceed this ratio (RC2, OLL, PM-RES, LSU) */
+  bool exhaust_cores = true; /*>! Increase the bound of each new cardinality constraint while UNSAT (RC2) */
+  uint32_t trim_cores = 0u; /*>! Trim each core at most this many times (RC2, OLL, PM-RES; 0 disables trimming) */
+  bool minimize_cores = false; /*>! Minimize each core by deleting literals (RC2, OLL, PM-RES) */
+  int64_t minimize_budget = 1000; /*>! Conflict budget of each SAT-solver call in core minimization (RC2, OLL, PM-RES) */
+  double time_limit = 0.0; /*>! Time limit in seconds (LSU, 0 denotes no limit) */
+  int64_t conflict_limit = -1; /*>! Conflict limit of all SAT-solver calls (LSU, a value < 0 denotes no limit) */
+  int64_t conflict_slice = 1000; /*>! Conflicts between two checks of the time limit (LSU) */
+  std::function<void(int64_t, std::vector<int> const&)> on_improvement; /*>! Called with the cost and the disabled clauses of each improving solution (LSU) */
+  cardinality_encoding cardinality = cardinality_encoding::automatic; /*>! Encoding of the bounds on the number of disabled clauses (linear, LSU) */
 }; /* maxsat_solver_params */
 
 template<>
@@ -111,7 +219,7 @@ public:
     : _stats( stats )
     , _ps( ps )
     , _sid( sid )
-    , _solver( _sat_stats, _sat_params )
+    , _solver( stats.sat, ps.sat )
   {}
 
   /* \brief Adds a hard clause to the solver
@@ -123,6 +231,16 @@ public:
     _solver.add_clause( clause );
   }
 
+  /* \brief Adds a hard XOR clause to the solver
+   *
+   * \param clause XOR clause to be added
+   * \param value Value of the XOR of the literals
+   */
+  void add_xor_clause( std::vector<int> const& clause, bool value = true )
+  {
+    _solver.add_xor_clause( clause, value );
+  }
+
   /* \brief Adds a soft clause to the solver
    *
    * \param clause Soft clause to be added
@@ -181,26 +299,27 @@ public:
       _disabled_clauses.push_back( i );
     }
 
+    /* enforce that at most k soft clauses are disabled */
+    uint32_t k = _selectors.size() - 1u;
+
     std::vector<std::vector<int>> clauses;
-    auto at_most_k = create_totalizer( clauses, _sid, _selectors, _selectors.size() );
+    auto const at_most_k = create_cardinality_constraint( clauses, _sid, _selectors, k, _ps.cardinality );
     for ( const auto& c : clauses )
     {
       add_clause( c );
     }
 
-    /* enforce that at most k soft clauses are satisfied */
-    uint32_t k = _selectors.size() - 1u;
-
     /* perform linear search */
     for ( ;; )
     {
       // std::cout << "[i] try with k = " << k << std::endl;
 
       /* disable at-most k selectors */
-      std::vector<int> assumptions;
-      for ( auto i = 0; i < at_most_k->vars.size(); ++i )
+      clauses.clear();
+      auto const assumptions = bound_cardinality_constraint( clauses, _sid, at_most_k, k );
+      for ( const auto& c : clauses )
       {
-        assumptions.emplace_back( i < k ? at_most_k->vars[i] : -at_most_k->vars[i] );
+        add_clause( c );
       }
 
       if ( _solver.solve( assumptions ) == sat2::sat_solver::state::unsat )
@@ -254,8 +373,6 @@ protected:
   maxsat_solver_params const& _ps;
   int& _sid;
 
-  sat_solver_statistics _sat_stats;
-  sat_solver_params _sat_params;
   sat_solver _solver;
 
   std::vector<int> _selectors;
@@ -290,7 +407,7 @@ public:
     : _stats( stats )
     , _ps( ps )
     , _sid( sid )
-    , _solver( _sat_stats, _sat_params )
+    , _solver( stats.sat, ps.sat )
   {}
 
   /* \brief Adds a hard clause to the solver
@@ -302,6 +419,16 @@ public:
     _solver.add_clause( clause );
   }
 
+  /* \brief Adds a hard XOR clause to the solver
+   *
+   * \param clause XOR clause to be added
+   * \param value Value of the XOR of the literals
+   */
+  void add_xor_clause( std::vector<int> const& clause, bool value = true )
+  {
+    _solver.add_xor_clause( clause, value );
+  }
+
   /* \brief Adds a soft clause to the solver
    *
    * \param clause Soft clause to be added
@@ -483,8 +610,6 @@ protected:
   maxsat_solver_params const& _ps;
   int& _sid;
 
-  sat_solver_statistics _sat_stats;
-  sat_solver_params _sat_params;
   sat_solver _solver;
 
   std::vector<int> _selectors;
@@ -519,7 +644,7 @@ public:
     : _stats( stats )
     , _ps( ps )
     , _sid( sid )
-    , _solver( _sat_stats, _sat_params )
+    , _solver( stats.sat, ps.sat )
   {}
 
   /* \brief Adds a hard clause to the solver
@@ -531,6 +656,16 @@ public:
     _solver.add_clause( clause );
   }
 
+  /* \brief Adds a hard XOR clause to the solver
+   *
+   * \param clause XOR clause to be added
+   * \param value Value of the XOR of the literals
+   */
+  void add_xor_clause( std::vector<int> const& clause, bool value = true )
+  {
+    _solver.add_xor_clause( clause, value );
+  }
+
   /* \brief Adds a soft clause to the solver
    *
    * \param clause Soft clause to be added
@@ -548,7 +683,16 @@ public:
   /*
    * \brief RC2 MAXSAT procedure
    *
-   * The implementation is based on pysat's RC2 example [1].
+   * The implementation is based on pysat's RC2 example [1] with the
+   * RC2Stratified extension.
+   *
+   * With stratification, only soft clauses whose (remaining) weight
+   * reaches the current level are assumed; if they are satisfiable,
+   * the level is lowered (see detail::next_weight_level) until no soft clause is
+   * left out.  Each new cardinality constraint is optionally
+   * exhausted, i.e., its bound is increased while the hard clauses
+   * imply that it is exceeded.  Cores can be trimmed and minimized
+   * before they are processed.
    *
    * [1] https://github.com/pysathq/pysat/blob/master/examples/rc2.py
    */
@@ -573,20 +717,18 @@ public:
 
     std::vector<int> sels;
     std::vector<int> sums;
-    std::map<int,std::shared_ptr<totalizer_tree>> t_objects;
-    std::map<int,int> bounds;
-    std::map<int, int> selector_to_clause;
-    int costs = 0;
+    int64_t costs = 0;
 
     /* add the soft clauses */
     for ( auto i = 0; i < _soft_clauses.size(); ++i )
     {
       auto cl = _soft_clauses[i];
 
-      /* if clause is unit, selector variable is its literal */
+      /* if clause is unit, selector variable is its literal (unless
+         the literal already selects another soft clause) */
       int selector = cl[0u];
 
-      if ( _soft_clauses[i].size() > 1 )
+      if ( _soft_clauses[i].size() > 1 || literal( selector ).weight_index >= 0 )
       {
         selector = _sid++;
         cl.push_back( -selector );
@@ -594,33 +736,61 @@ public:
       }
 
       sels.push_back( selector );
-      selector_to_clause.emplace( selector, i );
+      literal( selector ).weight_index = i;
     }
 
     /* make a copy of the selectors */
     _selectors = sels;
 
+    auto const weight_of = [&]( int l ) {
+      return _weights[literal( l ).weight_index];
+    };
+
+    /* start with the highest weight level */
+    int level = _ps.stratification ? next_level( sels, sums, weight_of, std::numeric_limits<int>::max() ) : 1;
+    ++_stats.levels;
+
     auto iteration = 0;
     for ( ;; )
     {
-      /* assume all soft-clauses are enabled, which causes the problem to be UNSAT */
+      /* assume all soft-clauses of the current level are enabled, which causes the problem to be UNSAT */
       std::vector<int> assumptions;
       for ( const auto& s : sels )
       {
-        assumptions.emplace_back( s );
+        if ( weight_of( s ) >= level )
+        {
+          assumptions.emplace_back( s );
+        }
       }
       for ( const auto& s : sums )
       {
-        assumptions.emplace_back( s );
+        if ( weight_of( s ) >= level )
+        {
+          assumptions.emplace_back( s );
+        }
       }
 
+      ++_stats.iterations;
       auto const state = _solver.solve( assumptions );
       if ( state == sat2::sat_solver::state::sat )
       {
+        /* continue with the next level of soft clauses */
+        if ( _ps.stratification )
+        {
+          level = next_level( sels, sums, weight_of, level );
+          if ( level > 0 )
+          {
+            ++_stats.levels;
+            continue;
+          }
+        }
+
+        /* a relaxed soft clause may still be satisfied by the model */
         auto const model = _solver.get_model();
         for ( auto i = 0; i < _soft_clauses.size(); ++i )
         {
-          if ( model[_selectors[i]] )
+          auto const& cl = _soft_clauses[i];
+          if ( std::any_of( std::begin( cl ), std::end( cl ), [&model]( int l ){ return model[l]; } ) )
           {
             _enabled_clauses.push_back( i );
           }
@@ -629,39 +799,40 @@ public:
             _disabled_clauses.push_back( i );
           }
         }
-        // assert( _disabled_clauses.size() <= costs );
-        return state::success;
+        _stats.cost = costs;
+        _state = state::success;
+        return _state;
       }
 
-      auto const core = _solver.get_core();
-      // std::cout << "[i] core: "; core.print(); std::cout << std::endl;
+      auto core = _solver.get_core();
+      ++_stats.cores;
 
-      /* divide core into sels and sums */
-      std::vector<int> core_sels;
-      std::vector<int> core_sums;
-      for ( auto i = 0; i < core.size(); ++i )
+      /* reduce the core */
+      if ( core.size() > 1u )
       {
-        if ( std::find( std::begin( sels ), std::end( sels ), core[i] ) != std::end( sels ) )
+        auto const size = core.size();
+        if ( _ps.trim_cores > 0u )
         {
-          core_sels.push_back( core[i] );
-          continue;
+          trim_core( _solver, core, _ps.trim_cores );
         }
-
-        if ( std::find( std::begin( sums ), std::end( sums ), core[i] ) != std::end( sums ) )
+        if ( _ps.minimize_cores )
         {
-          core_sums.push_back( core[i] );
-          continue;
+          minimize_core( _solver, core, _ps.minimize_budget );
         }
+        _stats.removed_literals += size - core.size();
       }
+      // std::cout << "[i] core: "; core.print(); std::cout << std::endl;
 
-      /* update costs */
+      /* divide core into sels and sums, and update costs */
+      std::vector<int> core_sels;
+      std::vector<int> core_sums;
       int w_min = std::numeric_limits<int>::max();
       for ( auto i = 0; i < core.size(); ++i )
       {
-        auto const clause_id = selector_to_clause.at( core[i] );
-        auto const w = _weights.at( clause_id );
-        if ( w < w_min )
-          w_min = w;
+        auto const& info = literal( core[i] );
+        assert( info.weight_index >= 0 );
+        ( info.tree ? core_sums : core_sels ).push_back( core[i] );
+        w_min = std::min( w_min, _weights[info.weight_index] );
       }
 
       // std::cout << "[i] w_min = " << w_min << std::endl;
@@ -675,13 +846,12 @@ public:
         std::vector<int> rels;
         for ( const auto& l : core_sels )
         {
-          auto const clause_id = selector_to_clause.at( l );
-          auto& w = _weights.at( clause_id );
+          auto& w = _weights[literal( l ).weight_index];
           if ( w == w_min )
           {
             /* marking variables as being a part of the core, so that
                next time it is not used as an assumption */
-            garbage.push_back( l );
+            mark_garbage( garbage, l );
 
             /* reuse assumption variables as relaxation */
             rels.push_back( -l );
@@ -703,13 +873,12 @@ public:
         /* process sums */
         for ( const auto& l : core_sums )
         {
-          auto const clause_id = selector_to_clause.at( l );
-          auto& w = _weights[clause_id];
+          auto& w = _weights[literal( l ).weight_index];
           if ( w == w_min )
           {
             /* marking variable as being a part of the core so that
                next time it is not used as an assumption */
-            garbage.push_back( l );
+            mark_garbage( garbage, l );
           }
           else
           {
@@ -719,8 +888,8 @@ public:
           }
 
           /* increase bound for the sum */
-          auto& t = t_objects[l];
-          auto b = bounds[l]+1;
+          auto t = literal( l ).tree;
+          auto b = literal( l ).bound + 1;
 
           std::vector<std::vector<int>> clauses;
           increase_totalizer( clauses, _sid, t, b );
@@ -732,26 +901,22 @@ public:
           /* updating bounds and weights */
           if ( b < t->vars.size() )
           {
-            auto lnew = -t->vars[b];
-            if ( std::find( std::begin( garbage ), std::end( garbage ), lnew ) != std::end( garbage ) )
+            auto const lnew = -t->vars[b];
+            auto& info = literal( lnew );
+            if ( info.garbage )
             {
-              garbage.erase( std::remove( std::begin( garbage ), std::end( garbage ), lnew ) );
-              _weights[selector_to_clause[lnew]] = 0;
+              info.garbage = false;
+              _weights[info.weight_index] = 0;
             }
 
-            if ( selector_to_clause.find( lnew ) == selector_to_clause.end() )
+            if ( info.weight_index < 0 )
             {
               /* invoke set bounds */
-              t_objects.emplace( -t->vars[b], t );
-              bounds.emplace( -t->vars[b], b );
-              selector_to_clause.emplace( -t->vars[b], _weights.size() );
-              _weights.push_back( w_min );
-
-              sums.push_back( -t->vars[b] );
+              set_bound( sums, t, b, w_min );
             }
             else
             {
-              _weights[selector_to_clause[lnew]] += w_min;
+              _weights[info.weight_index] += w_min;
             }
           }
 
@@ -768,17 +933,18 @@ public:
             add_clause( c );
           }
 
-          /* TODO: exhaust core */
-          auto b = 1;
-          /* invoke set bound */
-
-          /* save the info about this sum and add its assumption literal */
-          t_objects.emplace( -totalizer_tree->vars[b], totalizer_tree );
-          bounds.emplace( -totalizer_tree->vars[b], b );
-          selector_to_clause.emplace( -totalizer_tree->vars[b], _weights.size() );
-          _weights.push_back( w_min );
+          uint32_t b = 1u;
+          if ( _ps.exhaust_cores )
+          {
+            b = exhaust_core( totalizer_tree, costs, w_min );
+          }
 
-          sums.push_back( -totalizer_tree->vars[b] );
+          /* the sum is not relaxed completely */
+          if ( b < totalizer_tree->vars.size() )
+          {
+            /* save the info about this sum and add its assumption literal */
+            set_bound( sums, totalizer_tree, b, w_min );
+          }
         }
       }
       else
@@ -787,19 +953,21 @@ public:
 
         /* special case: unit core */
         add_clause( { -core_sels[0] } );
-        garbage.push_back( core_sels[0] );
+        mark_garbage( garbage, core_sels[0] );
       }
 
       /* cleanup garbage */
-      sels.erase( std::remove_if( std::begin( sels ), std::end( sels ),
-        [&garbage]( auto const &x ){
-          return std::find( std::begin( garbage ), std::end( garbage ), x) != std::end( garbage );
-        }), std::end( sels ) );
-      sums.erase( std::remove_if( std::begin( sums ), std::end( sums ),
-        [&garbage]( auto const &x ){
-          return std::find( std::begin( garbage ), std::end( garbage ), x) != std::end( garbage );
-        }), std::end( sums ) );
-      garbage.clear();
+      if ( !garbage.empty() )
+      {
+        auto const is_garbage = [this]( int l ){ return literal( l ).garbage; };
+        sels.erase( std::remove_if( std::begin( sels ), std::end( sels ), is_garbage ), std::end( sels ) );
+        sums.erase( std::remove_if( std::begin( sums ), std::end( sums ), is_garbage ), std::end( sums ) );
+        for ( const auto& l : garbage )
+        {
+          literal( l ).garbage = false;
+        }
+        garbage.clear();
+      }
 
       // std::cout << "c cost: " << costs << ' ';
       // std::cout << "core sz: " << core.size() << ' ';
@@ -822,6 +990,86 @@ public:
     return _disabled_clauses;
   }
 
+protected:
+  /* bookkeeping of a soft literal, i.e., a selector or the assumption literal of a sum */
+  struct literal_info
+  {
+    int weight_index = -1; /* index into _weights (-1 if the literal is not a soft literal) */
+    uint32_t bound = 0u; /* bound of the sum */
+    bool garbage = false; /* the literal is removed from the assumptions after the current core */
+    std::shared_ptr<totalizer_tree> tree; /* totalizer of the sum (nullptr for selectors) */
+  };
+
+  literal_info& literal( int l )
+  {
+    return _literals[l];
+  }
+
+  void mark_garbage( std::vector<int>& garbage, int l )
+  {
+    auto& info = literal( l );
+    if ( !info.garbage )
+    {
+      info.garbage = true;
+      garbage.push_back( l );
+    }
+  }
+
+  /* \brief Adds the assumption literal of a sum with bound b */
+  void set_bound( std::vector<int>& sums, std::shared_ptr<totalizer_tree> const& t, uint32_t b, int weight )
+  {
+    auto const l = -t->vars[b];
+    auto& info = literal( l );
+    info.tree = t;
+    info.bound = b;
+    info.weight_index = int( _weights.size() );
+    _weights.push_back( weight );
+
+    sums.push_back( l );
+  }
+
+  /* \brief Next weight level of the stratification (see detail::next_weight_level) */
+  template<typename WeightFn>
+  int next_level( std::vector<int> const& sels, std::vector<int> const& sums, WeightFn&& weight_of, int level ) const
+  {
+    std::vector<int> weights;
+    for ( const auto& v : { &sels, &sums } )
+    {
+      for ( const auto& l : *v )
+      {
+        weights.push_back( weight_of( l ) );
+      }
+    }
+    return detail::next_weight_level( weights, level, _ps.diversity_ratio );
+  }
+
+  /* \brief Exhausts a new cardinality constraint
+   *
+   * Increases the bound of the sum while the hard clauses imply that
+   * it exceeds the bound.  Each increase adds the weight of the core
+   * to the costs.
+   *
+   * Returns the bound of the sum.
+   */
+  uint32_t exhaust_core( std::shared_ptr<totalizer_tree>& t, int64_t& costs, int w_min )
+  {
+    uint32_t b = 1u;
+    while ( b < t->vars.size() && _solver.solve( { -t->vars[b] } ) == sat2::sat_solver::state::unsat )
+    {
+      costs += w_min;
+      ++b;
+      ++_stats.exhausted;
+
+      std::vector<std::vector<int>> clauses;
+      increase_totalizer( clauses, _sid, t, b );
+      for ( const auto& c : clauses )
+      {
+        add_clause( c );
+      }
+    }
+    return b;
+  }
+
 protected:
   state _state = state::fresh;
 
@@ -829,8 +1077,6 @@ protected:
   maxsat_solver_params const& _ps;
   int& _sid;
 
-  sat_solver_statistics _sat_stats;
-  sat_solver_params _sat_params;
   sat_solver _solver;
 
   std::vector<int> _selectors;
@@ -840,6 +1086,1021 @@ protected:
 
   std::vector<std::vector<int>> _soft_clauses;
   std::vector<int> _weights;
+
+  detail::literal_table<literal_info> _literals;
 }; /* maxsat_solver<maxsat_rc2> */
 
+template<>
+class maxsat_solver<maxsat_oll>
+{
+public:
+  enum class state
+  {
+    fresh = 0,
+    success = 1,
+    fail = 2,
+  }; /* state */
+
+public:
+  /* \brief Constructor
+   *
+   * Constructs a MAXSAT-solver
+   *
+   * \param stats Statistics
+   * \param ps Parameters
+   */
+  explicit maxsat_solver( maxsat_solver_statistics& stats, maxsat_solver_params& ps, int& sid )
+    : _stats( stats )
+    , _ps( ps )
+    , _sid( sid )
+    , _solver( stats.sat, ps.sat )
+  {}
+
+  /* \brief Adds a hard clause to the solver
+   *
+   * \param clause Clause to be added
+   */
+  void add_clause( std::vector<int> const& clause )
+  {
+    _solver.add_clause( clause );
+  }
+
+  /* \brief Adds a hard XOR clause to the solver
+   *
+   * \param clause XOR clause to be added
+   * \param value Value of the XOR of the literals
+   */
+  void add_xor_clause( std::vector<int> const& clause, bool value = true )
+  {
+    _solver.add_xor_clause( clause, value );
+  }
+
+  /* \brief Adds a soft clause to the solver
+   *
+   * \param clause Soft clause to be added
+   *
+   * Returns the added activation variable.
+   */
+  int add_soft_clause( std::vector<int> const &clause, int weight = 1 )
+  {
+    auto id = _soft_clauses.size();
+    _soft_clauses.emplace_back( clause );
+    _weights.emplace_back( weight );
+    return id;
+  }
+
+  /*
+   * \brief OLL MAXSAT procedure
+   *
+   * Core-guided MAXSAT with incremental totalizers [1].  The weight of
+   * a core is subtracted from its soft literals, and the literals are
+   * summed up in a totalizer whose output "at least 2 literals are
+   * false" becomes a new soft literal.  If the output of a sum occurs
+   * in a core, the next output of the same totalizer becomes soft.
+   *
+   * The cores are extracted weight-aware [2]: the literals of a core
+   * are only reweighted, and further cores are searched among the
+   * remaining soft literals.  The totalizers of all cores are created
+   * together once the remaining soft literals are satisfiable.  Soft
+   * literals are stratified by weight as in RC2.
+   *
+   * [1] A. Morgado, C. Dodaro, J. Marques-Silva, CP 2014, 564-573
+   * [2] J. Berg, M. Järvisalo, IJCAI 2017, 739-745
+   */
+  state solve()
+  {
+    if ( _solver.solve() == sat2::sat_solver::state::unsat )
+    {
+      _state = state::fail;
+      return _state;
+    }
+
+    if ( _soft_clauses.size() == 0u )
+    {
+      _state = state::fail;
+      return _state;
+    }
+
+    /* add the soft clauses */
+    std::vector<int> softs;
+    for ( auto i = 0u; i < _soft_clauses.size(); ++i )
+    {
+      auto cl = _soft_clauses[i];
+
+      /* if clause is unit, selector variable is its literal (unless
+         the literal already selects another soft clause) */
+      int selector = cl[0u];
+      if ( cl.size() > 1 || _literals[selector].soft )
+      {
+        selector = _sid++;
+        cl.push_back( -selector );
+        add_clause( cl );
+      }
+
+      _literals[selector].soft = true;
+      add_weight( softs, selector, _weights[i] );
+    }
+
+    int64_t costs = 0;
+    std::vector<std::pair<std::vector<int>, int>> cores;
+
+    int level = _ps.stratification ? next_level( softs, std::numeric_limits<int>::max() ) : 1;
+    ++_stats.levels;
+
+    for ( ;; )
+    {
+      /* assume the soft literals of the current level and drop relaxed ones */
+      std::vector<int> assumptions;
+      softs.erase( std::remove_if( std::begin( softs ), std::end( softs ),
+                                   [this]( int l ){ return _literals[l].weight == 0; } ),
+                   std::end( softs ) );
+      for ( const auto& l : softs )
+      {
+        if ( _literals[l].weight >= level )
+        {
+          assumptions.emplace_back( l );
+        }
+      }
+
+      ++_stats.iterations;
+      if ( _solver.solve( assumptions ) == sat2::sat_solver::state::sat )
+      {
+        /* relax the cores found on this level */
+        if ( !cores.empty() )
+        {
+          for ( const auto& c : cores )
+          {
+            relax_core( softs, c.first, c.second );
+          }
+          cores.clear();
+          continue;
+        }
+
+        if ( _ps.stratification )
+        {
+          level = next_level( softs, level );
+          if ( level > 0 )
+          {
+            ++_stats.levels;
+            continue;
+          }
+        }
+
+        extract_model();
+        _stats.cost = costs;
+        _state = state::success;
+        return _state;
+      }
+
+      auto core = _solver.get_core();
+      ++_stats.cores;
+      if ( core.size() > 1u )
+      {
+        auto const size = core.size();
+        if ( _ps.trim_cores > 0u )
+        {
+          trim_core( _solver, core, _ps.trim_cores );
+        }
+        if ( _ps.minimize_cores )
+        {
+          minimize_core( _solver, core, _ps.minimize_budget );
+        }
+        _stats.removed_literals += size - core.size();
+      }
+
+      int w_min = std::numeric_limits<int>::max();
+      for ( auto i = 0u; i < core.size(); ++i )
+      {
+        w_min = std::min( w_min, _literals[core[i]].weight );
+      }
+      costs += w_min;
+
+      if ( core.size() == 1u && !_literals[core[0u]].tree )
+      {
+        /* special case: unit core of a selector, which must be false */
+        auto& info = _literals[core[0u]];
+        add_clause( { -core[0u] } );
+        costs += info.weight - w_min;
+        info.weight = 0;
+        continue;
+      }
+
+      for ( auto i = 0u; i < core.size(); ++i )
+      {
+        _literals[core[i]].weight -= w_min;
+      }
+      cores.emplace_back( std::vector<int>( core ), w_min );
+    }
+
+    return state::fail;
+  }
+
+  std::vector<int> get_enabled_clauses() const
+  {
+    return _enabled_clauses;
+  }
+
+  std::vector<int> get_disabled_clauses() const
+  {
+    return _disabled_clauses;
+  }
+
+protected:
+  /* bookkeeping of a soft literal, i.e., a selector or the output of a sum */
+  struct literal_info
+  {
+    int weight = 0; /* remaining weight */
+    bool soft = false; /* the literal is a soft literal */
+    uint32_t bound = 0u; /* bound of the sum */
+    std::shared_ptr<totalizer_tree> tree; /* totalizer of the sum (nullptr for selectors) */
+  };
+
+  void add_weight( std::vector<int>& softs, int l, int weight )
+  {
+    auto& info = _literals[l];
+    if ( info.weight == 0 && weight > 0 )
+    {
+      softs.push_back( l );
+    }
+    info.weight += weight;
+  }
+
+  /* \brief Relaxes a core of weight w_min */
+  void relax_core( std::vector<int>& softs, std::vector<int> const& core, int w_min )
+  {
+    std::vector<int> rels;
+    for ( const auto& l : core )
+    {
+      rels.push_back( -l );
+
+      auto t = _literals[l].tree;
+      if ( !t )
+      {
+        continue;
+      }
+
+      /* the next output of the sum becomes soft */
+      auto const b = _literals[l].bound + 1u;
+      std::vector<std::vector<int>> clauses;
+      increase_totalizer( clauses, _sid, t, b );
+      for ( const auto& c : clauses )
+      {
+        add_clause( c );
+      }
+
+      if ( b < t->vars.size() )
+      {
+        auto const lnew = -t->vars[b];
+        auto& info = _literals[lnew];
+        info.soft = true;
+        info.tree = t;
+        info.bound = b;
+        add_weight( softs, lnew, w_min );
+      }
+    }
+
+    if ( rels.size() > 1u )
+    {
+      std::vector<std::vector<int>> clauses;
+      auto t = create_totalizer( clauses, _sid, rels, 1u );
+      for ( const auto& c : clauses )
+      {
+        add_clause( c );
+      }
+
+      auto const lnew = -t->vars[1u];
+      auto& info = _literals[lnew];
+      info.soft = true;
+      info.tree = t;
+      info.bound = 1u;
+      add_weight( softs, lnew, w_min );
+    }
+  }
+
+  int next_level( std::vector<int> const& softs, int level )
+  {
+    std::vector<int> weights;
+    for ( const auto& l : softs )
+    {
+      weights.push_back( _literals[l].weight );
+    }
+    return detail::next_weight_level( weights, level, _ps.diversity_ratio );
+  }
+
+  /* a relaxed soft clause may still be satisfied by the model */
+  void extract_model()
+  {
+    auto const model = _solver.get_model();
+    for ( auto i = 0u; i < _soft_clauses.size(); ++i )
+    {
+      auto const& cl = _soft_clauses[i];
+      if ( std::any_of( std::begin( cl ), std::end( cl ), [&model]( int l ){ return model[l]; } ) )
+      {
+        _enabled_clauses.push_back( i );
+      }
+      else
+      {
+        _disabled_clauses.push_back( i );
+      }
+    }
+  }
+
+protected:
+  state _state = state::fresh;
+
+  maxsat_solver_statistics& _stats;
+  maxsat_solver_params const& _ps;
+  int& _sid;
+
+  sat_solver _solver;
+
+  std::vector<int> _enabled_clauses;
+  std::vector<int> _disabled_clauses;
+
+  std::vector<std::vector<int>> _soft_clauses;
+  std::vector<int> _weights;
+
+  detail::literal_table<literal_info> _literals;
+}; /* maxsat_solver<maxsat_oll> */
+
+template<>
+class maxsat_solver<maxsat_pmres>
+{
+public:
+  enum class state
+  {
+    fresh = 0,
+    success = 1,
+    fail = 2,
+  }; /* state */
+
+public:
+  /* \brief Constructor
+   *
+   * Constructs a MAXSAT-solver
+   *
+   * \param stats Statistics
+   * \param ps Parameters
+   */
+  explicit maxsat_solver( maxsat_solver_statistics& stats, maxsat_solver_params& ps, int& sid )
+    : _stats( stats )
+    , _ps( ps )
+    , _sid( sid )
+    , _solver( stats.sat, ps.sat )
+  {}
+
+  /* \brief Adds a hard clause to the solver
+   *
+   * \param clause Clause to be added
+   */
+  void add_clause( std::vector<int> const& clause )
+  {
+    _solver.add_clause( clause );
+  }
+
+  /* \brief Adds a hard XOR clause to the solver
+   *
+   * \param clause XOR clause to be added
+   * \param value Value of the XOR of the literals
+   */
+  void add_xor_clause( std::vector<int> const& clause, bool value = true )
+  {
+    _solver.add_xor_clause( clause, value );
+  }
+
+  /* \brief Adds a soft clause to the solver
+   *
+   * \param clause Soft clause to be added
+   *
+   * Returns the added activation variable.
+   */
+  int add_soft_clause( std::vector<int> const &clause, int weight = 1 )
+  {
+    auto id = _soft_clauses.size();
+    _soft_clauses.emplace_back( clause );
+    _weights.emplace_back( weight );
+    return id;
+  }
+
+  /*
+   * \brief PM-RES MAXSAT procedure
+   *
+   * Core-guided MAXSAT with MaxSAT resolution [1].  A core l_1, ...,
+   * l_k of weight w is replaced by the soft clauses l_i | d_{i-1}
+   * (i = 2, ..., k) of weight w, where d_1 = l_1 and d_i = d_{i-1} &
+   * l_i.  Unlike OLL, no cardinality constraints are created: each
+   * core adds k - 1 soft clauses with three literals and k - 2
+   * definitions.  Soft literals are stratified by weight as in RC2.
+   *
+   * [1] N. Narodytska, F. Bacchus, AAAI 2014, 2717-2723
+   */
+  state solve()
+  {
+    if ( _solver.solve() == sat2::sat_solver::state::unsat )
+    {
+      _state = state::fail;
+      return _state;
+    }
+
+    if ( _soft_clauses.size() == 0u )
+    {
+      _state = state::fail;
+      return _state;
+    }
+
+    /* add the soft clauses */
+    std::vector<int> softs;
+    for ( auto i = 0u; i < _soft_clauses.size(); ++i )
+    {
+      auto cl = _soft_clauses[i];
+
+      /* if clause is unit, selector variable is its literal (unless
+         the literal already selects another soft clause) */
+      int selector = cl[0u];
+      if ( cl.size() > 1 || _literals[selector].soft )
+      {
+        selector = _sid++;
+        cl.push_back( -selector );
+        add_clause( cl );
+      }
+
+      _literals[selector].soft = true;
+      add_weight( softs, selector, _weights[i] );
+    }
+
+    int64_t costs = 0;
+
+    int level = _ps.stratification ? next_level( softs, std::numeric_limits<int>::max() ) : 1;
+    ++_stats.levels;
+
+    for ( ;; )
+    {
+      /* assume the soft literals of the current level and drop relaxed ones */
+      std::vector<int> assumptions;
+      softs.erase( std::remove_if( std::begin( softs ), std::end( softs ),
+                                   [this]( int l ){ return _literals[l].weight == 0; } ),
+                   std::end( softs ) );
+      for ( const auto& l : softs )
+      {
+        if ( _literals[l].weight >= level )
+        {
+          assumptions.emplace_back( l );
+        }
+      }
+
+      ++_stats.iterations;
+      if ( _solver.solve( assumptions ) == sat2::sat_solver::state::sat )
+      {
+        if ( _ps.stratification )
+        {
+          level = next_level( softs, level );
+          if ( level > 0 )
+          {
+            ++_stats.levels;
+            continue;
+          }
+        }
+
+        extract_model();
+        _stats.cost = costs;
+        _state = state::success;
+        return _state;
+      }
+
+      auto core = _solver.get_core();
+      ++_stats.cores;
+      if ( core.size() > 1u )
+      {
+        auto const size = core.size();
+        if ( _ps.trim_cores > 0u )
+        {
+          trim_core( _solver, core, _ps.trim_cores );
+        }
+        if ( _ps.minimize_cores )
+        {
+          minimize_core( _solver, core, _ps.minimize_budget );
+        }
+        _stats.removed_literals += size - core.size();
+      }
+
+      int w_min = std::numeric_limits<int>::max();
+      for ( auto i = 0u; i < core.size(); ++i )
+      {
+        w_min = std::min( w_min, _literals[core[i]].weight );
+      }
+      costs += w_min;
+
+      if ( core.size() == 1u )
+      {
+        /* special case: unit core, the soft literal must be false */
+        auto& info = _literals[core[0u]];
+        add_clause( { -core[0u] } );
+        costs += info.weight - w_min;
+        info.weight = 0;
+        continue;
+      }
+
+      for ( auto i = 0u; i < core.size(); ++i )
+      {
+        _literals[core[i]].weight -= w_min;
+      }
+      resolve_core( softs, std::vector<int>( core ), w_min );
+    }
+
+    return state::fail;
+  }
+
+  std::vector<int> get_enabled_clauses() const
+  {
+    return _enabled_clauses;
+  }
+
+  std::vector<int> get_disabled_clauses() const
+  {
+    return _disabled_clauses;
+  }
+
+protected:
+  /* bookkeeping of a soft literal */
+  struct literal_info
+  {
+    int weight = 0; /* remaining weight */
+    bool soft = false; /* the literal is a soft literal */
+  };
+
+  void add_weight( std::vector<int>& softs, int l, int weight )
+  {
+    auto& info = _literals[l];
+    if ( info.weight == 0 && weight > 0 )
+    {
+      softs.push_back( l );
+    }
+    info.weight += weight;
+  }
+
+  /* \brief Replaces a core of weight w_min by its MaxSAT resolvents */
+  void resolve_core( std::vector<int>& softs, std::vector<int> const& core, int w_min )
+  {
+    auto d = core[0u];
+    for ( auto i = 1u; i < core.size(); ++i )
+    {
+      auto const l = core[i];
+
+      /* soft clause l_i | d_{i-1} */
+      auto const selector = _sid++;
+      add_clause( { l, d, -selector } );
+      _literals[selector].soft = true;
+      add_weight( softs, selector, w_min );
+
+      /* d_i = d_{i-1} & l_i */
+      if ( i + 1u < core.size() )
+      {
+        auto const d_new = _sid++;
+        add_clause( { -d_new, d } );
+        add_clause( { -d_new, l } );
+        add_clause( { d_new, -d, -l } );
+        d = d_new;
+      }
+    }
+  }
+
+  int next_level( std::vector<int> const& softs, int level )
+  {
+    std::vector<int> weights;
+    for ( const auto& l : softs )
+    {
+      weights.push_back( _literals[l].weight );
+    }
+    return detail::next_weight_level( weights, level, _ps.diversity_ratio );
+  }
+
+  /* a relaxed soft clause may still be satisfied by the model */
+  void extract_model()
+  {
+    auto const model = _solver.get_model();
+    for ( auto i = 0u; i < _soft_clauses.size(); ++i )
+    {
+      auto const& cl = _soft_clauses[i];
+      if ( std::any_of( std::begin( cl ), std::end( cl ), [&model]( int l ){ return model[l]; } ) )
+      {
+        _enabled_clauses.push_back( i );
+      }
+      else
+      {
+        _disabled_clauses.push_back( i );
+      }
+    }
+  }
+
+protected:
+  state _state = state::fresh;
+
+  maxsat_solver_statistics& _stats;
+  maxsat_solver_params const& _ps;
+  int& _sid;
+
+  sat_solver _solver;
+
+  std::vector<int> _enabled_clauses;
+  std::vector<int> _disabled_clauses;
+
+  std::vector<std::vector<int>> _soft_clauses;
+  std::vector<int> _weights;
+
+  detail::literal_table<literal_info> _literals;
+}; /* maxsat_solver<maxsat_pmres> */
+
+template<>
+class maxsat_solver<maxsat_lsu>
+{
+public:
+  enum class state
+  {
+    fresh = 0,
+    success = 1,
+    fail = 2,
+    timeout = 3, /* the budget was exceeded before the first solution */
+  }; /* state */
+
+public:
+  /* \brief Constructor
+   *
+   * Constructs a MAXSAT-solver
+   *
+   * \param stats Statistics
+   * \param ps Parameters
+   */
+  explicit maxsat_solver( maxsat_solver_statistics& stats, maxsat_solver_params& ps, int& sid )
+    : _stats( stats )
+    , _ps( ps )
+    , _sid( sid )
+    , _solver( stats.sat, ps.sat )
+  {}
+
+  /* \brief Adds a hard clause to the solver
+   *
+   * \param clause Clause to be added
+   */
+  void add_clause( std::vector<int> const& clause )
+  {
+    _solver.add_clause( clause );
+  }
+
+  /* \brief Adds a hard XOR clause to the solver
+   *
+   * \param clause XOR clause to be added
+   * \param value Value of the XOR of the literals
+   */
+  void add_xor_clause( std::vector<int> const& clause, bool value = true )
+  {
+    _solver.add_xor_clause( clause, value );
+  }
+
+  /* \brief Adds a soft clause to the solver
+   *
+   * \param clause Soft clause to be added
+   *
+   * Returns the added activation variable.
+   */
+  int add_soft_clause( std::vector<int> const &clause, int weight = 1 )
+  {
+    auto id = _soft_clauses.size();
+    _soft_clauses.emplace_back( clause );
+    _weights.emplace_back( weight );
+    return id;
+  }
+
+  /* \brief Sets a hint for the first solution
+   *
+   * The first SAT-solver call assumes the literals (e.g., a known
+   * solution) for at most one slice of conflicts and, if they
+   * contradict the hard clauses or the slice is exceeded, is repeated
+   * without them.  The literals are also the initial phases of the
+   * search.
+   */
+  void set_hint( std::vector<int> const& lits )
+  {
+    _hint = lits;
+    for ( const auto& l : lits )
+    {
+      _solver.set_phase( l );
+    }
+  }
+
+  /*
+   * \brief Anytime LSU MAXSAT procedure
+   *
+   * Linear SAT-UNSAT search: each model improves the best solution
+   * found so far (the incumbent), and the next SAT-solver call asks
+   * for a solution of smaller cost until the solver proves that none
+   * exists.  The cost is bounded by a cardinality constraint (see
+   * maxsat_solver_params::cardinality) if all soft clauses have the
+   * same weight, and otherwise by a pseudo-Boolean constraint over
+   * the weights divided by their gcd (see create_pb_constraint), whose
+   * size depends on the number of distinct sums of the weights rather
+   * than on the weights themselves.  Each improvement tightens the
+   * bound.
+   *
+   * With stratification, the search first minimizes the cost of the
+   * soft clauses of the highest weight levels (see
+   * detail::next_weight_level), which keeps the cardinality
+   * constraints small, and then lowers the level until all soft
+   * clauses are considered.  The incumbent is always rated by the cost of all soft clauses, and
+   * the decisions of the SAT-solver start from its phases.
+   *
+   * The search stops when the time limit or the conflict limit is
+   * exceeded.  Then the incumbent is returned and `optimal` is false
+   * in the statistics.  If the budget is exceeded before the first
+   * solution, the state is timeout, whereas fail means that the hard
+   * clauses are unsatisfiable.  `on_improvement` is called for each
+   * new incumbent.
+   */
+  state solve()
+  {
+    _start = std::chrono::steady_clock::now();
+    _conflicts = _solver.get_num_conflicts();
+
+    auto result = _hint.empty() ? sat2::sat_solver::state::unsat : solve_with_hint();
+    if ( result != sat2::sat_solver::state::sat )
+    {
+      result = solve_within_budget( {} );
+    }
+    if ( result == sat2::sat_solver::state::unsat )
+    {
+      _state = state::fail;
+      return _state;
+    }
+    if ( result != sat2::sat_solver::state::sat )
+    {
+      _state = state::timeout;
+      return _state;
+    }
+
+    if ( _soft_clauses.size() == 0u )
+    {
+      _state = state::fail;
+      return _state;
+    }
+
+    /* add the soft clauses */
+    std::vector<int> selectors;
+    detail::literal_table<uint8_t> is_selector;
+    for ( auto i = 0u; i < _soft_clauses.size(); ++i )
+    {
+      auto cl = _soft_clauses[i];
+
+      /* if clause is unit, selector variable is its literal (unless
+         the literal already selects another soft clause) */
+      int selector = cl[0u];
+      if ( cl.size() > 1 || is_selector[selector] )
+      {
+        selector = _sid++;
+        cl.push_back( -selector );
+        add_clause( cl );
+      }
+      selectors.push_back( selector );
+      is_selector[selector] = 1u;
+    }
+
+    improve( _solver.get_model() );
+
+    int level = _ps.stratification ? detail::next_weight_level( _weights, std::numeric_limits<int>::max(), _ps.diversity_ratio ) : 1;
+    while ( level > 0 )
+    {
+      ++_stats.levels;
+
+      /* soft clauses of the current level with their multiplicities */
+      int divisor = 0;
+      for ( auto i = 0u; i < _weights.size(); ++i )
+      {
+        if ( _weights[i] >= level )
+        {
+          divisor = std::gcd( divisor, _weights[i] );
+        }
+      }
+
+      std::vector<int> inputs;
+      std::vector<uint64_t> input_weights;
+      for ( auto i = 0u; i < _weights.size(); ++i )
+      {
+        if ( _weights[i] >= level )
+        {
+          inputs.emplace_back( -selectors[i] );
+          input_weights.emplace_back( _weights[i] / divisor );
+        }
+      }
+      auto const weighted = std::any_of( std::begin( input_weights ), std::end( input_weights ), []( uint64_t w ){ return w > 1u; } );
+
+      auto bound = level_cost( _incumbent, level, divisor );
+      if ( bound > 0u )
+      {
+        std::vector<std::vector<int>> clauses;
+        cardinality_constraint t;
+        pb_constraint pb;
+        if ( weighted )
+        {
+          pb = create_pb_constraint( clauses, _sid, inputs, input_weights, bound - 1u );
+        }
+        else
+        {
+          t = create_cardinality_constraint( clauses, _sid, inputs, uint32_t( bound - 1u ), _ps.cardinality );
+        }
+        for ( const auto& c : clauses )
+        {
+          add_clause( c );
+        }
+
+        while ( bound > 0u )
+        {
+          /* at most bound - 1 */
+          clauses.clear();
+          auto const assumptions = weighted ? bound_pb_constraint( pb, bound - 1u ) : bound_cardinality_constraint( clauses, _sid, t, uint32_t( bound - 1u ) );
+          for ( const auto& c : clauses )
+          {
+            add_clause( c );
+          }
+
+          ++_stats.iterations;
+          auto const result = solve_within_budget( assumptions );
+          if ( result == sat2::sat_solver::state::unsat )
+          {
+            break;
+          }
+          if ( result != sat2::sat_solver::state::sat )
+          {
+            /* budget exceeded, return the incumbent */
+            _state = state::success;
+            return _state;
+          }
+
+          auto const m = _solver.get_model();
+          improve( m );
+          bound = level_cost( m, level, divisor );
+        }
+      }
+
+      level = _ps.stratification ? detail::next_weight_level( _weights, level, _ps.diversity_ratio ) : 0;
+    }
+
+    _stats.optimal = true;
+    _state = state::success;
+    return _state;
+  }
+
+  std::vector<int> get_enabled_clauses() const
+  {
+    return _enabled_clauses;
+  }
+
+  std::vector<int> get_disabled_clauses() const
+  {
+    return _disabled_clauses;
+  }
+
+protected:
+  bool budget_exhausted() const
+  {
+    if ( _ps.conflict_limit >= 0 && int64_t( _solver.get_num_conflicts() - _conflicts ) >= _ps.conflict_limit )
+    {
+      return true;
+    }
+    if ( _ps.time_limit > 0.0 )
+    {
+      std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - _start;
+      return elapsed.count() >= _ps.time_limit;
+    }
+    return false;
+  }
+
+  /* \brief Solves under the hint within one slice of conflicts
+   *
+   * Returns the state dirty if the slice is exceeded, such that the
+   * remaining budget is left to the search without the hint.
+   */
+  sat2::sat_solver::state solve_with_hint()
+  {
+    auto slice = _ps.conflict_slice;
+    if ( _ps.conflict_limit >= 0 )
+    {
+      slice = std::min<int64_t>( slice, _ps.conflict_limit );
+    }
+
+    _solver.set_budget( slice );
+    auto const result = _solver.solve( _hint );
+    _solver.reset_budget();
+    return result;
+  }
+
+  /* \brief Solves in slices of conflicts until the budget is exceeded
+   *
+   * Returns the state dirty if the budget is exceeded.
+   */
+  sat2::sat_solver::state solve_within_budget( std::vector<int> const& assumptions )
+  {
+    if ( _ps.time_limit <= 0.0 && _ps.conflict_limit < 0 )
+    {
+      return _solver.solve( assumptions );
+    }
+
+    while ( !budget_exhausted() )
+    {
+      auto slice = _ps.conflict_slice;
+      if ( _ps.conflict_limit >= 0 )
+      {
+        slice = std::min<int64_t>( slice, _ps.conflict_limit - int64_t( _solver.get_num_conflicts() - _conflicts ) );
+      }
+
+      _solver.set_budget( slice );
+      auto const result = _solver.solve( assumptions );
+      _solver.reset_budget();
+      if ( result != sat2::sat_solver::state::dirty )
+      {
+        return result;
+      }
+    }
+    return sat2::sat_solver::state::dirty;
+  }
+
+  /* cost of the soft clauses with weight at least level in units of divisor */
+  uint64_t level_cost( sat2::model const& m, int level, int divisor ) const
+  {
+    uint64_t cost = 0u;
+    for ( auto i = 0u; i < _soft_clauses.size(); ++i )
+    {
+      if ( _weights[i] >= level && !satisfied( m, _soft_clauses[i] ) )
+      {
+        cost += _weights[i] / divisor;
+      }
+    }
+    return cost;
+  }
+
+  /* variables that do not occur in the solver yet are false */
+  static bool satisfied( sat2::model const& m, std::vector<int> const& clause )
+  {
+    return std::any_of( std::begin( clause ), std::end( clause ), [&m]( int l ){
+      return uint32_t( std::abs( l ) ) <= m.size() ? m[l] : l < 0;
+    } );
+  }
+
+  /* \brief Updates the incumbent if the model has a smaller cost */
+  void improve( sat2::model const& m )
+  {
+    int64_t cost = 0;
+    for ( auto i = 0u; i < _soft_clauses.size(); ++i )
+    {
+      if ( !satisfied( m, _soft_clauses[i] ) )
+      {
+        cost += _weights[i];
+      }
+    }
+    if ( _stats.improvements > 0u && cost >= _stats.cost )
+    {
+      return;
+    }
+
+    ++_stats.improvements;
+    _stats.cost = cost;
+    _incumbent = m;
+
+    _enabled_clauses.clear();
+    _disabled_clauses.clear();
+    for ( auto i = 0u; i < _soft_clauses.size(); ++i )
+    {
+      ( satisfied( m, _soft_clauses[i] ) ? _enabled_clauses : _disabled_clauses ).push_back( i );
+    }
+
+    /* continue the search from the incumbent */
+    for ( auto v = 1u; v <= m.size(); ++v )
+    {
+      _solver.set_phase( m[v] ? int( v ) : -int( v ) );
+    }
+
+    if ( _ps.on_improvement )
+    {
+      _ps.on_improvement( cost, _disabled_clauses );
+    }
+  }
+
+protected:
+  state _state = state::fresh;
+
+  maxsat_solver_statistics& _stats;
+  maxsat_solver_params const& _ps;
+  int& _sid;
+
+  sat_solver _solver;
+
+  std::vector<int> _enabled_clauses;
+  std::vector<int> _disabled_clauses;
+
+  std::vector<std::vector<int>> _soft_clauses;
+  std::vector<int> _weights;
+
+  sat2::model _incumbent;
+  std::vector<int> _hint;
+  std::chrono::steady_clock::time_point _start;
+  uint64_t _conflicts = 0u;
+}; /* maxsat_solver<maxsat_lsu> */
+
 } /* easy::sat2 */
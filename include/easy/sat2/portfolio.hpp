@@ -0,0 +1,759 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file portfolio.hpp
+  \brief Portfolio of SAT-solvers racing on the same problem
+
+  \author Heinz Riener
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <bill/bill.hpp>
+
+namespace easy::sat2
+{
+
+/*! \brief SAT-solvers shipped with bill */
+enum class solver_backend
+{
+  glucose = 0,
+  ghack = 1, /*>! Ignores conflict budgets and interrupts */
+  maple = 2, /*>! Ignores conflict budgets and interrupts */
+  bsat2 = 3,
+}; /* solver_backend */
+
+/*! \brief Initial polarity of the decision variables */
+enum class phase_mode
+{
+  standard = 0, /*>! Default of the backend */
+  positive = 1,
+  negative = 2,
+  random = 3, /*>! Random initial polarity (drawn from the seed) */
+}; /* phase_mode */
+
+inline std::string to_string( solver_backend backend )
+{
+  switch ( backend )
+  {
+  case solver_backend::glucose:
+    return "glucose";
+  case solver_backend::ghack:
+    return "ghack";
+  case solver_backend::maple:
+    return "maple";
+  case solver_backend::bsat2:
+    return "bsat2";
+  default:
+    return "unknown";
+  }
+}
+
+inline std::string to_string( phase_mode phase )
+{
+  switch ( phase )
+  {
+  case phase_mode::standard:
+    return "standard";
+  case phase_mode::positive:
+    return "positive";
+  case phase_mode::negative:
+    return "negative";
+  case phase_mode::random:
+    return "random";
+  default:
+    return "unknown";
+  }
+}
+
+/*! \brief Configuration of one solver in a portfolio */
+struct portfolio_solver_config
+{
+  solver_backend backend = solver_backend::glucose; /*>! SAT-solver */
+  uint32_t seed = 0u; /*>! Seed of randomized decisions (0 keeps the backend's default behavior) */
+  phase_mode phase = phase_mode::standard; /*>! Initial polarity of the variables */
+}; /* portfolio_solver_config */
+
+inline std::string to_string( portfolio_solver_config const& config )
+{
+  auto name = to_string( config.backend );
+  if ( config.seed != 0u )
+  {
+    name += "/seed=" + std::to_string( config.seed );
+  }
+  if ( config.phase != phase_mode::standard )
+  {
+    name += "/phase=" + to_string( config.phase );
+  }
+  return name;
+}
+
+/*! \brief A diversified portfolio of `num_solvers` solvers
+ *
+ * Cycles through the interruptible backends; later rounds use
+ * different seeds and initial polarities.  GHack and Maple are not
+ * part of the default portfolio because they ignore conflict budgets
+ * and interrupts and thus always run to completion.
+ */
+inline std::vector<portfolio_solver_config> default_portfolio( uint32_t num_solvers = 4u )
+{
+  static constexpr solver_backend backends[] = {solver_backend::glucose, solver_backend::bsat2};
+  static constexpr phase_mode phases[] = {phase_mode::standard, phase_mode::random, phase_mode::positive, phase_mode::negative};
+
+  std::vector<portfolio_solver_config> configs;
+  for ( auto i = 0u; i < num_solvers; ++i )
+  {
+    auto const round = i / 2u;
+    configs.push_back( {backends[i % 2u], round == 0u ? 0u : 1u + i, phases[round % 4u]} );
+  }
+  return configs;
+}
+
+struct portfolio_statistics
+{
+  std::vector<std::string> names; /*>! Name of each solver in the portfolio */
+  std::vector<uint64_t> wins; /*>! Number of calls decided by each solver */
+  int32_t last_winner{-1}; /*>! Index of the solver that decided the last call (-1 if undecided) */
+  uint64_t num_calls{0}; /*>! Number of calls to solve */
+
+  /*! \brief Name of the solver that decided the last call */
+  std::string last_winner_name() const
+  {
+    return last_winner < 0 ? std::string( "none" ) : names[last_winner];
+  }
+}; /* portfolio_statistics */
+
+namespace detail
+{
+
+/*! \brief Interface of a SAT-solver in a portfolio
+ *
+ * Variables are 0-based; literals are DIMACS-style integers over the
+ * 1-based variable ids.
+ */
+class portfolio_backend
+{
+public:
+  enum class state
+  {
+    sat = 0,
+    unsat = 1,
+    unknown = 2,
+  }; /* state */
+
+public:
+  virtual ~portfolio_backend() = default;
+
+  virtual void add_variable( bool negative_phase ) = 0;
+  virtual void add_clause( std::vector<int> const& clause ) = 0;
+  virtual state solve( std::vector<int> const& assumptions, int64_t conflict_limit ) = 0;
+  virtual void interrupt() = 0;
+  virtual void clear_interrupt() = 0;
+  virtual bool model_value( uint32_t var ) const = 0;
+  virtual std::vector<int> core() const = 0;
+  virtual uint64_t num_conflicts() const = 0;
+}; /* portfolio_backend */
+
+/*! \brief Backend for the MiniSAT-like solvers (Glucose, GHack, Maple) */
+template<typename Solver, typename Lit, template<typename> class Vec, typename LBool>
+class minisat_backend : public portfolio_backend
+{
+public:
+  explicit minisat_backend( portfolio_solver_config const& config, LBool l_true, Lit ( *mk_lit )( int, bool ) )
+    : _solver( std::make_unique<Solver>() )
+    , _l_true( l_true )
+    , _mk_lit( mk_lit )
+  {
+    if ( config.seed != 0u )
+    {
+      /* randomize the initial activities such that the seed diversifies the search */
+      _solver->random_seed = double( config.seed );
+      _solver->rnd_init_act = true;
+    }
+  }
+
+  void add_variable( bool negative_phase ) override
+  {
+    auto const v = _solver->newVar();
+    _solver->setPolarity( v, negative_phase );
+  }
+
+  void add_clause( std::vector<int> const& clause ) override
+  {
+    Vec<Lit> lits;
+    for ( const auto& l : clause )
+    {
+      lits.push( _mk_lit( std::abs( l ) - 1, l < 0 ) );
+    }
+    _solver->addClause( lits );
+  }
+
+  state solve( std::vector<int> const& assumptions, int64_t conflict_limit ) override
+  {
+    Vec<Lit> lits;
+    for ( const auto& l : assumptions )
+    {
+      lits.push( _mk_lit( std::abs( l ) - 1, l < 0 ) );
+    }
+
+    if ( conflict_limit < 0 )
+    {
+      _solver->budgetOff();
+    }
+    else
+    {
+      _solver->setConfBudget( conflict_limit );
+    }
+
+    auto const result = _solver->solveLimited( lits );
+    if ( result == _l_true )
+    {
+      return state::sat;
+    }
+    else if ( result == LBool( uint8_t( 1 ) ) )
+    {
+      return state::unsat;
+    }
+    return state::unknown;
+  }
+
+  void interrupt() override
+  {
+    _solver->interrupt();
+  }
+
+  void clear_interrupt() override
+  {
+    _solver->clearInterrupt();
+  }
+
+  bool model_value( uint32_t var ) const override
+  {
+    return int32_t( var ) < _solver->model.size() && _solver->model[var] == _l_true;
+  }
+
+  std::vector<int> core() const override
+  {
+    /* the conflict consists of negated assumptions */
+    std::vector<int> lits;
+    for ( auto i = 0; i < _solver->conflict.size(); ++i )
+    {
+      auto const l = _solver->conflict[i];
+      lits.emplace_back( sign( l ) ? var( l ) + 1 : -( var( l ) + 1 ) );
+    }
+    return lits;
+  }
+
+  uint64_t num_conflicts() const override
+  {
+    return _solver->conflicts;
+  }
+
+protected:
+  std::unique_ptr<Solver> _solver;
+  LBool const _l_true;
+  Lit ( *_mk_lit )( int, bool );
+}; /* minisat_backend */
+
+/* bsat2 polls a stop callback between restarts on the solving thread;
+   since the callback only receives an integer id, the solving thread
+   publishes the stop flag of its backend for the duration of a call */
+inline thread_local std::atomic<bool> const* bsat2_stop_flag = nullptr;
+
+inline int bsat2_stop( int )
+{
+  return bsat2_stop_flag != nullptr && bsat2_stop_flag->load();
+}
+
+/*! \brief Backend for ABC's bsat2 */
+class bsat2_backend : public portfolio_backend
+{
+public:
+  explicit bsat2_backend( portfolio_solver_config const& config )
+    : _solver( pabc::sat_solver_new() )
+  {
+    if ( config.seed != 0u )
+    {
+      _solver->random_seed = double( config.seed );
+    }
+    pabc::sat_solver_set_stop_func( _solver, bsat2_stop );
+  }
+
+  ~bsat2_backend()
+  {
+    pabc::sat_solver_delete( _solver );
+  }
+
+  void add_variable( bool negative_phase ) override
+  {
+    auto const v = pabc::sat_solver_addvar( _solver );
+    _solver->polarity[v] = !negative_phase;
+  }
+
+  void add_clause( std::vector<int> const& clause ) override
+  {
+    std::vector<pabc::lit> lits;
+    for ( const auto& l : clause )
+    {
+      lits.emplace_back( pabc::Abc_Var2Lit( std::abs( l ) - 1, l < 0 ) );
+    }
+    if ( !pabc::sat_solver_addclause( _solver, lits.data(), lits.data() + lits.size() ) )
+    {
+      _ok = false;
+    }
+  }
+
+  state solve( std::vector<int> const& assumptions, int64_t conflict_limit ) override
+  {
+    if ( !_ok )
+    {
+      _core.clear();
+      return state::unsat;
+    }
+
+    std::vector<pabc::lit> lits;
+    for ( const auto& l : assumptions )
+    {
+      lits.emplace_back( pabc::Abc_Var2Lit( std::abs( l ) - 1, l < 0 ) );
+    }
+
+    bsat2_stop_flag = &_stop;
+    auto const result = pabc::sat_solver_solve( _solver, lits.data(), lits.data() + lits.size(), conflict_limit < 0 ? 0 : std::max<int64_t>( conflict_limit, 1 ), 0, 0, 0 );
+    bsat2_stop_flag = nullptr;
+    if ( result == 1 )
+    {
+      return state::sat;
+    }
+    else if ( result == -1 )
+    {
+      int* final_lits;
+      auto const size = pabc::sat_solver_final( _solver, &final_lits );
+      _core.clear();
+      for ( auto i = 0; i < size; ++i )
+      {
+        auto const v = pabc::Abc_Lit2Var( final_lits[i] );
+        _core.emplace_back( pabc::Abc_LitIsCompl( final_lits[i] ) ? v + 1 : -( v + 1 ) );
+      }
+      return state::unsat;
+    }
+    return state::unknown;
+  }
+
+  void interrupt() override
+  {
+    _stop = true;
+  }
+
+  void clear_interrupt() override
+  {
+    _stop = false;
+  }
+
+  bool model_value( uint32_t var ) const override
+  {
+    return int32_t( var ) < _solver->size && pabc::sat_solver_var_value( _solver, var );
+  }
+
+  std::vector<int> core() const override
+  {
+    return _core;
+  }
+
+  uint64_t num_conflicts() const override
+  {
+    return _solver->stats.conflicts;
+  }
+
+protected:
+  pabc::sat_solver* _solver;
+  std::atomic<bool> _stop{false};
+  bool _ok = true;
+  std::vector<int> _core;
+}; /* bsat2_backend */
+
+inline std::unique_ptr<portfolio_backend> make_backend( portfolio_solver_config const& config )
+{
+  switch ( config.backend )
+  {
+  case solver_backend::ghack:
+    return std::make_unique<minisat_backend<GHack::Solver, GHack::Lit, GHack::vec, GHack::lbool>>( config, GHack::l_True, []( int v, bool s ) { return GHack::mkLit( v, s ); } );
+  case solver_backend::maple:
+    return std::make_unique<minisat_backend<Maple::Solver, Maple::Lit, Maple::vec, Maple::lbool>>( config, Maple::l_True, []( int v, bool s ) { return Maple::mkLit( v, s ); } );
+  case solver_backend::bsat2:
+    return std::make_unique<bsat2_backend>( config );
+  case solver_backend::glucose:
+  default:
+    return std::make_unique<minisat_backend<Glucose::Solver, Glucose::Lit, Glucose::vec, Glucose::lbool>>( config, Glucose::l_True, []( int v, bool s ) { return Glucose::mkLit( v, s ); } );
+  }
+}
+
+} /* namespace detail */
+
+/*! \brief Portfolio of SAT-solvers
+ *
+ * All solvers receive the same clauses.  Each call to solve runs the
+ * solvers on separate threads; the first solver with a definitive
+ * answer (SAT or UNSAT) wins and cooperatively interrupts the others.
+ * The model and core are taken from the winner.  Since the solvers
+ * are kept alive, they stay incremental across calls.  Each solver
+ * has its own worker thread for the lifetime of the portfolio, which
+ * waits for the next call.  A call returns only when all solvers
+ * stopped: bsat2 notices an interrupt at its next restart, GHack and
+ * Maple not at all.
+ *
+ * Only Glucose supports native XOR-propagation, hence XOR-clauses are
+ * translated into clauses for all solvers.
+ */
+class portfolio_solver
+{
+public:
+  enum class state
+  {
+    sat = 0,
+    unsat = 1,
+    unknown = 2,
+  }; /* state */
+
+public:
+  explicit portfolio_solver( std::vector<portfolio_solver_config> const& configs, portfolio_statistics& stats )
+    : _configs( configs )
+    , _stats( stats )
+  {
+    assert( !_configs.empty() );
+
+    _stats.names.clear();
+    _stats.wins.assign( _configs.size(), 0u );
+    for ( const auto& config : _configs )
+    {
+      _backends.emplace_back( detail::make_backend( config ) );
+      _random.emplace_back( config.seed );
+      _stats.names.emplace_back( to_string( config ) );
+    }
+
+    _results.assign( _backends.size(), detail::portfolio_backend::state::unknown );
+    if ( _backends.size() > 1u )
+    {
+      for ( auto i = 0u; i < _backends.size(); ++i )
+      {
+        _workers.emplace_back( [this, i]() { work( i ); } );
+      }
+    }
+  }
+
+  ~portfolio_solver()
+  {
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      _shutdown = true;
+    }
+    _round_started.notify_all();
+    for ( auto& t : _workers )
+    {
+      t.join();
+    }
+  }
+
+  portfolio_solver( portfolio_solver const& ) = delete;
+  portfolio_solver& operator=( portfolio_solver const& ) = delete;
+
+  /*! \brief Adds a clause over (1-based) variables */
+  void add_clause( std::vector<int> const& clause )
+  {
+    auto const lits = map_literals( clause );
+    for ( auto& b : _backends )
+    {
+      b->add_clause( lits );
+    }
+  }
+
+  /*! \brief Adds the constraint that the XOR of the literals equals value */
+  void add_xor_clause( std::vector<int> const& clause, bool value = true )
+  {
+    if ( clause.empty() )
+    {
+      if ( value )
+      {
+        add_internal_clause( {} );
+      }
+      return;
+    }
+
+    auto lits = map_literals( clause );
+    while ( lits.size() > 1u )
+    {
+      auto const a = lits[lits.size() - 2u];
+      auto const b = lits[lits.size() - 1u];
+      auto const c = int( new_variable() ) + 1;
+      add_internal_clause( {-a, -b, -c} );
+      add_internal_clause( {a, b, -c} );
+      add_internal_clause( {a, -b, c} );
+      add_internal_clause( {-a, b, c} );
+      lits.pop_back();
+      lits.back() = c;
+    }
+    add_internal_clause( {value ? lits[0u] : -lits[0u]} );
+  }
+
+  /*! \brief Races all solvers under assumptions
+   *
+   * \param assumptions Assumption literals
+   * \param conflict_limit Conflict limit of each solver (< 0 for no limit)
+   */
+  state solve( std::vector<int> const& assumptions = {}, int64_t conflict_limit = -1 )
+  {
+    _assumptions = map_literals( assumptions );
+    _conflict_limit = conflict_limit;
+    ++_stats.num_calls;
+
+    std::vector<uint64_t> conflicts_before;
+    for ( const auto& b : _backends )
+    {
+      conflicts_before.emplace_back( b->num_conflicts() );
+    }
+
+    std::fill( _results.begin(), _results.end(), detail::portfolio_backend::state::unknown );
+    _race_winner = -1;
+
+    if ( _backends.size() == 1u )
+    {
+      run( 0u );
+    }
+    else
+    {
+      {
+        std::unique_lock<std::mutex> lock( _mutex );
+        ++_round;
+        _running = uint32_t( _backends.size() );
+        _round_started.notify_all();
+        _round_finished.wait( lock, [this]() { return _running == 0u; } );
+      }
+      for ( auto& b : _backends )
+      {
+        b->clear_interrupt();
+      }
+    }
+
+    _winner = _race_winner.load();
+    _stats.last_winner = _winner;
+    if ( _winner < 0 )
+    {
+      return ( _state = state::unknown );
+    }
+
+    ++_stats.wins[_winner];
+    _conflicts += _backends[_winner]->num_conflicts() - conflicts_before[_winner];
+    return ( _state = _results[_winner] == detail::portfolio_backend::state::sat ? state::sat : state::unsat );
+  }
+
+  /*! \brief Returns the model of the winner (bit i is the value of variable i + 1) */
+  std::vector<bool> get_model() const
+  {
+    assert( _state == state::sat );
+
+    std::vector<bool> m( _internal.size() );
+    for ( auto v = 0u; v < _internal.size(); ++v )
+    {
+      m[v] = _internal[v] != 0u && _backends[_winner]->model_value( _internal[v] - 1u );
+    }
+    return m;
+  }
+
+  /*! \brief Returns the assumptions in the core of the winner */
+  std::vector<int> get_core() const
+  {
+    assert( _state == state::unsat );
+
+    std::vector<int> lits;
+    for ( const auto& l : _backends[_winner]->core() )
+    {
+      auto const v = _external[std::abs( l ) - 1];
+      assert( v != 0u );
+      lits.emplace_back( l < 0 ? -int( v ) : int( v ) );
+    }
+    return lits;
+  }
+
+  /*! \brief Number of conflicts summed over the winners of all calls */
+  uint64_t num_conflicts() const
+  {
+    return _conflicts;
+  }
+
+  /*! \brief Number of (1-based) variables used in clauses or assumptions */
+  uint32_t num_variables() const
+  {
+    return _internal.size();
+  }
+
+protected:
+  /* runs solver i on the current call; the first definitive answer wins */
+  void run( uint32_t i )
+  {
+    _results[i] = _backends[i]->solve( _assumptions, _conflict_limit );
+    if ( _results[i] == detail::portfolio_backend::state::unknown )
+    {
+      return;
+    }
+
+    int32_t expected = -1;
+    if ( _race_winner.compare_exchange_strong( expected, int32_t( i ) ) )
+    {
+      for ( auto j = 0u; j < _backends.size(); ++j )
+      {
+        if ( j != i )
+        {
+          _backends[j]->interrupt();
+        }
+      }
+    }
+  }
+
+  /* worker thread of solver i: runs it once per call until the portfolio is destroyed */
+  void work( uint32_t i )
+  {
+    uint64_t round = 0u;
+    while ( true )
+    {
+      {
+        std::unique_lock<std::mutex> lock( _mutex );
+        _round_started.wait( lock, [&]() { return _shutdown || _round != round; } );
+        if ( _shutdown )
+        {
+          return;
+        }
+        round = _round;
+      }
+
+      run( i );
+
+      {
+        std::lock_guard<std::mutex> lock( _mutex );
+        if ( --_running == 0u )
+        {
+          _round_finished.notify_one();
+        }
+      }
+    }
+  }
+
+  /* returns the 0-based internal variable of a new variable */
+  uint32_t new_variable()
+  {
+    auto const v = uint32_t( _external.size() );
+    _external.emplace_back( 0u );
+    for ( auto i = 0u; i < _backends.size(); ++i )
+    {
+      /* all backends prefer the negative phase by default */
+      auto negative = _configs[i].phase != phase_mode::positive;
+      if ( _configs[i].phase == phase_mode::random )
+      {
+        negative = _random[i]() & 1u;
+      }
+      _backends[i]->add_variable( negative );
+    }
+    return v;
+  }
+
+  std::vector<int> map_literals( std::vector<int> const& lits )
+  {
+    std::vector<int> mapped;
+    for ( const auto& l : lits )
+    {
+      uint32_t const v = std::abs( l );
+      if ( _internal.size() < v )
+      {
+        _internal.resize( v, 0u );
+      }
+      if ( _internal[v - 1u] == 0u )
+      {
+        auto const w = new_variable();
+        _internal[v - 1u] = w + 1u;
+        _external[w] = v;
+      }
+      mapped.emplace_back( l < 0 ? -int( _internal[v - 1u] ) : int( _internal[v - 1u] ) );
+    }
+    return mapped;
+  }
+
+  void add_internal_clause( std::vector<int> const& clause )
+  {
+    for ( auto& b : _backends )
+    {
+      b->add_clause( clause );
+    }
+  }
+
+protected:
+  std::vector<portfolio_solver_config> const _configs;
+  portfolio_statistics& _stats;
+  std::vector<std::unique_ptr<detail::portfolio_backend>> _backends;
+  std::vector<std::mt19937> _random;
+
+  /* 1-based internal variable of each external variable (0 if unused) */
+  std::vector<uint32_t> _internal;
+
+  /* external variable of each internal variable (0 for auxiliary variables) */
+  std::vector<uint32_t> _external;
+
+  state _state = state::unknown;
+  int32_t _winner = -1;
+  uint64_t _conflicts = 0u;
+
+  /* the current call, shared with the workers */
+  std::vector<int> _assumptions;
+  int64_t _conflict_limit = -1;
+  std::vector<detail::portfolio_backend::state> _results;
+  std::atomic<int32_t> _race_winner{-1};
+
+  std::vector<std::thread> _workers;
+  std::mutex _mutex;
+  std::condition_variable _round_started;
+  std::condition_variable _round_finished;
+  uint64_t _round = 0u;
+  uint32_t _running = 0u;
+  bool _shutdown = false;
+}; /* portfolio_solver */
+
+} /* namespace easy::sat2 */
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
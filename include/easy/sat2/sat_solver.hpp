@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include <easy/sat2/portfolio.hpp>
+#include <easy/sat2/xor_propagator.hpp>
 #include <easy/utils/dynamic_bitset.hpp>
 
 #include <bill/bill.hpp>
@@ -198,11 +200,15 @@ protected:
 
 struct sat_solver_statistics
 {
+  portfolio_statistics portfolio; /*>! Statistics of the solver portfolio (if used) */
 };
 
 struct sat_solver_params
 {
   mutable int64_t budget{-1}; /*>! Conflict budget (a value < 0 denotes an unconstrained budget) */
+
+  /*! Race these solvers on separate threads instead of using Glucose alone (see portfolio_solver) */
+  std::vector<portfolio_solver_config> portfolio;
 };
 
 class sat_solver
@@ -244,6 +250,29 @@ public:
     _glucose->budgetOff();
   }
 
+  /* \brief Returns the number of conflicts of Glucose so far */
+  uint64_t get_num_conflicts() const
+  {
+    return _glucose->conflicts;
+  }
+
+  /* \brief Prefers a literal in the decisions of Glucose
+   *
+   * Sets the saved phase of the literal's variable, which is updated
+   * again by phase saving during search.
+   */
+  void set_phase( int lit )
+  {
+    assert( lit != 0 );
+    uint32_t const v = abs( lit ) - 1;
+    while ( _num_variables <= v )
+    {
+      _glucose->newVar();
+      ++_num_variables;
+    }
+    _glucose->setPolarity( v, lit < 0 );
+  }
+
   /*! \brief Return the current state of the SAT-solver */
   state get_state() const
   {
@@ -282,7 +311,13 @@ public:
    */
   state solve_unlimited( std::vector<int> const& assumptions = {} )
   {
+    if ( auto p = get_portfolio() )
+    {
+      return solve_portfolio( *p, assumptions, -1 );
+    }
+
     _glucose->budgetOff();
+    prepare_xor_clauses();
 
     Glucose::vec<Glucose::Lit> ass;
     if ( assumptions.size() > 0 )
@@ -318,6 +353,13 @@ public:
    */
   state solve_limited( std::vector<int> const& assumptions = {} )
   {
+    if ( auto p = get_portfolio() )
+    {
+      return solve_portfolio( *p, assumptions, _ps.budget );
+    }
+
+    prepare_xor_clauses();
+
     Glucose::vec<Glucose::Lit> ass;
     if ( assumptions.size() > 0 )
     {
@@ -333,8 +375,9 @@ public:
       }
     }
 
+    /* the budget is relative to the conflicts when it was set */
     auto const result = _glucose->solveLimited( ass );
-    if ( result == Glucose::l_Undef || int32_t(_glucose->conflicts) >= _ps.budget )
+    if ( result == Glucose::l_Undef )
     {
       return ( _state = state::dirty );
     }
@@ -355,6 +398,13 @@ public:
     /* update state */
     _state = state::dirty;
 
+    if ( auto p = get_portfolio() )
+    {
+      update_num_variables( clause );
+      p->add_clause( clause );
+      return;
+    }
+
     Glucose::vec<Glucose::Lit> cl;
     for ( const auto& l : clause )
     {
@@ -369,13 +419,58 @@ public:
     _glucose->addClause( cl );
   }
 
+  /*! \brief Add an XOR clause to the SAT-solver
+   *
+   * The XOR of the literals in `clause` must be equal to `value`.
+   * XOR clauses are not translated into CNF, but are propagated with
+   * Gauss-Jordan elimination during search (see `xor_propagator`).
+   */
+  void add_xor_clause( std::vector<int> const& clause, bool value = true )
+  {
+    /* update state */
+    _state = state::dirty;
+
+    if ( auto p = get_portfolio() )
+    {
+      update_num_variables( clause );
+      p->add_xor_clause( clause, value );
+      return;
+    }
+
+    for ( const auto& l : clause )
+    {
+      const uint32_t v = abs( l ) - 1;
+      while ( _num_variables <= v )
+      {
+        _glucose->newVar();
+        ++_num_variables;
+      }
+    }
+
+    if ( !_xor )
+    {
+      _xor = std::make_unique<xor_propagator>();
+    }
+    _xor->add_xor_clause( clause, value );
+    _xor_dirty = true;
+  }
+
   /*! \brief Returns model if solver is in state SAT */
   model get_model() const
   {
     assert( is_sat() );
 
-    const uint32_t size = _glucose->model.size();
     utils::dynamic_bitset<> m;
+    if ( _portfolio )
+    {
+      for ( const auto& b : _portfolio->get_model() )
+      {
+        m.push_back( b );
+      }
+      return model( m );
+    }
+
+    const uint32_t size = _glucose->model.size();
     for ( auto i = 0u; i < size; ++i )
     {
       m.push_back( _glucose->model[i] == Glucose::l_True );
@@ -388,6 +483,11 @@ public:
   {
     assert( is_unsat() );
 
+    if ( _portfolio )
+    {
+      return core( _portfolio->get_core() );
+    }
+
     const uint32_t size = _glucose->conflict.size();
     std::vector<int> lits( size );
     for ( auto i = 0u; i < size; ++i )
@@ -415,12 +515,73 @@ public:
     return _state == state::unsat;
   }
 
+protected:
+  /* creates the portfolio on first use if one is configured */
+  portfolio_solver* get_portfolio()
+  {
+    if ( !_portfolio && !_ps.portfolio.empty() )
+    {
+      _portfolio = std::make_unique<portfolio_solver>( _ps.portfolio, _stats.portfolio );
+    }
+    return _portfolio.get();
+  }
+
+  void update_num_variables( std::vector<int> const& lits )
+  {
+    for ( const auto& l : lits )
+    {
+      _num_variables = std::max( _num_variables, uint32_t( abs( l ) ) );
+    }
+  }
+
+  state solve_portfolio( portfolio_solver& p, std::vector<int> const& assumptions, int64_t budget )
+  {
+    update_num_variables( assumptions );
+    switch ( p.solve( assumptions, budget ) )
+    {
+    case portfolio_solver::state::sat:
+      return ( _state = state::sat );
+    case portfolio_solver::state::unsat:
+      return ( _state = state::unsat );
+    default:
+      return ( _state = state::dirty );
+    }
+  }
+
+  /* (re-)builds the XOR matrix if XOR clauses have been added */
+  void prepare_xor_clauses()
+  {
+    if ( !_xor_dirty )
+    {
+      return;
+    }
+    _xor_dirty = false;
+
+    std::vector<int> units;
+    if ( !_xor->build( units ) )
+    {
+      _glucose->addEmptyClause();
+      return;
+    }
+
+    for ( const auto& l : units )
+    {
+      _glucose->addClause( Glucose::mkLit( abs( l ) - 1, l < 0 ) );
+    }
+    _glucose->setExternalPropagator( _xor->num_rows() > 0 ? _xor.get() : nullptr );
+  }
+
 protected:
   std::unique_ptr<Glucose::Solver> _glucose;
   sat_solver_statistics& _stats;
   sat_solver_params const& _ps;
   state _state{state::fresh};
   uint32_t _num_variables{0};
+
+  std::unique_ptr<xor_propagator> _xor;
+  bool _xor_dirty{false};
+
+  std::unique_ptr<portfolio_solver> _portfolio;
 }; /* sat_solver */
 
 } /* namespace easy::sat2 */
@@ -0,0 +1,525 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file xor_propagator.hpp
+  \brief Gauss-Jordan propagation of XOR constraints inside Glucose
+
+  \author Heinz Riener
+*/
+
+#pragma once
+
+#include <easy/utils/gf2_matrix.hpp>
+
+#include <bill/bill.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace easy::sat2
+{
+
+/*! \brief Native XOR reasoning for Glucose
+ *
+ * Keeps a system of XOR constraints as a bit-packed matrix over
+ * GF(2) in reduced row echelon form and propagates it during search
+ * instead of translating each XOR constraint into a Tseitin chain.
+ *
+ * Every row has a basic variable, which occurs in no other row, and
+ * a watched non-basic variable.  If the watched variable is
+ * assigned, another unassigned non-basic variable is searched.  If
+ * the basic variable is assigned, the row is pivoted on an
+ * unassigned non-basic variable, i.e., the row is added to all other
+ * rows containing that variable.  A row without unassigned
+ * non-basic variables implies its basic variable or is in conflict.
+ * Due to the pivoting, implications of linear combinations of the
+ * XOR constraints are found (Gauss-Jordan propagation).  The matrix
+ * is not restored on backtracking, since every reduced form of the
+ * system is equivalent.
+ *
+ * Reasons and conflicts are reported to the solver as clauses, which
+ * are added as learnt clauses.
+ */
+class xor_propagator : public Glucose::ExternalPropagator
+{
+public:
+  using word_type = uint64_t;
+
+public:
+  /*! \brief Adds an XOR constraint
+   *
+   * The XOR of the literals in `clause` must be equal to `value`.
+   * Must be followed by a call to `build()`.
+   */
+  void add_xor_clause( std::vector<int> const& clause, bool value = true )
+  {
+    for ( const auto& l : clause )
+    {
+      assert( l != 0 );
+      if ( l < 0 )
+      {
+        value = !value;
+      }
+    }
+    _xor_clauses.emplace_back( clause );
+    _xor_values.emplace_back( value );
+  }
+
+  /*! \brief Number of XOR constraints added */
+  uint32_t num_xor_clauses() const
+  {
+    return _xor_clauses.size();
+  }
+
+  /*! \brief Number of rows after Gauss-Jordan elimination */
+  uint32_t num_rows() const
+  {
+    return _basic.size();
+  }
+
+  /*! \brief Number of pivot operations performed during search */
+  uint64_t num_pivots() const
+  {
+    return _num_pivots;
+  }
+
+  /*! \brief Number of implied literals found during search */
+  uint64_t num_propagations() const
+  {
+    return _num_propagations;
+  }
+
+  /*! \brief Builds the matrix from the XOR constraints
+   *
+   * Brings the matrix into reduced row echelon form.  Rows with a
+   * single variable are not kept in the matrix but are returned as
+   * unit literals.
+   *
+   * Returns false if and only if the XOR constraints are
+   * inconsistent.
+   */
+  bool build( std::vector<int>& units )
+  {
+    /* columns, ordered by number of occurrences */
+    std::vector<uint32_t> occurrences;
+    for ( const auto& c : _xor_clauses )
+    {
+      for ( const auto& l : c )
+      {
+        uint32_t const v = abs( l ) - 1;
+        if ( v >= occurrences.size() )
+        {
+          occurrences.resize( v + 1, 0u );
+        }
+        ++occurrences[v];
+      }
+    }
+
+    _col_to_var.clear();
+    for ( auto v = 0u; v < occurrences.size(); ++v )
+    {
+      if ( occurrences[v] > 0u )
+      {
+        _col_to_var.emplace_back( v );
+      }
+    }
+    std::stable_sort( _col_to_var.begin(), _col_to_var.end(), [&]( uint32_t a, uint32_t b ){ return occurrences[a] < occurrences[b]; } );
+
+    _var_to_col.assign( occurrences.size(), -1 );
+    for ( auto i = 0u; i < _col_to_var.size(); ++i )
+    {
+      _var_to_col[_col_to_var[i]] = i;
+    }
+
+    /* Gauss-Jordan elimination, the last column is the right-hand side */
+    uint32_t const num_cols = _col_to_var.size();
+    utils::gf2_matrix m( _xor_clauses.size(), num_cols + 1u );
+    for ( auto r = 0u; r < _xor_clauses.size(); ++r )
+    {
+      for ( const auto& l : _xor_clauses[r] )
+      {
+        m.flip( r, _var_to_col[abs( l ) - 1] );
+      }
+      m.set( r, num_cols, _xor_values[r] );
+    }
+    auto const pivots = m.reduced_row_echelon_form( num_cols );
+
+    /* remaining rows are zero */
+    for ( auto r = pivots.size(); r < m.num_rows(); ++r )
+    {
+      if ( m.get( r, num_cols ) )
+      {
+        return false;
+      }
+    }
+
+    /* move rows with at least two variables into the propagator */
+    std::vector<uint32_t> rows;
+    for ( auto r = 0u; r < pivots.size(); ++r )
+    {
+      auto size = 0u;
+      m.foreach_one( r, [&]( uint32_t ){ ++size; } );
+      if ( size - m.get( r, num_cols ) == 1u )
+      {
+        int const var = _col_to_var[pivots[r]] + 1;
+        units.emplace_back( m.get( r, num_cols ) ? var : -var );
+      }
+      else
+      {
+        rows.emplace_back( r );
+      }
+    }
+
+    _rows = utils::gf2_matrix( rows.size(), num_cols );
+    _num_words = _rows.num_words();
+    _rhs.clear();
+    _basic.clear();
+    _watch.clear();
+    _basic_row.assign( num_cols, -1 );
+    _watches.assign( num_cols, {} );
+    for ( const auto& r : rows )
+    {
+      uint32_t const index = _basic.size();
+      std::copy_n( m.row( r ), _num_words, _rows.row( index ) );
+      _rhs.emplace_back( m.get( r, num_cols ) );
+      if ( num_cols % 64 != 0 )
+      {
+        _rows.row( index )[_num_words - 1] &= ( word_type( 1 ) << ( num_cols % 64 ) ) - 1;
+      }
+
+      _basic.emplace_back( pivots[r] );
+      _basic_row[pivots[r]] = index;
+      _watch.emplace_back( 0u );
+      _watch[index] = find_nonbasic( index );
+      _watches[_watch[index]].emplace_back( index );
+    }
+
+    _assigned.assign( _num_words, 0 );
+    _values.assign( _num_words, 0 );
+    _queue.clear();
+    _qhead = 0;
+    _pending.clear();
+    _conflict = false;
+    return true;
+  }
+
+public:
+  void notifyAssignment( Glucose::Lit p ) override
+  {
+    auto const v = Glucose::var( p );
+    if ( v >= int( _var_to_col.size() ) || _var_to_col[v] == -1 )
+    {
+      return;
+    }
+
+    uint32_t const col = _var_to_col[v];
+    _assigned[col >> 6] |= word_type( 1 ) << ( col & 63 );
+    if ( !Glucose::sign( p ) )
+    {
+      _values[col >> 6] |= word_type( 1 ) << ( col & 63 );
+    }
+    _queue.emplace_back( col );
+  }
+
+  void notifyBacktrack( Glucose::Lit p ) override
+  {
+    /* all unprocessed assignments and implications belong to the backtracked levels */
+    _queue.clear();
+    _qhead = 0;
+    _pending.clear();
+    _conflict = false;
+
+    auto const v = Glucose::var( p );
+    if ( v >= int( _var_to_col.size() ) || _var_to_col[v] == -1 )
+    {
+      return;
+    }
+
+    uint32_t const col = _var_to_col[v];
+    _assigned[col >> 6] &= ~( word_type( 1 ) << ( col & 63 ) );
+    _values[col >> 6] &= ~( word_type( 1 ) << ( col & 63 ) );
+  }
+
+  bool propagate( Glucose::vec<Glucose::Lit>& out ) override
+  {
+    while ( _pending.empty() && _qhead < _queue.size() )
+    {
+      process( _queue[_qhead++] );
+    }
+
+    if ( _pending.empty() )
+    {
+      _queue.clear();
+      _qhead = 0;
+      return false;
+    }
+
+    for ( const auto& l : _pending.back() )
+    {
+      out.push( l );
+    }
+    _pending.pop_back();
+    _conflict = false;
+    return true;
+  }
+
+protected:
+  inline bool is_assigned( uint32_t col ) const
+  {
+    return ( _assigned[col >> 6] >> ( col & 63 ) ) & 1;
+  }
+
+  inline bool in_row( uint32_t r, uint32_t col ) const
+  {
+    return _rows.get( r, col );
+  }
+
+  /* returns some non-basic column of row r */
+  inline uint32_t find_nonbasic( uint32_t r ) const
+  {
+    auto col = _basic[r];
+    _rows.foreach_one( r, [&]( uint32_t c ){
+        if ( col == _basic[r] )
+        {
+          col = c;
+        }
+      });
+    assert( col != _basic[r] );
+    return col;
+  }
+
+  /* returns an unassigned non-basic column of row r, or -1 */
+  inline int find_unassigned( uint32_t r ) const
+  {
+    auto const row = _rows.row( r );
+    for ( auto k = 0u; k < _num_words; ++k )
+    {
+      word_type bits = row[k] & ~_assigned[k];
+      if ( k == ( _basic[r] >> 6 ) )
+      {
+        bits &= ~( word_type( 1 ) << ( _basic[r] & 63 ) );
+      }
+      if ( bits )
+      {
+        return k * 64 + __builtin_ctzll( bits );
+      }
+    }
+    return -1;
+  }
+
+  /* parity of the assigned variables in row r */
+  inline bool parity( uint32_t r ) const
+  {
+    auto const row = _rows.row( r );
+    auto count = 0u;
+    for ( auto k = 0u; k < _num_words; ++k )
+    {
+      count += __builtin_popcountll( row[k] & _values[k] );
+    }
+    return count & 1;
+  }
+
+  /* all non-basic columns of row r are assigned */
+  void evaluate( uint32_t r )
+  {
+    auto const basic = _basic[r];
+    bool const value = _rhs[r] ^ parity( r );
+    if ( !is_assigned( basic ) )
+    {
+      /* implication: value is the value of the basic variable */
+      ++_num_propagations;
+      add_clause( r, basic, value );
+    }
+    else if ( value )
+    {
+      /* conflict: the parity of all variables differs from the right-hand side */
+      add_clause( r, -1, false );
+    }
+  }
+
+  /* clause with the implied literal (column implied) first and all other literals false */
+  void add_clause( uint32_t r, int implied, bool value )
+  {
+    if ( _conflict )
+    {
+      return;
+    }
+
+    std::vector<Glucose::Lit> clause;
+    if ( implied >= 0 )
+    {
+      clause.emplace_back( Glucose::mkLit( _col_to_var[implied], !value ) );
+    }
+
+    _rows.foreach_one( r, [&]( uint32_t col ){
+        if ( int( col ) != implied )
+        {
+          bool const col_value = ( _values[col >> 6] >> ( col & 63 ) ) & 1;
+          clause.emplace_back( Glucose::mkLit( _col_to_var[col], col_value ) );
+        }
+      });
+
+    if ( implied < 0 )
+    {
+      /* a conflict makes all pending implications obsolete */
+      _pending.clear();
+      _conflict = true;
+    }
+    _pending.emplace_back( clause );
+  }
+
+  /* selects a new watch for row r or evaluates the row if there is none */
+  void update_watch( uint32_t r )
+  {
+    auto const col = find_unassigned( r );
+    if ( col >= 0 )
+    {
+      _watch[r] = col;
+      _watches[col].emplace_back( r );
+    }
+    else
+    {
+      evaluate( r );
+    }
+  }
+
+  /* makes column col the basic variable of row r */
+  void pivot( uint32_t r, uint32_t col )
+  {
+    ++_num_pivots;
+
+    for ( auto i = 0u; i < _basic.size(); ++i )
+    {
+      if ( i == r || !in_row( i, col ) )
+      {
+        continue;
+      }
+
+      _rows.add_row( i, r );
+      _rhs[i] = _rhs[i] ^ _rhs[r];
+
+      if ( !in_row( i, _watch[i] ) || is_assigned( _watch[i] ) )
+      {
+        update_watch( i );
+      }
+    }
+
+    _basic_row[_basic[r]] = -1;
+    _basic[r] = col;
+    _basic_row[col] = r;
+
+    if ( _watch[r] == col || is_assigned( _watch[r] ) )
+    {
+      update_watch( r );
+    }
+  }
+
+  void process( uint32_t col )
+  {
+    /* rows watching col */
+    auto& ws = _watches[col];
+    auto j = 0u;
+    for ( auto i = 0u; i < ws.size(); ++i )
+    {
+      auto const r = ws[i];
+      if ( _watch[r] != col )
+      {
+        /* stale entry */
+        continue;
+      }
+
+      auto const other = find_unassigned( r );
+      if ( other >= 0 )
+      {
+        _watch[r] = other;
+        _watches[other].emplace_back( r );
+      }
+      else
+      {
+        ws[j++] = r;
+        evaluate( r );
+      }
+    }
+    ws.resize( j );
+
+    /* row with basic variable col */
+    if ( auto const r = _basic_row[col]; r >= 0 )
+    {
+      auto const other = find_unassigned( r );
+      if ( other >= 0 )
+      {
+        pivot( r, other );
+      }
+      else
+      {
+        evaluate( r );
+      }
+    }
+  }
+
+protected:
+  /* XOR constraints (value includes the signs of the literals) */
+  std::vector<std::vector<int>> _xor_clauses;
+  std::vector<bool> _xor_values;
+
+  std::vector<int> _var_to_col;
+  std::vector<uint32_t> _col_to_var;
+
+  /* matrix */
+  uint32_t _num_words = 0;
+  utils::gf2_matrix _rows;
+  std::vector<bool> _rhs;
+  std::vector<uint32_t> _basic;
+  std::vector<uint32_t> _watch;
+  std::vector<int> _basic_row;
+  std::vector<std::vector<uint32_t>> _watches;
+
+  /* partial assignment */
+  std::vector<word_type> _assigned;
+  std::vector<word_type> _values;
+
+  /* assigned columns, which have not been processed yet */
+  std::vector<uint32_t> _queue;
+  uint32_t _qhead = 0;
+
+  /* reasons and conflicts, which have not been reported yet */
+  std::vector<std::vector<Glucose::Lit>> _pending;
+  bool _conflict = false;
+
+  uint64_t _num_pivots = 0;
+  uint64_t _num_propagations = 0;
+}; /* xor_propagator */
+
+} // namespace easy::sat2
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,339 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file gf2_matrix.hpp
+  \brief Dense matrix over GF(2)
+
+  \author Heinz Riener
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define EASY_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace easy::utils
+{
+
+namespace detail
+{
+
+inline void xor_words_scalar( uint64_t* dst, uint64_t const* src, uint32_t n )
+{
+  for ( auto i = 0u; i < n; ++i )
+  {
+    dst[i] ^= src[i];
+  }
+}
+
+#if defined( EASY_X86_SIMD )
+__attribute__( ( target( "avx2" ) ) )
+inline void xor_words_avx2( uint64_t* dst, uint64_t const* src, uint32_t n )
+{
+  uint32_t i = 0u;
+  for ( ; i + 4u <= n; i += 4u )
+  {
+    __m256i const a = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( dst + i ) );
+    __m256i const b = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( src + i ) );
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( dst + i ), _mm256_xor_si256( a, b ) );
+  }
+  xor_words_scalar( dst + i, src + i, n - i );
+}
+#endif
+
+using xor_words_fn = void ( * )( uint64_t*, uint64_t const*, uint32_t );
+
+/* XOR of word ranges, vectorized if supported by the machine */
+inline xor_words_fn xor_words_function()
+{
+#if defined( EASY_X86_SIMD )
+  if ( __builtin_cpu_supports( "avx2" ) )
+  {
+    return &xor_words_avx2;
+  }
+#endif
+  return &xor_words_scalar;
+}
+
+/*! \brief XORs n words of src into dst
+ *
+ * The kernel is selected once at run-time, such that the AVX2 kernel
+ * is used whenever the machine supports it.
+ */
+inline void xor_words( uint64_t* dst, uint64_t const* src, uint32_t n )
+{
+  static xor_words_fn const fn = xor_words_function();
+  fn( dst, src, n );
+}
+
+} /* namespace detail */
+
+/*! \brief Dense matrix over GF(2)
+ *
+ * Rows are stored contiguously as 64-bit words, such that adding
+ * (XORing) two rows is a word-wise operation.
+ */
+class gf2_matrix
+{
+public:
+  using word_type = uint64_t;
+
+  static constexpr uint32_t bits_per_word = 64u;
+
+public:
+  /*! \brief Default constructor
+   *
+   * Creates an empty matrix.
+   */
+  explicit gf2_matrix() = default;
+
+  /*! \brief Constructor
+   *
+   * Creates a zero matrix with `num_rows` rows and `num_cols` columns.
+   */
+  explicit gf2_matrix( uint32_t num_rows, uint32_t num_cols )
+    : _num_rows( num_rows )
+    , _num_cols( num_cols )
+    , _num_words( ( num_cols + bits_per_word - 1u ) / bits_per_word )
+    , _words( uint64_t( num_rows ) * _num_words, 0u )
+  {}
+
+  uint32_t num_rows() const
+  {
+    return _num_rows;
+  }
+
+  uint32_t num_cols() const
+  {
+    return _num_cols;
+  }
+
+  /*! \brief Number of words per row */
+  uint32_t num_words() const
+  {
+    return _num_words;
+  }
+
+  word_type* row( uint32_t r )
+  {
+    assert( r < _num_rows );
+    return &_words[uint64_t( r ) * _num_words];
+  }
+
+  word_type const* row( uint32_t r ) const
+  {
+    assert( r < _num_rows );
+    return &_words[uint64_t( r ) * _num_words];
+  }
+
+  bool get( uint32_t r, uint32_t c ) const
+  {
+    assert( c < _num_cols );
+    return ( row( r )[c / bits_per_word] >> ( c % bits_per_word ) ) & 1u;
+  }
+
+  void set( uint32_t r, uint32_t c, bool value = true )
+  {
+    assert( c < _num_cols );
+    auto const mask = word_type( 1u ) << ( c % bits_per_word );
+    if ( value )
+    {
+      row( r )[c / bits_per_word] |= mask;
+    }
+    else
+    {
+      row( r )[c / bits_per_word] &= ~mask;
+    }
+  }
+
+  void flip( uint32_t r, uint32_t c )
+  {
+    assert( c < _num_cols );
+    row( r )[c / bits_per_word] ^= word_type( 1u ) << ( c % bits_per_word );
+  }
+
+  /*! \brief Adds row src to row dst */
+  void add_row( uint32_t dst, uint32_t src )
+  {
+    detail::xor_words( row( dst ), row( src ), _num_words );
+  }
+
+  void swap_rows( uint32_t a, uint32_t b )
+  {
+    if ( a != b )
+    {
+      std::swap_ranges( row( a ), row( a ) + _num_words, row( b ) );
+    }
+  }
+
+  /*! \brief Calls fn for each column with a one in row r (in increasing order) */
+  template<typename Fn>
+  void foreach_one( uint32_t r, Fn&& fn ) const
+  {
+    auto const words = row( r );
+    for ( auto k = 0u; k < _num_words; ++k )
+    {
+      word_type bits = words[k];
+      while ( bits )
+      {
+        fn( k * bits_per_word + __builtin_ctzll( bits ) );
+        bits &= bits - 1u;
+      }
+    }
+  }
+
+  /*! \brief Brings the matrix into reduced row echelon form
+   *
+   * Only the first `num_pivot_cols` columns are considered as pivot
+   * columns (e.g., to exclude a right-hand side column).  The
+   * elimination is blocked in the style of the method of the four
+   * Russians (M4RI): up to `block_size` pivot rows are determined at a
+   * time, all 2^block_size sums of them are tabulated, and every other
+   * row is reduced with a single table lookup.  A block size of 0
+   * selects a size depending on the number of rows.
+   *
+   * Returns the pivot columns; row i has its leading one in the i-th
+   * pivot column and all rows starting from the rank are zero in the
+   * pivot columns.
+   */
+  std::vector<uint32_t> reduced_row_echelon_form( uint32_t num_pivot_cols, uint32_t block_size = 0u )
+  {
+    assert( num_pivot_cols <= _num_cols );
+    if ( block_size == 0u )
+    {
+      block_size = _num_rows < 64u ? 1u : 8u;
+    }
+
+    std::vector<uint32_t> pivots;
+    std::vector<word_type> table;
+
+    auto rank = 0u;
+    auto col = 0u;
+    while ( col < num_pivot_cols && rank < _num_rows )
+    {
+      /* pivot rows of this block are first, ..., rank - 1 */
+      auto const first = rank;
+      auto const first_word = col / bits_per_word;
+      std::vector<uint32_t> block;
+
+      for ( ; col < num_pivot_cols && rank < _num_rows && block.size() < block_size; ++col )
+      {
+        auto r = rank;
+        for ( ; r < _num_rows; ++r )
+        {
+          for ( auto b = 0u; b < block.size(); ++b )
+          {
+            if ( get( r, block[b] ) )
+            {
+              add_row( r, first + b );
+            }
+          }
+          if ( get( r, col ) )
+          {
+            break;
+          }
+        }
+
+        if ( r == _num_rows )
+        {
+          continue;
+        }
+
+        swap_rows( r, rank );
+        for ( auto b = 0u; b < block.size(); ++b )
+        {
+          if ( get( first + b, col ) )
+          {
+            add_row( first + b, rank );
+          }
+        }
+
+        block.emplace_back( col );
+        pivots.emplace_back( col );
+        ++rank;
+      }
+
+      if ( block.empty() )
+      {
+        break;
+      }
+
+      /* all sums of the pivot rows, pivot rows are zero left of first_word */
+      auto const width = _num_words - first_word;
+      auto const table_size = 1u << block.size();
+      table.assign( uint64_t( table_size ) * width, 0u );
+      for ( auto i = 1u; i < table_size; ++i )
+      {
+        auto const entry = &table[uint64_t( i ) * width];
+        std::copy_n( &table[uint64_t( i & ( i - 1u ) ) * width], width, entry );
+        detail::xor_words( entry, row( first + __builtin_ctz( i ) ) + first_word, width );
+      }
+
+      /* reduce all other rows */
+      for ( auto r = 0u; r < _num_rows; ++r )
+      {
+        if ( r == first )
+        {
+          r = rank - 1u;
+          continue;
+        }
+
+        auto index = 0u;
+        for ( auto b = 0u; b < block.size(); ++b )
+        {
+          index |= uint32_t( get( r, block[b] ) ) << b;
+        }
+        if ( index != 0u )
+        {
+          detail::xor_words( row( r ) + first_word, &table[uint64_t( index ) * width], width );
+        }
+      }
+    }
+
+    return pivots;
+  }
+
+protected:
+  uint32_t _num_rows = 0u;
+  uint32_t _num_cols = 0u;
+  uint32_t _num_words = 0u;
+  std::vector<word_type> _words;
+}; /* gf2_matrix */
+
+} // namespace easy::utils
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
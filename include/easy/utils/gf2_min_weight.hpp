@@ -0,0 +1,460 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file gf2_min_weight.hpp
+  \brief Minimum-weight solutions of linear systems over GF(2)
+
+  \author Heinz Riener
+*/
+
+#pragma once
+
+#include <easy/utils/gf2_matrix.hpp>
+#include <easy/utils/stopwatch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace easy::utils
+{
+
+struct min_weight_solver_params
+{
+  uint32_t num_threads = 1u; /*>! Number of threads searching over information sets */
+  uint32_t p = 2u; /*>! Number of non-basic columns combined per information set (0, 1, or 2) */
+  uint64_t max_iterations = 1000u; /*>! Number of information sets per thread (0 denotes no limit) */
+  double time_limit = 0.0; /*>! Time limit in seconds (0 denotes no limit) */
+  int64_t target_cost = 0; /*>! Stop as soon as a solution of at most this cost is found */
+  uint64_t seed = 0xcafeaffe; /*>! Seed of the random swaps (thread i uses seed + i) */
+
+  /*! Called with each improving solution and its cost (serialized) */
+  std::function<void( std::vector<uint32_t> const&, int64_t )> on_improvement;
+};
+
+struct min_weight_solver_statistics
+{
+  uint64_t iterations{0}; /*>! Number of evaluated information sets */
+  uint64_t improvements{0}; /*>! Number of improving solutions */
+  uint32_t rank{0}; /*>! Rank of the linear system */
+  stopwatch<>::duration time{0}; /*>! Time spent in solve */
+};
+
+/*! \brief Minimum-weight solutions of a linear system over GF(2)
+ *
+ * Searches for a solution x of A x = b that minimizes the sum of the
+ * costs of the variables set to 1.  The system is reduced once with
+ * Gauss-Jordan elimination, such that each solution is a particular
+ * solution plus an element of the nullspace.  The nullspace is then
+ * explored with information-set decoding: for an information set
+ * (the non-basic columns), all combinations of up to `p` non-basic
+ * columns are completed to a solution by the basic columns
+ * (Lee-Brickell), and consecutive information sets differ in a single
+ * randomly swapped column (Canteaut-Chabaud).
+ *
+ * The search is anytime: the best solution is available at any time
+ * and improvements are reported to `on_improvement`.  With several
+ * threads, each thread walks its own sequence of information sets and
+ * all threads share the best solution.  The result is optimal if its
+ * cost does not exceed the trivial lower bound (0 for a homogeneous
+ * system, otherwise the smallest cost of a variable occuring in an
+ * equation); otherwise it is a heuristic upper bound.
+ *
+ * The last column of `equations` is the right-hand side; `costs` has
+ * one non-negative entry for each other column.
+ */
+class min_weight_solver
+{
+public:
+  using solution_type = std::vector<uint32_t>;
+
+public:
+  explicit min_weight_solver( gf2_matrix const& equations, std::vector<int64_t> const& costs, min_weight_solver_statistics& stats, min_weight_solver_params const& ps )
+    : _equations( equations )
+    , _costs( costs )
+    , _stats( stats )
+    , _ps( ps )
+    , _num_vars( equations.num_cols() - 1u )
+  {
+    assert( equations.num_cols() >= 1u );
+    assert( _costs.size() == _num_vars );
+  }
+
+  /*! \brief Searches for a minimum-weight solution
+   *
+   * Returns false if and only if the system is inconsistent.
+   */
+  bool solve()
+  {
+    stopwatch t( _stats.time );
+    _start = std::chrono::steady_clock::now();
+
+    if ( !setup() )
+    {
+      return false;
+    }
+
+    /* the particular solution of the eliminated system */
+    information_set initial{_columns, _basis, _nonbasic};
+    evaluate( initial );
+
+    if ( !done() && !_nonbasic.empty() )
+    {
+      auto const num_threads = std::max( _ps.num_threads, 1u );
+      if ( num_threads == 1u )
+      {
+        search( _ps.seed );
+      }
+      else
+      {
+        std::vector<std::thread> threads;
+        for ( auto i = 0u; i < num_threads; ++i )
+        {
+          threads.emplace_back( [this, i]() { search( _ps.seed + i ); } );
+        }
+        for ( auto& thread : threads )
+        {
+          thread.join();
+        }
+      }
+    }
+
+    _stats.rank = _basis.size();
+    return true;
+  }
+
+  /*! \brief Variables set to 1 in the best solution (in increasing order) */
+  solution_type const& solution() const
+  {
+    return _solution;
+  }
+
+  /*! \brief Cost of the best solution */
+  int64_t cost() const
+  {
+    return _cost;
+  }
+
+  /*! \brief Returns true if the best solution is known to be optimal */
+  bool is_optimal() const
+  {
+    return _cost <= _lower_bound;
+  }
+
+protected:
+  struct information_set
+  {
+    /* column-major system: row c of this matrix is column c (last one is the right-hand side) */
+    gf2_matrix columns;
+
+    /* basic column of each equation */
+    std::vector<uint32_t> basis;
+
+    /* non-basic columns that occur in some equation */
+    std::vector<uint32_t> nonbasic;
+  };
+
+  bool setup()
+  {
+    gf2_matrix m = _equations;
+    _basis = m.reduced_row_echelon_form( _num_vars );
+    auto const rank = uint32_t( _basis.size() );
+
+    for ( auto r = rank; r < m.num_rows(); ++r )
+    {
+      if ( m.get( r, _num_vars ) )
+      {
+        return false;
+      }
+    }
+
+    /* transpose the reduced equations */
+    _columns = gf2_matrix( _num_vars + 1u, rank );
+    for ( auto r = 0u; r < rank; ++r )
+    {
+      m.foreach_one( r, [&]( uint32_t c ) { _columns.set( c, r ); } );
+    }
+
+    std::vector<bool> is_basic( _num_vars, false );
+    for ( const auto& c : _basis )
+    {
+      is_basic[c] = true;
+    }
+
+    _unit_costs = true;
+    _lower_bound = std::numeric_limits<int64_t>::max();
+    for ( auto c = 0u; c < _num_vars; ++c )
+    {
+      assert( _costs[c] >= 0 );
+      _unit_costs = _unit_costs && _costs[c] == 1;
+      if ( is_zero( _columns.row( c ) ) )
+      {
+        continue;
+      }
+
+      _lower_bound = std::min( _lower_bound, _costs[c] );
+      if ( !is_basic[c] )
+      {
+        _nonbasic.emplace_back( c );
+      }
+    }
+
+    if ( is_zero( _columns.row( _num_vars ) ) )
+    {
+      _lower_bound = 0;
+    }
+
+    _cost = std::numeric_limits<int64_t>::max();
+    _best_cost = _cost;
+    return true;
+  }
+
+  bool is_zero( gf2_matrix::word_type const* v ) const
+  {
+    return std::all_of( v, v + _columns.num_words(), []( auto w ) { return w == 0u; } );
+  }
+
+  bool done() const
+  {
+    if ( _best_cost.load() <= std::max( _lower_bound, _ps.target_cost ) )
+    {
+      return true;
+    }
+    if ( _ps.time_limit > 0.0 )
+    {
+      std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - _start;
+      return elapsed.count() >= _ps.time_limit;
+    }
+    return false;
+  }
+
+  void search( uint64_t seed )
+  {
+    information_set s{_columns, _basis, _nonbasic};
+    std::mt19937_64 random( seed );
+
+    for ( uint64_t i = 1u; _ps.max_iterations == 0u || i < _ps.max_iterations; ++i )
+    {
+      if ( done() )
+      {
+        break;
+      }
+      swap_random_column( s, random );
+      evaluate( s );
+    }
+  }
+
+  /*! \brief Replaces a random basic column with a random non-basic column */
+  void swap_random_column( information_set& s, std::mt19937_64& random ) const
+  {
+    auto const num_words = s.columns.num_words();
+    auto const k = std::uniform_int_distribution<std::size_t>( 0u, s.nonbasic.size() - 1u )( random );
+    auto const entering = s.nonbasic[k];
+
+    /* pick a random equation in which the entering column occurs */
+    std::vector<gf2_matrix::word_type> mask( s.columns.row( entering ), s.columns.row( entering ) + num_words );
+    uint32_t ones = 0u;
+    for ( const auto& w : mask )
+    {
+      ones += __builtin_popcountll( w );
+    }
+    auto which = std::uniform_int_distribution<uint32_t>( 0u, ones - 1u )( random );
+    uint32_t row = 0u;
+    s.columns.foreach_one( entering, [&]( uint32_t r ) { if ( which-- == 0u ) row = r; } );
+
+    /* add the pivot row to all other rows in which the entering column occurs */
+    mask[row / gf2_matrix::bits_per_word] ^= gf2_matrix::word_type( 1u ) << ( row % gf2_matrix::bits_per_word );
+    for ( auto c = 0u; c <= _num_vars; ++c )
+    {
+      if ( s.columns.get( c, row ) )
+      {
+        detail::xor_words( s.columns.row( c ), mask.data(), num_words );
+      }
+    }
+
+    s.nonbasic[k] = s.basis[row];
+    s.basis[row] = entering;
+  }
+
+  /*! \brief Cost of the basic columns selected by u + w, stops early once bound is reached */
+  int64_t basic_cost( information_set const& s, gf2_matrix::word_type const* u, gf2_matrix::word_type const* w, int64_t bound ) const
+  {
+    auto const num_words = s.columns.num_words();
+    int64_t cost = 0;
+    if ( _unit_costs )
+    {
+      for ( auto k = 0u; k < num_words; ++k )
+      {
+        cost += __builtin_popcountll( u[k] ^ w[k] );
+      }
+      return cost;
+    }
+
+    for ( auto k = 0u; k < num_words; ++k )
+    {
+      auto bits = u[k] ^ w[k];
+      while ( bits )
+      {
+        cost += _costs[s.basis[k * gf2_matrix::bits_per_word + __builtin_ctzll( bits )]];
+        if ( cost >= bound )
+        {
+          return cost;
+        }
+        bits &= bits - 1u;
+      }
+    }
+    return cost;
+  }
+
+  /*! \brief Evaluates all combinations of up to p non-basic columns */
+  void evaluate( information_set const& s )
+  {
+    auto const num_words = s.columns.num_words();
+    auto const rhs = s.columns.row( _num_vars );
+    std::vector<gf2_matrix::word_type> zero( num_words, 0u ), v( num_words ), w( num_words );
+
+    auto best = _best_cost.load();
+    auto const cost = basic_cost( s, rhs, zero.data(), best );
+    if ( cost < best )
+    {
+      best = improve( s, rhs, {}, cost );
+    }
+
+    if ( _ps.p >= 1u )
+    {
+      for ( auto i = 0u; i < s.nonbasic.size(); ++i )
+      {
+        auto const a = s.nonbasic[i];
+        if ( _costs[a] >= best )
+        {
+          continue;
+        }
+
+        std::copy_n( rhs, num_words, v.begin() );
+        detail::xor_words( v.data(), s.columns.row( a ), num_words );
+        auto const cost_a = _costs[a] + basic_cost( s, v.data(), zero.data(), best - _costs[a] );
+        if ( cost_a < best )
+        {
+          best = improve( s, v.data(), {a}, cost_a );
+        }
+
+        if ( _ps.p < 2u )
+        {
+          continue;
+        }
+
+        for ( auto j = i + 1u; j < s.nonbasic.size(); ++j )
+        {
+          auto const b = s.nonbasic[j];
+          auto const cost_b = _costs[a] + _costs[b];
+          if ( cost_b >= best )
+          {
+            continue;
+          }
+
+          auto const cost_ab = cost_b + basic_cost( s, v.data(), s.columns.row( b ), best - cost_b );
+          if ( cost_ab < best )
+          {
+            std::copy( v.begin(), v.end(), w.begin() );
+            detail::xor_words( w.data(), s.columns.row( b ), num_words );
+            best = improve( s, w.data(), {a, b}, cost_ab );
+          }
+        }
+      }
+    }
+
+    std::lock_guard<std::mutex> lock( _mutex );
+    ++_stats.iterations;
+  }
+
+  /*! \brief Records a solution if it improves the shared best one, returns the new best cost */
+  int64_t improve( information_set const& s, gf2_matrix::word_type const* v, std::vector<uint32_t> nonbasic, int64_t cost )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    if ( cost >= _cost )
+    {
+      return _cost;
+    }
+
+    for ( auto k = 0u; k < s.columns.num_words(); ++k )
+    {
+      auto bits = v[k];
+      while ( bits )
+      {
+        nonbasic.emplace_back( s.basis[k * gf2_matrix::bits_per_word + __builtin_ctzll( bits )] );
+        bits &= bits - 1u;
+      }
+    }
+    std::sort( nonbasic.begin(), nonbasic.end() );
+
+    _solution = std::move( nonbasic );
+    _cost = cost;
+    _best_cost = cost;
+    ++_stats.improvements;
+
+    if ( _ps.on_improvement )
+    {
+      _ps.on_improvement( _solution, _cost );
+    }
+    return _cost;
+  }
+
+protected:
+  gf2_matrix const& _equations;
+  std::vector<int64_t> const& _costs;
+  min_weight_solver_statistics& _stats;
+  min_weight_solver_params const& _ps;
+  uint32_t const _num_vars;
+
+  /* reduced system */
+  gf2_matrix _columns;
+  std::vector<uint32_t> _basis;
+  std::vector<uint32_t> _nonbasic;
+  bool _unit_costs = true;
+  int64_t _lower_bound = 0;
+
+  /* best solution, guarded by _mutex; _best_cost mirrors _cost for lock-free reads */
+  std::mutex _mutex;
+  solution_type _solution;
+  int64_t _cost = std::numeric_limits<int64_t>::max();
+  std::atomic<int64_t> _best_cost{std::numeric_limits<int64_t>::max()};
+
+  std::chrono::steady_clock::time_point _start;
+}; /* min_weight_solver */
+
+} // namespace easy::utils
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,163 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file thread_pool.hpp
+  \brief Work-stealing parallel loop
+
+  \author Heinz Riener
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace easy::utils
+{
+
+/*! \brief Number of hardware threads (at least 1) */
+inline uint32_t hardware_concurrency()
+{
+  return std::max( std::thread::hardware_concurrency(), 1u );
+}
+
+/*! \brief Calls `fn( worker, index )` for each index in [0, num_tasks) on `num_workers` threads
+ *
+ * The indices are distributed in contiguous blocks over the workers.
+ * Each worker takes tasks from the front of its own queue; a worker
+ * whose queue ran empty steals from the back of the other queues, such
+ * that a few expensive tasks do not serialize the loop.  The worker
+ * index passed to `fn` is in [0, num_workers) and can be used to
+ * address per-worker state without synchronization.
+ *
+ * The first exception thrown by `fn` is rethrown after all workers
+ * stopped.  With a single worker, the loop runs on the calling thread.
+ */
+template<typename Fn>
+void parallel_for( uint64_t num_tasks, uint32_t num_workers, Fn&& fn )
+{
+  num_workers = uint32_t( std::max<uint64_t>( std::min<uint64_t>( num_workers, num_tasks ), 1u ) );
+  if ( num_workers == 1u )
+  {
+    for ( uint64_t i = 0u; i < num_tasks; ++i )
+    {
+      fn( 0u, i );
+    }
+    return;
+  }
+
+  struct queue
+  {
+    std::mutex mutex;
+    std::deque<uint64_t> tasks;
+  };
+  std::vector<queue> queues( num_workers );
+  for ( auto w = 0u; w < num_workers; ++w )
+  {
+    auto const begin = num_tasks * w / num_workers;
+    auto const end = num_tasks * ( w + 1u ) / num_workers;
+    for ( auto i = begin; i < end; ++i )
+    {
+      queues[w].tasks.push_back( i );
+    }
+  }
+
+  auto const pop = [&]( uint32_t w, uint64_t& task ) {
+    {
+      std::lock_guard<std::mutex> lock( queues[w].mutex );
+      if ( !queues[w].tasks.empty() )
+      {
+        task = queues[w].tasks.front();
+        queues[w].tasks.pop_front();
+        return true;
+      }
+    }
+
+    /* steal */
+    for ( auto k = 1u; k < num_workers; ++k )
+    {
+      auto& victim = queues[( w + k ) % num_workers];
+      std::lock_guard<std::mutex> lock( victim.mutex );
+      if ( !victim.tasks.empty() )
+      {
+        task = victim.tasks.back();
+        victim.tasks.pop_back();
+        return true;
+      }
+    }
+    return false;
+  };
+
+  std::mutex error_mutex;
+  std::exception_ptr error;
+
+  std::vector<std::thread> threads;
+  for ( auto w = 0u; w < num_workers; ++w )
+  {
+    threads.emplace_back( [&, w]() {
+      uint64_t task;
+      while ( pop( w, task ) )
+      {
+        try
+        {
+          fn( w, task );
+        }
+        catch ( ... )
+        {
+          std::lock_guard<std::mutex> lock( error_mutex );
+          if ( !error )
+          {
+            error = std::current_exception();
+          }
+        }
+      }
+    } );
+  }
+
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  if ( error )
+  {
+    std::rethrow_exception( error );
+  }
+}
+
+} // namespace easy::utils
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
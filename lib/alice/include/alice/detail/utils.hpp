@@ -90,19 +90,13 @@ inline std::string trim_copy( std::string s )
 /* format with vector (see https://stackoverflow.com/questions/39493542/building-a-dynamic-list-of-named-arguments-for-fmtlib) */
 inline std::string format_with_vector( const std::string& fmtstr, const std::vector<std::string>& values )
 {
-  assert( values.size() <= 16u );
-
-  std::vector<fmt::internal::Value> data( values.size() );
-  fmt::ULongLong types = 0;
-
-  for ( auto i = 0u; i < values.size(); ++i )
+  std::vector<fmt::basic_format_arg<fmt::format_context>> data;
+  for ( const auto& value : values )
   {
-    types |= static_cast<uint64_t>( fmt::internal::Value::STRING ) << ( i * 4 );
-    data[i].string.value = values[i].data();
-    data[i].string.size = values[i].size();
+    data.push_back( fmt::internal::make_arg<fmt::format_context>( value ) );
   }
 
-  return fmt::format( fmtstr, fmt::ArgList( types, &data[0] ) );
+  return fmt::vformat( fmtstr, fmt::format_args( data.data(), static_cast<int>( data.size() ) ) );
 }
 
 template<char sep>
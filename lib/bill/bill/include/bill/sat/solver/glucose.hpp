@@ -2720,6 +2720,23 @@ enum CoreStats {
 } ;
 
 #define coreStatsSize 24
+//=================================================================================================
+// ExternalPropagator -- interface for theory propagation outside of the clause database:
+
+class ExternalPropagator {
+public:
+    virtual ~ExternalPropagator() {}
+
+    // Literal 'p' has been put on the trail (called in trail order).
+    virtual void notifyAssignment(Lit p) = 0;
+    // Literal 'p' has been removed from the trail during backtracking.
+    virtual void notifyBacktrack(Lit p) = 0;
+    // Write the next reason clause (out[0] is the implied literal, all other literals
+    // are false) or a conflict clause (all literals are false) to 'out'.  Returns false
+    // if there is nothing left to propagate.  Clauses must have at least two literals.
+    virtual bool propagate(vec<Lit>& out) = 0;
+};
+
 //=================================================================================================
 // Solver -- the main class:
 
@@ -2758,6 +2775,7 @@ public:
     bool    simplify     ();                        // Removes already satisfied clauses.
     bool    solve        (const vec<Lit>& assumps); // Search for a model that respects a given set of assumptions.
     lbool   solveLimited (const vec<Lit>& assumps); // Search for a model that respects a given set of assumptions (With resource constraints).
+    void    setExternalPropagator(ExternalPropagator* p) { extProp = p; extQhead = 0; } // Attach (or detach with nullptr) an external propagator.
     bool    solve        ();                        // Search without assumptions.
     bool    solve        (Lit p);                   // Search for a model that respects a single assumption.
     bool    solve        (Lit p, Lit q);            // Search for a model that respects two assumptions.
@@ -2900,6 +2918,12 @@ public:
 
 protected:
 
+    // External propagation:
+    ExternalPropagator* extProp = nullptr;
+    int                 extQhead = 0;  // Head of the trail for the external propagator.
+    vec<Lit>            extClause;
+    CRef                propagateExternal();
+
     long curRestart;
 
     // Alpha variables
@@ -3943,18 +3967,73 @@ inline void Solver::cancelUntil(int level) {
         for(int c = trail.size() - 1; c >= trail_lim[level]; c--) {
             Var x = var(trail[c]);
             assigns[x] = l_Undef;
+            if(extProp != nullptr && c < extQhead)
+                extProp->notifyBacktrack(trail[c]);
             if(phase_saving > 1 || ((phase_saving == 1) && c > trail_lim.last())) {
                 polarity[x] = sign(trail[c]);
             }
             insertVarOrder(x);
         }
         qhead = trail_lim[level];
+        if(extQhead > trail_lim[level])
+            extQhead = trail_lim[level];
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
     }
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  propagateExternal : [void]  ->  [Clause*]
+|
+|  Description:
+|    Alternates between the external propagator and unit propagation until a fixpoint is
+|    reached.  Reason and conflict clauses of the external propagator are added as learnt
+|    clauses.  Returns a conflicting clause or CRef_Undef.
+|________________________________________________________________________________________________@*/
+inline CRef Solver::propagateExternal() {
+    for(;;) {
+        while(extQhead < trail.size())
+            extProp->notifyAssignment(trail[extQhead++]);
+
+        extClause.clear();
+        if(!extProp->propagate(extClause))
+            return CRef_Undef;
+        assert(extClause.size() > 1);
+
+        if(value(extClause[0]) == l_True)
+            continue;
+
+        bool conflict = value(extClause[0]) == l_False;
+
+        // Watch the literals with the highest decision levels
+        for(int k = conflict ? 0 : 1; k < 2; k++) {
+            int max_i = k;
+            for(int i = k + 1; i < extClause.size(); i++)
+                if(level(var(extClause[i])) > level(var(extClause[max_i])))
+                    max_i = i;
+            Lit tmp = extClause[k];
+            extClause[k] = extClause[max_i];
+            extClause[max_i] = tmp;
+        }
+
+        CRef cr = ca.alloc(extClause, true);
+        ca[cr].setLBD(computeLBD(ca[cr]));
+        ca[cr].setOneWatched(false);
+        learnts.push(cr);
+        attachClause(cr);
+
+        if(conflict)
+            return cr;
+
+        uncheckedEnqueue(extClause[0], cr);
+        CRef confl = propagate();
+        if(confl != CRef_Undef)
+            return confl;
+    }
+}
+
 //=================================================================================================
 // Major methods:
 
@@ -4762,6 +4841,8 @@ inline lbool Solver::search(int nof_conflicts) {
 
         }
         CRef confl = propagate();
+        if(confl == CRef_Undef && extProp != nullptr)
+            confl = propagateExternal();
 
         if(confl != CRef_Undef) {
             newDescent = false;
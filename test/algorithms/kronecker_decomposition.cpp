@@ -0,0 +1,103 @@
+#include <catch.hpp>
+
+#include <easy/algorithms/kronecker_decomposition.hpp>
+#include <easy/esop/esop.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/* number of non-zero leaves of the complete Kronecker expansion */
+inline uint64_t kronecker_cost( kitty::dynamic_truth_table const& tt, std::vector<decomposition_type> const& decomps, uint32_t var_index )
+{
+  if ( var_index == uint32_t( tt.num_vars() ) )
+  {
+    return kitty::is_const0( tt ) ? 0u : 1u;
+  }
+
+  auto const tt0 = kitty::cofactor0( tt, var_index );
+  auto const tt1 = kitty::cofactor1( tt, var_index );
+  switch ( decomps[var_index] )
+  {
+  case decomposition_type::positive_davio:
+    return kronecker_cost( tt0, decomps, var_index + 1 ) + kronecker_cost( tt0 ^ tt1, decomps, var_index + 1 );
+  case decomposition_type::negative_davio:
+    return kronecker_cost( tt1, decomps, var_index + 1 ) + kronecker_cost( tt0 ^ tt1, decomps, var_index + 1 );
+  default:
+    return kronecker_cost( tt0, decomps, var_index + 1 ) + kronecker_cost( tt1, decomps, var_index + 1 );
+  }
+}
+
+TEST_CASE( "Find best Kronecker decomposition of small functions", "[kronecker]" )
+{
+  for ( auto n = 1u; n <= 5u; ++n )
+  {
+    kitty::dynamic_truth_table tt( n );
+    for ( auto i = 0; i < 5; ++i )
+    {
+      kitty::create_random( tt );
+
+      kronecker_search_statistics st;
+      auto const result = best_kronecker_decomposition( tt, st );
+      CHECK( result.decomposition.size() == n );
+      CHECK( st.cost == kronecker_cost( tt, result.decomposition, 0u ) );
+      CHECK( result.esop.size() <= st.cost );
+      CHECK( easy::esop::equivalent_esops( result.esop, kronecker_decomposition( tt, result.decomposition ), n ) );
+
+      /* enumerate all decomposition vectors */
+      auto best = std::numeric_limits<uint64_t>::max();
+      std::vector<decomposition_type> decomps( n );
+      for ( auto k = 0u; k < uint32_t( std::pow( 3, n ) ); ++k )
+      {
+        for ( auto v = 0u, d = k; v < n; ++v, d /= 3u )
+        {
+          decomps[v] = decomposition_type( d % 3u );
+        }
+        best = std::min( best, kronecker_cost( tt, decomps, 0u ) );
+      }
+      CHECK( st.cost == best );
+    }
+  }
+}
+
+TEST_CASE( "Find best Kronecker decomposition with multiple threads", "[kronecker]" )
+{
+  kitty::dynamic_truth_table tt( 9u );
+  for ( auto i = 0; i < 5; ++i )
+  {
+    kitty::create_random( tt );
+
+    kronecker_search_statistics st1, st4;
+    auto const result1 = best_kronecker_decomposition( tt, st1 );
+    kronecker_search_params ps;
+    ps.num_threads = 4u;
+    auto const result4 = best_kronecker_decomposition( tt, st4, ps );
+
+    CHECK( st1.cost == st4.cost );
+    CHECK( result1.decomposition == result4.decomposition );
+    CHECK( st1.cost == kronecker_cost( tt, result1.decomposition, 0u ) );
+
+    auto tt_copy = tt.construct();
+    kitty::create_from_cubes( tt_copy, result4.esop, true );
+    CHECK( tt == tt_copy );
+  }
+}
+
+TEST_CASE( "Prune Kronecker decompositions of functions with few cubes", "[kronecker]" )
+{
+  kitty::dynamic_truth_table tt( 10u );
+  kitty::create_from_cubes( tt, {kitty::cube( "11-0------" ), kitty::cube( "---1-01---" ), kitty::cube( "0-------11" )}, true );
+
+  kronecker_search_statistics st;
+  auto const result = best_kronecker_decomposition( tt, st );
+  CHECK( st.cost <= 8u );
+  CHECK( st.pruned > 0u );
+  CHECK( st.nodes < 29524u );
+
+  auto tt_copy = tt.construct();
+  kitty::create_from_cubes( tt_copy, result.esop, true );
+  CHECK( tt == tt_copy );
+}
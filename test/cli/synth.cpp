@@ -0,0 +1,68 @@
+#include <catch.hpp>
+
+#include <alice/alice.hpp>
+
+#include <easy/cli/stores/function.hpp>
+#include <easy/cli/stores/esop.hpp>
+
+#include <easy/cli/commands/function.hpp>
+#include <easy/cli/commands/synth.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/operators.hpp>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using cli_t = alice::cli<alice::function_storee, alice::esop_storee>;
+
+cli_t make_cli()
+{
+  cli_t cli( "easy" );
+  cli.set_category( "Synthesis" );
+  cli.insert_command( "function", std::make_shared<alice::function_command>( cli.env ) );
+  cli.insert_command( "synth", std::make_shared<alice::synth_command>( cli.env ) );
+  return cli;
+}
+
+int run( cli_t& cli, std::string commands )
+{
+  std::string name = "easy";
+  std::string flag = "-c";
+  std::vector<char*> argv = {&name[0], &flag[0], &commands[0]};
+  return cli.run( int( argv.size() ), argv.data() );
+}
+
+} // namespace
+
+TEST_CASE( "Synthesize all functions of the store with several jobs", "[cli]" )
+{
+  auto cli = make_cli();
+  /* long flags with several jobs, then short flags with one job */
+  CHECK( run( cli, "function -r 3 -n 6 -s 1; synth --all --jobs 2 --strategy 2 --incremental --terms 8; synth -a -j 1 -s 2 -i -t 8" ) == 0 );
+
+  auto const& functions = cli.env->store<alice::function_storee>();
+  auto const& esops = cli.env->store<alice::esop_storee>();
+  REQUIRE( esops.size() == 12u );
+  for ( auto i = 0u; i < 6u; ++i )
+  {
+    auto tt = functions[i].bits.construct();
+    kitty::create_from_cubes( tt, esops[i].esop, true );
+    CHECK( kitty::is_const0( ( tt ^ functions[i].bits ) & functions[i].care ) );
+  }
+
+  /* results are stored in input order independent of the number of jobs */
+  for ( auto i = 0u; i < 6u; ++i )
+  {
+    CHECK( esops[6u + i].esop.size() == esops[i].esop.size() );
+  }
+}
+
+TEST_CASE( "Reject malformed synth flags", "[cli]" )
+{
+  auto cli = make_cli();
+  CHECK( run( cli, "function -r 3 -s 1; synth --jobs many" ) == 1 );
+  CHECK( cli.env->store<alice::esop_storee>().size() == 0u );
+}
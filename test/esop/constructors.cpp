@@ -3,10 +3,14 @@
 #include <easy/esop/constructors.hpp>
 #include <easy/esop/exact_synthesis.hpp>
 #include <kitty/constructors.hpp>
+#include <kitty/esop.hpp>
 #include <kitty/print.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <numeric>
+#include <random>
+#include <sstream>
 
 using namespace easy;
 
@@ -65,6 +69,79 @@ TEST_CASE( "Create PKRM from random truth table", "[constructors]" )
   }
 }
 
+TEST_CASE( "Create PKRM with bounded cache and multiple threads", "[constructors]" )
+{
+  kitty::dynamic_truth_table tt( 10u );
+
+  for ( auto i = 0; i < 10; ++i )
+  {
+    kitty::create_random( tt );
+
+    esop::pkrm_statistics st;
+    auto cubes = esop::esop_from_optimum_pkrm( tt, st );
+    CHECK( st.cache_evictions == 0u );
+    CHECK( st.peak_cache_size > 0u );
+    CHECK( st.hit_rate() > 0.0 );
+
+    esop::pkrm_params ps;
+    ps.num_threads = 3u;
+    ps.cache_capacity = 64u;
+    ps.cache_shards = 4u;
+    esop::pkrm_statistics st_bounded;
+    auto bounded = esop::esop_from_optimum_pkrm( tt, st_bounded, ps );
+    CHECK( st_bounded.parallel_tasks > 0u );
+    CHECK( st_bounded.cache_evictions > 0u );
+    CHECK( st_bounded.peak_cache_size <= 64u );
+
+    /* the same expansions are chosen */
+    std::sort( cubes.begin(), cubes.end() );
+    std::sort( bounded.begin(), bounded.end() );
+    CHECK( cubes == bounded );
+
+    auto tt_copy = tt.construct();
+    create_from_cubes( tt_copy, bounded, true );
+    CHECK( tt == tt_copy );
+  }
+}
+
+TEST_CASE( "Create PKRM for incompletely specified functions", "[constructors]" )
+{
+  std::mt19937 gen( 0xcafe );
+  kitty::dynamic_truth_table bits( 10u ), care( 10u );
+
+  auto cubes_isf = 0u, cubes_complete = 0u;
+  for ( auto i = 0; i < 20; ++i )
+  {
+    kitty::create_random( bits );
+
+    /* about 50% don't cares */
+    kitty::create_random( care );
+
+    auto const cubes = esop::esop_from_pkrm( bits, care );
+    auto tt = bits.construct();
+    create_from_cubes( tt, cubes, true );
+    CHECK( ( tt & care ) == ( bits & care ) );
+
+    cubes_isf += cubes.size();
+    cubes_complete += esop::esop_from_optimum_pkrm( bits & care ).size();
+  }
+  CHECK( cubes_isf < cubes_complete );
+
+  /* completely specified functions */
+  for ( auto i = 0; i < 10; ++i )
+  {
+    kitty::create_random( bits );
+    auto const cubes = esop::esop_from_pkrm( bits, ~bits.construct() );
+
+    auto tt = bits.construct();
+    create_from_cubes( tt, cubes, true );
+    CHECK( tt == bits );
+  }
+
+  /* no care set */
+  CHECK( esop::esop_from_pkrm( bits, bits.construct() ).empty() );
+}
+
 TEST_CASE( "Create ESOP using Boolean learning from random truth table", "[constructors]" )
 {
   kitty::static_truth_table<4> tt;
@@ -100,6 +177,36 @@ TEST_CASE( "Create ESOP using Helliwell-SAT from random truth table", "[construc
   }
 }
 
+TEST_CASE( "Enumerate implicants of minterms for Helliwell", "[constructors]" )
+{
+  for ( auto num_vars = 0u; num_vars <= 5u; ++num_vars )
+  {
+    int sid = 1;
+    esop::detail::helliwell_decision_variables g( sid, num_vars );
+
+    for ( auto m = 0u; m < ( 1u << num_vars ); ++m )
+    {
+      kitty::cube minterm( m, ( 1u << num_vars ) - 1u );
+      auto const impls = esop::detail::compute_implicants( minterm, num_vars );
+
+      std::vector<int> clause;
+      esop::detail::add_implicant_variables( clause, g, m, num_vars );
+      REQUIRE( clause.size() == impls.size() );
+
+      for ( auto i = 0u; i < impls.size(); ++i )
+      {
+        /* every implicant contains the minterm */
+        CHECK( ( ( m ^ impls[i]._bits ) & impls[i]._mask ) == 0u );
+        CHECK( g.lookup_cube( clause[i] ) == impls[i] );
+        CHECK( g.lookup_g( impls[i] ) == clause[i] );
+      }
+    }
+
+    /* all 3^n cubes are created */
+    CHECK( g.size() == esop::detail::pow3[num_vars] + 1u );
+  }
+}
+
 TEST_CASE( "Create ESOP using Helliwell-MAXSAT from random truth table", "[constructors]" )
 {
   using tt_t = kitty::static_truth_table<4>;
@@ -119,6 +226,331 @@ TEST_CASE( "Create ESOP using Helliwell-MAXSAT from random truth table", "[const
   }
 }
 
+template<typename Algorithm>
+esop::esop_t helliwell_maxsat_esop( kitty::static_truth_table<4> const& tt )
+{
+  esop::helliwell_maxsat_statistics stats;
+  esop::helliwell_maxsat_params ps;
+  esop::esop_from_tt<kitty::static_truth_table<4>, Algorithm, esop::helliwell_maxsat> synth( stats, ps );
+  return synth.synthesize( tt );
+}
+
+TEST_CASE( "Create ESOP using Helliwell-MAXSAT with OLL, PM-RES, and LSU", "[constructors]" )
+{
+  kitty::static_truth_table<4> tt;
+
+  for ( auto i = 0; i < 20; ++i )
+  {
+    kitty::create_random( tt );
+    auto const cubes = helliwell_maxsat_esop<sat2::maxsat_rc2>( tt );
+
+    for ( const auto& other : { helliwell_maxsat_esop<sat2::maxsat_oll>( tt ), helliwell_maxsat_esop<sat2::maxsat_pmres>( tt ), helliwell_maxsat_esop<sat2::maxsat_lsu>( tt ) } )
+    {
+      auto tt_copy = tt.construct();
+      create_from_cubes( tt_copy, other, true );
+      CHECK( tt == tt_copy );
+      CHECK( other.size() == cubes.size() );
+    }
+  }
+}
+
+TEST_CASE( "Create ESOP using anytime Helliwell-MAXSAT with a time limit", "[constructors]" )
+{
+  using tt_t = kitty::static_truth_table<5>;
+  using synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_lsu, esop::helliwell_maxsat>;
+  tt_t tt;
+
+  for ( auto i = 0; i < 2; ++i )
+  {
+    kitty::create_random( tt );
+    esop::helliwell_maxsat_statistics stats;
+    esop::helliwell_maxsat_params ps;
+    ps.maxsat.time_limit = 0.1;
+    synthesizer_t synth( stats, ps );
+    auto const cubes = synth.synthesize( tt );
+    CHECK( stats.maxsat.improvements > 0u );
+    CHECK( cubes.size() == uint64_t( stats.maxsat.cost ) );
+
+    auto tt_copy = tt.construct();
+    create_from_cubes( tt_copy, cubes, true );
+    CHECK( tt == tt_copy );
+  }
+}
+
+TEST_CASE( "Report a timeout of anytime Helliwell-MAXSAT", "[constructors]" )
+{
+  using tt_t = kitty::static_truth_table<5>;
+  using synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_lsu, esop::helliwell_maxsat>;
+  tt_t tt;
+  kitty::create_random( tt );
+
+  esop::helliwell_maxsat_statistics stats;
+  esop::helliwell_maxsat_params ps;
+  ps.maxsat.conflict_limit = 0;
+  synthesizer_t synth( stats, ps );
+  CHECK( synth.synthesize( tt ).empty() );
+  CHECK( stats.timeout );
+
+  /* the empty ESOP of the constant 0 is not a timeout */
+  ps.maxsat.conflict_limit = -1;
+  synthesizer_t unlimited( stats, ps );
+  CHECK( unlimited.synthesize( kitty::create<tt_t>( 5u ) ).empty() );
+  CHECK( !stats.timeout );
+}
+
+TEST_CASE( "Start anytime Helliwell-MAXSAT from the PKRM", "[constructors]" )
+{
+  using tt_t = kitty::static_truth_table<6>;
+  using synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_lsu, esop::helliwell_maxsat>;
+  tt_t tt;
+
+  for ( auto i = 0; i < 2; ++i )
+  {
+    kitty::create_random( tt );
+    esop::helliwell_maxsat_statistics stats;
+    esop::helliwell_maxsat_params ps;
+    ps.maxsat.conflict_limit = 1000;
+    ps.pkrm_hint = true;
+    synthesizer_t synth( stats, ps );
+    auto const cubes = synth.synthesize( tt );
+    CHECK( cubes.size() <= esop::esop_from_optimum_pkrm( tt ).size() );
+
+    auto tt_copy = tt.construct();
+    create_from_cubes( tt_copy, cubes, true );
+    CHECK( tt == tt_copy );
+  }
+}
+
+TEST_CASE( "Create ESOP using Helliwell with native XOR clauses from random truth table", "[constructors]" )
+{
+  using tt_t = kitty::static_truth_table<4>;
+  using sat_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_sat>;
+  using maxsat_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_maxsat>;
+  tt_t tt;
+
+  for ( auto i = 0; i < 100; ++i )
+  {
+    kitty::create_random( tt );
+
+    esop::helliwell_sat_statistics sat_stats;
+    esop::helliwell_sat_params sat_ps;
+    sat_ps.native_xor = true;
+    auto const cubes = sat_synthesizer_t( sat_stats, sat_ps ).synthesize( tt );
+    auto tt_copy = tt.construct();
+    create_from_cubes( tt_copy, cubes, true );
+    CHECK( tt == tt_copy );
+
+    esop::helliwell_maxsat_statistics stats;
+    esop::helliwell_maxsat_params ps;
+    auto const min_cubes = maxsat_synthesizer_t( stats, ps ).synthesize( tt );
+
+    ps.native_xor = true;
+    auto const min_cubes_native = maxsat_synthesizer_t( stats, ps ).synthesize( tt );
+    tt_copy = tt.construct();
+    create_from_cubes( tt_copy, min_cubes_native, true );
+    CHECK( tt == tt_copy );
+    CHECK( min_cubes.size() == min_cubes_native.size() );
+  }
+}
+
+TEST_CASE( "Create ESOP using Helliwell template from random truth tables", "[constructors]" )
+{
+  using tt_t = kitty::static_truth_table<4>;
+  using sat_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_sat>;
+  using maxsat_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_maxsat>;
+
+  auto const& t = esop::helliwell_template::get( 4 );
+  CHECK( &t == &esop::helliwell_template::get( 4 ) );
+  CHECK( t.num_cubes() == 81u );
+
+  /* serialization */
+  std::stringstream ss;
+  t.write( ss );
+  auto const t_read = esop::helliwell_template::read( ss );
+  REQUIRE( t_read );
+  std::stringstream ss_read;
+  t_read->write( ss_read );
+  CHECK( ss.str() == ss_read.str() );
+  CHECK( t.clauses() == t_read->clauses() );
+
+  /* malformed templates */
+  for ( auto const& text : { "", "hell 1 3\n0\n1\n-\n", "helliwell 32 3\n", "helliwell 1 2\n0\n1\n", "helliwell 1 3\n0\n1\n",
+                             "helliwell 1 3\n0\n1\n2\n", "helliwell 1 3\n0\n1\n-\nx 1 2\n", "helliwell 1 3\n0\n1\n-\nx 1 9 0\n",
+                             "helliwell 1 3\n0\n1\n-\ny 1 0\n" } )
+  {
+    std::istringstream is( text );
+    CHECK( !esop::helliwell_template::read( is ) );
+  }
+
+  /* one SAT-solver for all functions */
+  esop::helliwell_sat_statistics sat_stats;
+  esop::helliwell_sat_params sat_ps;
+  sat_synthesizer_t synth( sat_stats, sat_ps, t );
+
+  esop::helliwell_sat_params native_ps;
+  native_ps.native_xor = true;
+  sat_synthesizer_t synth_native( sat_stats, native_ps, *t_read );
+
+  tt_t tt, care;
+  for ( auto i = 0; i < 100; ++i )
+  {
+    kitty::create_random( tt );
+    kitty::create_random( care );
+
+    for ( auto const& cubes : {synth.synthesize( tt ), synth_native.synthesize( tt )} )
+    {
+      auto tt_copy = tt.construct();
+      create_from_cubes( tt_copy, cubes, true );
+      CHECK( tt == tt_copy );
+    }
+
+    auto const cubes_dc = synth.synthesize( tt, care );
+    auto tt_copy = tt.construct();
+    create_from_cubes( tt_copy, cubes_dc, true );
+    CHECK( ( tt & care ) == ( tt_copy & care ) );
+
+    esop::helliwell_maxsat_statistics stats;
+    esop::helliwell_maxsat_params ps;
+    auto const min_cubes = maxsat_synthesizer_t( stats, ps ).synthesize( tt );
+    auto const min_cubes_template = maxsat_synthesizer_t( stats, ps, t ).synthesize( tt );
+    tt_copy = tt.construct();
+    create_from_cubes( tt_copy, min_cubes_template, true );
+    CHECK( tt == tt_copy );
+    CHECK( min_cubes.size() == min_cubes_template.size() );
+  }
+}
+
+TEST_CASE( "Create ESOP using Helliwell minimum-weight search from random truth table", "[constructors]" )
+{
+  using tt_t = kitty::static_truth_table<4>;
+  using min_weight_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_min_weight>;
+  using maxsat_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_maxsat>;
+  tt_t tt;
+
+  for ( auto i = 0; i < 50; ++i )
+  {
+    kitty::create_random( tt );
+
+    esop::helliwell_maxsat_statistics maxsat_stats;
+    esop::helliwell_maxsat_params maxsat_ps;
+    auto const min_cubes = maxsat_synthesizer_t( maxsat_stats, maxsat_ps ).synthesize( tt );
+
+    esop::helliwell_min_weight_statistics stats;
+    esop::helliwell_min_weight_params ps;
+    ps.search.max_iterations = 20u;
+    auto const cubes = min_weight_synthesizer_t( stats, ps ).synthesize( tt );
+    auto tt_copy = tt.construct();
+    create_from_cubes( tt_copy, cubes, true );
+    CHECK( tt == tt_copy );
+    CHECK( cubes.size() >= min_cubes.size() );
+
+    ps.prove_optimality = true;
+    ps.search.num_threads = 2u;
+    auto const proven_cubes = min_weight_synthesizer_t( stats, ps ).synthesize( tt );
+    tt_copy = tt.construct();
+    create_from_cubes( tt_copy, proven_cubes, true );
+    CHECK( tt == tt_copy );
+    CHECK( stats.optimal );
+    CHECK( proven_cubes.size() == min_cubes.size() );
+  }
+}
+
+TEST_CASE( "Create ESOP using weighted Helliwell minimum-weight search from random truth table", "[constructors]" )
+{
+  using tt_t = kitty::static_truth_table<3>;
+  using min_weight_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_min_weight>;
+  using maxsat_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_maxsat>;
+  tt_t tt;
+
+  auto const literal_cost = []( kitty::cube const& cube ) { return 1 + cube.num_literals(); };
+  auto const esop_cost = [&]( esop::esop_t const& esop ) {
+    return std::accumulate( esop.begin(), esop.end(), 0, [&]( int sum, kitty::cube const& c ) { return sum + literal_cost( c ); } );
+  };
+
+  for ( auto i = 0; i < 20; ++i )
+  {
+    kitty::create_random( tt );
+
+    esop::helliwell_maxsat_statistics maxsat_stats;
+    esop::helliwell_maxsat_params maxsat_ps;
+    auto const min_cubes = maxsat_synthesizer_t( maxsat_stats, maxsat_ps ).synthesize( tt, literal_cost );
+
+    esop::helliwell_min_weight_statistics stats;
+    esop::helliwell_min_weight_params ps;
+    ps.search.max_iterations = 20u;
+    auto const cubes = min_weight_synthesizer_t( stats, ps ).synthesize( tt, literal_cost );
+    auto tt_copy = tt.construct();
+    create_from_cubes( tt_copy, cubes, true );
+    CHECK( tt == tt_copy );
+    CHECK( esop_cost( cubes ) == esop_cost( min_cubes ) );
+  }
+}
+
+TEST_CASE( "Reuse Helliwell-MAXSAT synthesizers for several functions", "[constructors]" )
+{
+  using tt_t = kitty::static_truth_table<4>;
+  using maxsat_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_maxsat>;
+
+  esop::helliwell_maxsat_statistics stats;
+  esop::helliwell_maxsat_params ps;
+  maxsat_synthesizer_t synth( stats, ps );
+  maxsat_synthesizer_t synth_template( stats, ps, esop::helliwell_template::get( 4 ) );
+
+  tt_t tt;
+  for ( auto i = 0; i < 10; ++i )
+  {
+    kitty::create_random( tt );
+
+    esop::helliwell_maxsat_statistics fresh_stats;
+    auto const expected = maxsat_synthesizer_t( fresh_stats, ps ).synthesize( tt );
+
+    for ( auto const& cubes : {synth.synthesize( tt ), synth_template.synthesize( tt )} )
+    {
+      auto tt_copy = tt.construct();
+      create_from_cubes( tt_copy, cubes, true );
+      CHECK( tt == tt_copy );
+      CHECK( cubes.size() == expected.size() );
+    }
+  }
+}
+
+TEST_CASE( "Create ESOP using Helliwell with a SAT-solver portfolio", "[constructors]" )
+{
+  using tt_t = kitty::static_truth_table<4>;
+  using sat_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_sat>;
+  using maxsat_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_maxsat>;
+
+  esop::helliwell_sat_statistics sat_stats;
+  esop::helliwell_sat_params sat_ps;
+  sat_ps.portfolio = sat2::default_portfolio( 4u );
+  sat_synthesizer_t synth( sat_stats, sat_ps, esop::helliwell_template::get( 4 ) );
+
+  tt_t tt;
+  for ( auto i = 0; i < 10; ++i )
+  {
+    kitty::create_random( tt );
+
+    auto const cubes = synth.synthesize( tt );
+    auto tt_copy = tt.construct();
+    create_from_cubes( tt_copy, cubes, true );
+    CHECK( tt == tt_copy );
+    CHECK( sat_stats.portfolio.last_winner >= 0 );
+
+    esop::helliwell_maxsat_statistics stats;
+    esop::helliwell_maxsat_params ps;
+    auto const min_cubes = maxsat_synthesizer_t( stats, ps ).synthesize( tt );
+
+    ps.portfolio = sat2::default_portfolio( 2u );
+    auto const min_cubes_portfolio = maxsat_synthesizer_t( stats, ps ).synthesize( tt );
+    tt_copy = tt.construct();
+    create_from_cubes( tt_copy, min_cubes_portfolio, true );
+    CHECK( tt == tt_copy );
+    CHECK( min_cubes.size() == min_cubes_portfolio.size() );
+    CHECK( stats.portfolio.num_calls > 0u );
+  }
+  CHECK( sat_stats.portfolio.num_calls == 10u );
+}
+
 TEST_CASE( "Create PPRM ESOP corner cases", "[constructors]" )
 {
   CHECK( from_cubes<3>( esop::esop_from_pprm( from_hex<3>( "00" ) ) ) == from_hex<3>( "00" ) );
@@ -135,6 +567,15 @@ TEST_CASE( "Create PKRM ESOP corner cases", "[constructors]" )
   CHECK( from_cubes<3>( esop::esop_from_optimum_pkrm( from_hex<3>( "ff" ) ) ) == from_hex<3>( "ff" ) );
 }
 
+TEST_CASE( "Optimum PKRM drops the most expensive subfunction", "[constructors]" )
+{
+  /* the positive Davio expansion keeps f0 and f0 ^ f1, the negative
+     Davio expansion keeps f1 and f0 ^ f1; with the two mixed up, these
+     functions get one more cube */
+  CHECK( esop::esop_from_optimum_pkrm( from_hex<3>( "1c" ) ) == esop::esop_t{kitty::cube( 4, 7 ), kitty::cube( 2, 6 )} );
+  CHECK( esop::esop_from_optimum_pkrm( from_hex<3>( "16" ) ) == esop::esop_t{kitty::cube( 0, 5 ), kitty::cube( 4, 7 ), kitty::cube( 0, 6 )} );
+}
+
 TEST_CASE( "Create ESOP using Helliwell-SAT corner cases", "[constructors]" )
 {
   using tt_t = kitty::static_truth_table<3>;
@@ -180,6 +621,38 @@ TEST_CASE( "Create PPRM from dynamic truth table", "[constructors]" )
   }
 }
 
+TEST_CASE( "Create PPRM with the Reed-Muller transform", "[constructors]" )
+{
+  for ( auto n = 0u; n <= 14u; ++n )
+  {
+    kitty::dynamic_truth_table tt( n );
+    for ( auto i = 0; i < 5; ++i )
+    {
+      create_random( tt );
+
+      /* same cubes as the recursive positive Davio decomposition */
+      auto cubes = esop::esop_from_pprm( tt );
+      auto expected = kitty::esop_from_pprm( tt );
+      std::sort( cubes.begin(), cubes.end() );
+      std::sort( expected.begin(), expected.end() );
+      CHECK( cubes == expected );
+
+      /* the transform is self-inverse */
+      CHECK( esop::pprm_spectrum( esop::pprm_spectrum( tt ) ) == tt );
+    }
+  }
+
+  kitty::static_truth_table<5> tt5;
+  kitty::static_truth_table<6> tt6;
+  for ( auto i = 0; i < 20; ++i )
+  {
+    kitty::create_random( tt5 );
+    kitty::create_random( tt6 );
+    CHECK( from_cubes<5>( esop::esop_from_pprm( tt5 ) ) == tt5 );
+    CHECK( from_cubes<6>( esop::esop_from_pprm( tt6 ) ) == tt6 );
+  }
+}
+
 TEST_CASE( "Create optimum ESOP from random truth table", "[constructors]" )
 {
   static const int size = 4;
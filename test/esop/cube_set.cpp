@@ -0,0 +1,69 @@
+#include <catch.hpp>
+
+#include <easy/esop/cube_manipulators.hpp>
+#include <easy/esop/cube_set.hpp>
+#include <easy/esop/esop_from_pkrm.hpp>
+#include <kitty/constructors.hpp>
+
+#include <random>
+
+using namespace easy;
+
+TEST_CASE( "Cancel and merge cubes in a cube set", "[cube_set]" )
+{
+  esop::cube_set cubes( 3u );
+  cubes.add( kitty::cube( "11-" ) );
+  cubes.add( kitty::cube( "10-" ) ); /* merges into 1-- */
+  CHECK( cubes.size() == 1u );
+  CHECK( cubes.contains( kitty::cube( "1--" ) ) );
+
+  cubes.add( kitty::cube( "0--" ) ); /* merges into ---, i.e., constant 1 */
+  CHECK( cubes.size() == 1u );
+  CHECK( cubes.contains( kitty::cube( "---" ) ) );
+
+  cubes.add( kitty::cube( "---" ) ); /* cancels */
+  CHECK( cubes.empty() );
+
+  esop::cube_set no_merging( 3u, false );
+  no_merging.add( kitty::cube( "11-" ) );
+  no_merging.add( kitty::cube( "10-" ) );
+  CHECK( no_merging.size() == 2u );
+}
+
+TEST_CASE( "Cube set agrees with linear distance-1 merging", "[cube_set]" )
+{
+  std::mt19937 gen( 0xcafe );
+  auto const num_vars = 8u;
+
+  for ( auto i = 0; i < 50; ++i )
+  {
+    esop::cube_set cubes( num_vars );
+    std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> reference;
+    for ( auto j = 0; j < 200; ++j )
+    {
+      kitty::cube c;
+      for ( auto l = 0u; l < num_vars; ++l )
+      {
+        auto const v = gen() % 3;
+        if ( v != 2 ) c.add_literal( l, v );
+      }
+      cubes.add( c );
+      esop::detail::add_to_cubes( reference, c );
+    }
+
+    auto const esop = cubes.esop();
+    CHECK( esop::equivalent_esops( esop, esop::esop_t( reference.begin(), reference.end() ), num_vars ) );
+    CHECK( ( esop.size() < 2u || esop::min_pairwise_distance( esop ) >= 2u ) );
+  }
+}
+
+TEST_CASE( "Create PKRM from random truth table with 14 variables", "[cube_set]" )
+{
+  kitty::dynamic_truth_table tt( 14u );
+  kitty::create_random( tt );
+
+  auto const cubes = esop::esop_from_optimum_pkrm( tt );
+  auto tt_copy = tt.construct();
+  create_from_cubes( tt_copy, cubes, true );
+  CHECK( tt == tt_copy );
+}
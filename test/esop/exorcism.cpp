@@ -0,0 +1,81 @@
+#include <catch.hpp>
+
+#include <easy/esop/constructors.hpp>
+#include <easy/esop/exorcism.hpp>
+#include <kitty/constructors.hpp>
+
+using namespace easy;
+
+TEST_CASE( "Minimize PPRM of random truth tables with EXORCISM", "[exorcism]" )
+{
+  kitty::static_truth_table<8> tt;
+
+  for ( auto i = 0; i < 20; ++i )
+  {
+    kitty::create_random( tt );
+    auto const pprm = esop::esop_from_pprm( tt );
+
+    esop::exorcism_params ps;
+    ps.seed += i;
+    esop::exorcism_statistics st;
+    auto const esop = esop::exorcism_minimizer( st, ps ).minimize( pprm );
+
+    CHECK( esop.size() <= pprm.size() );
+    CHECK( st.initial_cubes == pprm.size() );
+    CHECK( st.cubes == esop.size() );
+    CHECK( esop::equivalent_esops( esop, pprm, 8 ) );
+  }
+}
+
+TEST_CASE( "Minimize PKRM of random truth tables with EXORCISM", "[exorcism]" )
+{
+  kitty::static_truth_table<10> tt;
+
+  for ( auto i = 0; i < 10; ++i )
+  {
+    kitty::create_random( tt );
+    auto const pkrm = esop::esop_from_optimum_pkrm( tt );
+
+    esop::exorcism_params ps;
+    ps.max_distance = 3u;
+    ps.num_restarts = 1u;
+    auto const esop = esop::exorcism( pkrm, ps );
+
+    CHECK( esop.size() <= pkrm.size() );
+    CHECK( esop::equivalent_esops( esop, pkrm, 10 ) );
+  }
+}
+
+TEST_CASE( "EXORCISM reshapes distance-2 cubes into a smaller ESOP", "[exorcism]" )
+{
+  /* ~x0 ~x1 ~x2 ^ x1 ~x2 ^ x0 ~x1 x2: the cubes are pairwise at
+     distance 2 or 3, hence no cubes cancel or merge when they are
+     inserted, but an EXORLINK-2 transformation of a distance-2 pair
+     yields cubes that merge into x0 ~x1 ^ ~x2 */
+  esop::esop_t const esop = {kitty::cube( "000" ), kitty::cube( "-10" ), kitty::cube( "101" )};
+  CHECK( esop[0].distance( esop[1] ) == 2 );
+  CHECK( esop[0].distance( esop[2] ) == 2 );
+  CHECK( esop[1].distance( esop[2] ) == 3 );
+
+  esop::exorcism_params ps;
+  ps.max_distance = 2u;
+  esop::exorcism_statistics st;
+  auto const minimized = esop::exorcism_minimizer( st, ps ).minimize( esop );
+  CHECK( minimized.size() == 2u );
+  CHECK( st.rewrites > 0u );
+  CHECK( esop::equivalent_esops( minimized, esop, 3 ) );
+}
+
+TEST_CASE( "EXORCISM respects its iteration budget", "[exorcism]" )
+{
+  kitty::static_truth_table<8> tt;
+  kitty::create_random( tt );
+  auto const pprm = esop::esop_from_pprm( tt );
+
+  esop::exorcism_params ps;
+  ps.max_iterations = 10u;
+  esop::exorcism_statistics st;
+  auto const esop = esop::exorcism_minimizer( st, ps ).minimize( pprm );
+  CHECK( st.pairs <= 10u );
+  CHECK( esop::equivalent_esops( esop, pprm, 8 ) );
+}
@@ -0,0 +1,77 @@
+#include <catch.hpp>
+
+#include <easy/esop/exorlink.hpp>
+#include <kitty/constructors.hpp>
+
+#include <random>
+
+using namespace easy;
+
+namespace
+{
+
+template<uint32_t Distance>
+void check_exorlink_kernels( std::uint32_t const* groups )
+{
+  std::mt19937 gen( 0xcafe );
+  auto const num_vars = 8u;
+
+  for ( auto i = 0u; i < 100u; )
+  {
+    kitty::cube c0, c1;
+    for ( auto l = 0u; l < num_vars; ++l )
+    {
+      auto const v0 = gen() % 3, v1 = gen() % 3;
+      if ( v0 != 2 ) c0.add_literal( l, v0 );
+      if ( v1 != 2 ) c1.add_literal( l, v1 );
+    }
+    if ( uint32_t( c0.distance( c1 ) ) != Distance )
+    {
+      continue;
+    }
+    ++i;
+
+    kitty::dynamic_truth_table tt( num_vars );
+    kitty::create_from_cubes( tt, {c0, c1}, true );
+
+    std::array<std::array<kitty::cube, Distance>, esop::exorlink_num_groups<Distance>> all;
+    esop::exorlink_all<Distance>( c0, c1, all );
+
+    for ( auto g = 0u; g < esop::exorlink_num_groups<Distance>; ++g )
+    {
+      std::array<kitty::cube, Distance> cubes;
+      esop::exorlink<Distance>( c0, c1, g, cubes );
+      CHECK( cubes == all[g] );
+
+      auto const reference = esop::exorlink( c0, c1, Distance, groups + g * Distance * Distance );
+      CHECK( std::equal( cubes.begin(), cubes.end(), reference.begin(), reference.end() ) );
+
+      auto tt_copy = tt.construct();
+      kitty::create_from_cubes( tt_copy, std::vector<kitty::cube>( cubes.begin(), cubes.end() ), true );
+      CHECK( tt == tt_copy );
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE( "Generated EXORLINK tables", "[exorlink]" )
+{
+  CHECK( esop::cube_groups2.size() == 8u );
+  CHECK( esop::cube_groups3.size() == 54u );
+  CHECK( esop::cube_groups4.size() == 384u );
+  CHECK( esop::cube_groups5.size() == 3000u );
+  CHECK( esop::cube_groups6.size() == 25920u );
+
+  std::array<uint32_t, 16> const group16 = {2, 0, 0, 0, 1, 2, 0, 0, 1, 1, 0, 2, 1, 1, 2, 1};
+  CHECK( std::equal( group16.begin(), group16.end(), esop::cube_groups4.begin() + 16 ) );
+}
+
+TEST_CASE( "Specialized EXORLINK kernels", "[exorlink]" )
+{
+  check_exorlink_kernels<2>( &esop::cube_groups2[0] );
+  check_exorlink_kernels<3>( &esop::cube_groups3[0] );
+  check_exorlink_kernels<4>( &esop::cube_groups4[0] );
+  check_exorlink_kernels<5>( &esop::cube_groups5[0] );
+  check_exorlink_kernels<6>( &esop::cube_groups6[0] );
+}
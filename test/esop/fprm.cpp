@@ -0,0 +1,80 @@
+#include <catch.hpp>
+
+#include <easy/esop/constructors.hpp>
+#include <easy/esop/cost.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+
+#include <algorithm>
+
+using namespace easy;
+
+TEST_CASE( "Find best FPRM of random truth tables", "[fprm]" )
+{
+  for ( auto n = 0u; n <= 8u; ++n )
+  {
+    kitty::dynamic_truth_table tt( n );
+    for ( auto i = 0; i < 5; ++i )
+    {
+      kitty::create_random( tt );
+
+      esop::fprm_statistics st;
+      auto const cubes = esop::esop_from_best_fprm( tt, st );
+      CHECK( st.polarities == ( 1u << n ) );
+      CHECK( st.cost == cubes.size() );
+
+      auto tt_copy = tt.construct();
+      kitty::create_from_cubes( tt_copy, cubes, true );
+      CHECK( tt == tt_copy );
+
+      /* each variable occurs in the chosen polarity only */
+      for ( const auto& c : cubes )
+      {
+        CHECK( ( c._bits & st.polarity ) == 0u );
+      }
+
+      /* compare with all polarities expanded from the PPRM */
+      auto const pprm = esop::esop_from_pprm( tt );
+      auto best = pprm.size();
+      for ( auto p = 0u; p < ( 1u << n ); ++p )
+      {
+        std::vector<bool> negated( n );
+        for ( auto v = 0u; v < n; ++v )
+        {
+          negated[v] = ( p >> v ) & 1u;
+        }
+        best = std::min( best, esop::fprm_from_esop( pprm, n, negated ).size() );
+      }
+      CHECK( cubes.size() == best );
+    }
+  }
+}
+
+TEST_CASE( "Find best FPRM with respect to T-count with multiple threads", "[fprm]" )
+{
+  kitty::dynamic_truth_table tt( 10u );
+  for ( auto i = 0; i < 10; ++i )
+  {
+    kitty::create_random( tt );
+
+    esop::fprm_params ps;
+    ps.cost = esop::fprm_cost::T_count;
+    esop::fprm_statistics st1;
+    auto const cubes1 = esop::esop_from_best_fprm( tt, st1, ps );
+    CHECK( st1.cost == esop::T_count( cubes1, 10u ) );
+
+    ps.num_threads = 3u;
+    esop::fprm_statistics st3;
+    auto const cubes3 = esop::esop_from_best_fprm( tt, st3, ps );
+    CHECK( st3.polarities == 1024u );
+    CHECK( st3.polarity == st1.polarity );
+    CHECK( st3.cost == st1.cost );
+
+    auto tt_copy = tt.construct();
+    kitty::create_from_cubes( tt_copy, cubes3, true );
+    CHECK( tt == tt_copy );
+
+    /* no worse than the PPRM */
+    CHECK( st1.cost <= esop::T_count( esop::esop_from_pprm( tt ), 10u ) );
+  }
+}
@@ -0,0 +1,75 @@
+#include <catch.hpp>
+
+#include <easy/esop/packed_esop.hpp>
+
+#include <random>
+
+using namespace easy;
+
+namespace
+{
+
+esop::esop_t random_esop( std::mt19937& gen, uint32_t num_cubes, uint32_t num_vars )
+{
+  esop::esop_t esop;
+  for ( auto i = 0u; i < num_cubes; ++i )
+  {
+    kitty::cube c;
+    for ( auto l = 0u; l < num_vars; ++l )
+    {
+      auto const v = gen() % 3;
+      if ( v != 2 ) c.add_literal( l, v );
+    }
+    esop.push_back( c );
+  }
+  return esop;
+}
+
+} // namespace
+
+TEST_CASE( "Convert between ESOP and packed ESOP", "[packed_esop]" )
+{
+  std::mt19937 gen( 0xcafe );
+  auto const esop = random_esop( gen, 100u, 32u );
+
+  esop::packed_esop const packed( esop );
+  CHECK( packed.size() == esop.size() );
+  CHECK( reinterpret_cast<std::uintptr_t>( packed.bits() ) % 64u == 0u );
+  CHECK( reinterpret_cast<std::uintptr_t>( packed.masks() ) % 64u == 0u );
+  CHECK( packed.esop() == esop );
+}
+
+TEST_CASE( "Pairwise distances of packed ESOPs", "[packed_esop]" )
+{
+  std::mt19937 gen( 0xcafe );
+
+  for ( auto num_cubes : {0u, 1u, 2u, 7u, 17u, 100u, 1000u} )
+  {
+    auto const esop = random_esop( gen, num_cubes, 20u );
+    esop::packed_esop const packed( esop );
+
+    for ( auto backend : {esop::simd_backend::scalar, esop::simd_backend::avx2, esop::simd_backend::avx512} )
+    {
+      if ( !esop::simd_backend_supported( backend ) )
+      {
+        continue;
+      }
+
+      for ( auto num_threads : {1u, 3u} )
+      {
+        esop::pairwise_distance_params ps;
+        ps.backend = backend;
+        ps.num_threads = num_threads;
+        auto const st = esop::pairwise_distances( packed, ps );
+
+        CHECK( st.pairs == num_cubes * ( num_cubes - ( num_cubes > 0u ? 1u : 0u ) ) / 2u );
+        CHECK( st.min == esop::min_pairwise_distance( esop ) );
+        CHECK( st.max == esop::max_pairwise_distance( esop ) );
+        if ( st.pairs > 0u )
+        {
+          CHECK( st.avg == Approx( esop::avg_pairwise_distance( esop ) ) );
+        }
+      }
+    }
+  }
+}
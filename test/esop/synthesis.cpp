@@ -0,0 +1,329 @@
+#include <catch.hpp>
+
+#include <easy/esop/synthesis.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/print.hpp>
+
+using namespace easy;
+
+namespace
+{
+
+esop::spec random_spec( uint32_t num_vars )
+{
+  kitty::dynamic_truth_table tt( num_vars );
+  kitty::create_random( tt );
+
+  std::string bits = kitty::to_binary( tt );
+  std::reverse( bits.begin(), bits.end() );
+  return esop::spec{bits, std::string( bits.size(), '1' )};
+}
+
+} // namespace
+
+TEST_CASE( "Incremental minimum synthesis finds the same number of terms", "[synthesis]" )
+{
+  auto const max_k = 6u;
+
+  for ( auto i = 0; i < 20; ++i )
+  {
+    auto const spec = random_spec( 4 );
+
+    esop::minimum_synthesizer_params ps;
+    ps.begin = 1;
+    ps.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= max_k || sat.is_sat() ) return false; ++k; return true; };
+
+    esop::minimum_synthesizer synth( spec );
+    auto const r = synth.synthesize( ps );
+
+    ps.incremental = true;
+    ps.max_number_of_terms = max_k;
+
+    esop::minimum_synthesizer synth_inc( spec );
+    auto const r_inc = synth_inc.synthesize( ps );
+
+    CHECK( r.state == r_inc.state );
+    if ( r && r_inc )
+    {
+      CHECK( r.esop.size() == r_inc.esop.size() );
+      CHECK( esop::verify_esop( r_inc.esop, spec.bits, spec.care ) );
+    }
+
+    auto const stats = synth_inc.stats();
+    CHECK( stats["incremental"] == true );
+    CHECK( stats["bounds"].size() > 0u );
+  }
+}
+
+TEST_CASE( "Symmetry breaking preserves the set of minimum ESOPs", "[synthesis]" )
+{
+  for ( auto i = 0; i < 20; ++i )
+  {
+    auto const spec = random_spec( 3 );
+
+    nlohmann::json config;
+    config["one_esop"] = false;
+    config["symmetry_breaking"] = false;
+    auto esops = esop::detail::exact_synthesis_from_binary_string( spec.bits, spec.care, config );
+
+    config["symmetry_breaking"] = true;
+    auto esops_sb = esop::detail::exact_synthesis_from_binary_string( spec.bits, spec.care, config );
+
+    std::sort( esops.begin(), esops.end() );
+    std::sort( esops_sb.begin(), esops_sb.end() );
+    CHECK( esops == esops_sb );
+  }
+}
+
+TEST_CASE( "Minimum synthesis with symmetry breaking", "[synthesis]" )
+{
+  auto const max_k = 6u;
+
+  for ( auto i = 0; i < 20; ++i )
+  {
+    auto const spec = random_spec( 4 );
+
+    esop::minimum_synthesizer_params ps;
+    ps.begin = 1;
+    ps.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= max_k || sat.is_sat() ) return false; ++k; return true; };
+
+    auto const r = esop::minimum_synthesizer( spec ).synthesize( ps );
+
+    ps.symmetry_breaking = true;
+    auto const r_sb = esop::minimum_synthesizer( spec ).synthesize( ps );
+
+    ps.incremental = true;
+    ps.max_number_of_terms = max_k;
+    auto const r_inc = esop::minimum_synthesizer( spec ).synthesize( ps );
+
+    CHECK( r.esop.size() == r_sb.esop.size() );
+    CHECK( r.esop.size() == r_inc.esop.size() );
+    CHECK( esop::verify_esop( r_sb.esop, spec.bits, spec.care ) );
+    CHECK( esop::verify_esop( r_inc.esop, spec.bits, spec.care ) );
+
+    esop::minimum_all_synthesizer_params all_ps;
+    all_ps.begin = r.esop.size();
+    all_ps.next = []( uint32_t&, sat::sat_solver::result ) { return false; };
+    all_ps.symmetry_breaking = true;
+    for ( auto const& e : esop::minimum_all_synthesizer( spec ).synthesize( all_ps ) )
+    {
+      CHECK( e.size() == r.esop.size() );
+      CHECK( esop::verify_esop( e, spec.bits, spec.care ) );
+    }
+  }
+}
+
+TEST_CASE( "Minimum synthesis with native XOR clauses", "[synthesis]" )
+{
+  auto const max_k = 6u;
+
+  for ( auto i = 0; i < 20; ++i )
+  {
+    auto const spec = random_spec( 4 );
+
+    esop::minimum_synthesizer_params ps;
+    ps.begin = 1;
+    ps.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= max_k || sat.is_sat() ) return false; ++k; return true; };
+
+    auto const r = esop::minimum_synthesizer( spec ).synthesize( ps );
+
+    ps.native_xor = true;
+    auto const r_native = esop::minimum_synthesizer( spec ).synthesize( ps );
+
+    ps.incremental = true;
+    ps.max_number_of_terms = max_k;
+    auto const r_inc = esop::minimum_synthesizer( spec ).synthesize( ps );
+
+    CHECK( r.esop.size() == r_native.esop.size() );
+    CHECK( r.esop.size() == r_inc.esop.size() );
+    CHECK( esop::verify_esop( r_native.esop, spec.bits, spec.care ) );
+    CHECK( esop::verify_esop( r_inc.esop, spec.bits, spec.care ) );
+
+    esop::simple_synthesizer_params simple_ps;
+    simple_ps.number_of_terms = r.esop.size();
+    simple_ps.native_xor = true;
+    auto const r_simple = esop::simple_synthesizer( spec ).synthesize( simple_ps );
+    CHECK( esop::verify_esop( r_simple.esop, spec.bits, spec.care ) );
+  }
+}
+
+TEST_CASE( "Minimum synthesis with a SAT-solver portfolio", "[synthesis]" )
+{
+  auto const max_k = 6u;
+
+  for ( auto i = 0; i < 5; ++i )
+  {
+    auto const spec = random_spec( 4 );
+
+    esop::minimum_synthesizer_params ps;
+    ps.begin = 1;
+    ps.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= max_k || sat.is_sat() ) return false; ++k; return true; };
+
+    auto const r = esop::minimum_synthesizer( spec ).synthesize( ps );
+
+    ps.portfolio = sat2::default_portfolio( 4u );
+    esop::minimum_synthesizer synth( spec );
+    auto const r_portfolio = synth.synthesize( ps );
+    CHECK( r.esop.size() == r_portfolio.esop.size() );
+    CHECK( esop::verify_esop( r_portfolio.esop, spec.bits, spec.care ) );
+    CHECK( synth.stats()["winners"].size() > 0u );
+
+    ps.incremental = true;
+    ps.max_number_of_terms = max_k;
+    ps.native_xor = true;
+    esop::minimum_synthesizer synth_inc( spec );
+    auto const r_inc = synth_inc.synthesize( ps );
+    CHECK( r.esop.size() == r_inc.esop.size() );
+    CHECK( esop::verify_esop( r_inc.esop, spec.bits, spec.care ) );
+    CHECK( synth_inc.stats()["bounds"][0].count( "winner" ) == 1u );
+
+    esop::simple_synthesizer_params simple_ps;
+    simple_ps.number_of_terms = r.esop.size();
+    simple_ps.portfolio = sat2::default_portfolio( 2u );
+    esop::simple_synthesizer simple( spec );
+    auto const r_simple = simple.synthesize( simple_ps );
+    CHECK( esop::verify_esop( r_simple.esop, spec.bits, spec.care ) );
+    CHECK( simple.stats().count( "winner" ) == 1u );
+  }
+}
+
+TEST_CASE( "Minimum synthesis with lazily encoded minterms", "[synthesis]" )
+{
+  auto const max_k = 6u;
+
+  for ( auto i = 0; i < 20; ++i )
+  {
+    auto const spec = random_spec( 4 );
+
+    esop::minimum_synthesizer_params ps;
+    ps.begin = 1;
+    ps.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= max_k || sat.is_sat() ) return false; ++k; return true; };
+
+    auto const r = esop::minimum_synthesizer( spec ).synthesize( ps );
+
+    ps.cegar = true;
+    ps.cegar_sample_size = 4u;
+    ps.cegar_counterexamples = i % 3;
+    ps.native_xor = i % 2 == 0;
+    esop::minimum_synthesizer synth( spec );
+    auto const r_cegar = synth.synthesize( ps );
+    CHECK( r.state == r_cegar.state );
+    CHECK( r.esop.size() == r_cegar.esop.size() );
+    CHECK( esop::verify_esop( r_cegar.esop, spec.bits, spec.care ) );
+    CHECK( synth.stats()["cegar_iterations"] >= synth.stats()["k"] );
+
+    ps.incremental = true;
+    ps.max_number_of_terms = max_k;
+    esop::minimum_synthesizer synth_inc( spec );
+    auto const r_inc = synth_inc.synthesize( ps );
+    CHECK( r.esop.size() == r_inc.esop.size() );
+    CHECK( esop::verify_esop( r_inc.esop, spec.bits, spec.care ) );
+    CHECK( synth_inc.stats()["sample_size"] <= 16u );
+
+    /* one term less is unrealizable (constants are not synthesized) */
+    if ( r.esop.size() > 1u )
+    {
+      esop::simple_synthesizer_params simple_ps;
+      simple_ps.number_of_terms = r.esop.size() - 1u;
+      simple_ps.cegar = true;
+      CHECK( esop::simple_synthesizer( spec ).synthesize( simple_ps ).is_unrealizable() );
+    }
+  }
+
+  /* x0 x1 x2 ^ x3 x4 x5 ^ x6 x7 on 8 variables */
+  std::string bits( 256u, '0' );
+  for ( auto m = 0u; m < 256u; ++m )
+  {
+    bool const value = ( ( m & 7u ) == 7u ) ^ ( ( ( m >> 3 ) & 7u ) == 7u ) ^ ( ( ( m >> 6 ) & 3u ) == 3u );
+    bits[m] = value ? '1' : '0';
+  }
+  esop::spec const spec{bits, std::string( 256u, '1' )};
+
+  esop::simple_synthesizer_params ps;
+  ps.number_of_terms = 3u;
+  ps.cegar = true;
+  esop::simple_synthesizer synth( spec );
+  auto const r = synth.synthesize( ps );
+  CHECK( r.is_realizable() );
+  CHECK( esop::verify_esop( r.esop, spec.bits, spec.care ) );
+  CHECK( synth.stats()["sample_size"] < 256u );
+}
+
+TEST_CASE( "Enumeration of minimum ESOPs with lazily encoded minterms", "[synthesis]" )
+{
+  auto const max_k = 6u;
+
+  for ( auto i = 0; i < 10; ++i )
+  {
+    auto const spec = random_spec( 3 );
+
+    esop::minimum_synthesizer_params ps;
+    ps.begin = 1;
+    ps.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= max_k || sat.is_sat() ) return false; ++k; return true; };
+    auto const r = esop::minimum_synthesizer( spec ).synthesize( ps );
+
+    /* downwards search, the state is restored after the last unsat bound */
+    esop::minimum_all_synthesizer_params all_ps;
+    all_ps.begin = r.esop.size() + 1;
+    all_ps.next = []( uint32_t& k, sat::sat_solver::result sat ) { if ( k <= 1u || !sat.is_sat() ) return false; --k; return true; };
+    all_ps.symmetry_breaking = i % 2 == 0;
+    auto esops = esop::minimum_all_synthesizer( spec ).synthesize( all_ps );
+
+    all_ps.cegar = true;
+    all_ps.cegar_sample_size = 2u;
+    all_ps.cegar_counterexamples = i % 3;
+    esop::minimum_all_synthesizer synth( spec );
+    auto esops_cegar = synth.synthesize( all_ps );
+
+    CHECK( esops.size() > 0u );
+    for ( auto const& e : esops_cegar )
+    {
+      CHECK( e.size() == r.esop.size() );
+      CHECK( esop::verify_esop( e, spec.bits, spec.care ) );
+    }
+
+    std::sort( esops.begin(), esops.end() );
+    std::sort( esops_cegar.begin(), esops_cegar.end() );
+    CHECK( esops == esops_cegar );
+    CHECK( synth.stats()["sample_size"] <= 8u );
+  }
+}
+
+TEST_CASE( "Lazily encoded minterms share the conflict limit of a bound", "[synthesis]" )
+{
+  auto const max_k = 8u;
+  auto const conflict_limit = 20;
+
+  for ( auto i = 0; i < 5; ++i )
+  {
+    auto const spec = random_spec( 6 );
+
+    esop::minimum_synthesizer_params ps;
+    ps.begin = 1;
+    ps.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= max_k || sat.is_sat() ) return false; ++k; return true; };
+    ps.conflict_limit = conflict_limit;
+    ps.incremental = true;
+    ps.max_number_of_terms = max_k;
+    ps.cegar = true;
+    ps.cegar_sample_size = 2u;
+    ps.cegar_counterexamples = 1u;
+
+    esop::minimum_synthesizer synth( spec );
+    auto const r = synth.synthesize( ps );
+    if ( r )
+    {
+      CHECK( esop::verify_esop( r.esop, spec.bits, spec.care ) );
+    }
+
+    /* Glucose checks its budget only between restarts, so a bound may
+       overshoot the limit, but no refinement runs after it is used up */
+    auto const stats = synth.stats();
+    for ( auto const& bound : stats["bounds"] )
+    {
+      if ( bound["conflicts"].get<int>() >= conflict_limit )
+      {
+        CHECK( bound["state"] == "unknown" );
+      }
+    }
+  }
+}
@@ -0,0 +1,184 @@
+#include <catch.hpp>
+
+#include <easy/esop/cube_set.hpp>
+#include <easy/esop/esop_from_pprm.hpp>
+#include <easy/esop/exorlink.hpp>
+#include <easy/esop/wide_cube.hpp>
+#include <easy/io/read_esop.hpp>
+#include <easy/io/write_esop.hpp>
+#include <kitty/constructors.hpp>
+
+#include <random>
+#include <sstream>
+
+using namespace easy;
+
+namespace
+{
+
+kitty::cube random_cube( std::mt19937& gen, uint32_t num_vars )
+{
+  kitty::cube c;
+  for ( auto l = 0u; l < num_vars; ++l )
+  {
+    auto const v = gen() % 3;
+    if ( v != 2 ) c.add_literal( l, v );
+  }
+  return c;
+}
+
+template<typename Cube>
+Cube widen( kitty::cube const& c, uint32_t offset, uint32_t num_vars )
+{
+  Cube w( num_vars );
+  for ( auto l = 0u; l < 32u; ++l )
+  {
+    if ( c.get_mask( l ) )
+    {
+      w.add_literal( l + offset, c.get_bit( l ) );
+    }
+  }
+  return w;
+}
+
+template<typename Cube>
+void check_wide_cube( uint32_t num_vars )
+{
+  std::mt19937 gen( 0xcafe );
+  for ( auto i = 0; i < 100; ++i )
+  {
+    auto const a = random_cube( gen, 12u ), b = random_cube( gen, 12u );
+    /* place the variables across the boundary of the first two words
+       (variables 58, ..., 69), or in the middle of the single word of cube64 */
+    auto const offset = num_vars > 64u ? 58u : num_vars / 2u - 6u;
+    auto const wa = widen<Cube>( a, offset, num_vars ), wb = widen<Cube>( b, offset, num_vars );
+
+    CHECK( wa.distance( wb ) == a.distance( b ) );
+    CHECK( wa.num_literals() == a.num_literals() );
+    CHECK( ( wa == wb ) == ( a == b ) );
+    if ( a.distance( b ) == 1 )
+    {
+      CHECK( wa.merge( wb ) == widen<Cube>( a.merge( b ), offset, num_vars ) );
+    }
+
+    std::stringstream ss;
+    wa.print( num_vars, ss );
+    CHECK( Cube( ss.str() ) == wa );
+  }
+}
+
+} // namespace
+
+TEST_CASE( "Wide cubes agree with 32-bit cubes", "[wide_cube]" )
+{
+  check_wide_cube<esop::cube64>( 64u );
+  check_wide_cube<esop::cube128>( 128u );
+  check_wide_cube<esop::cube256>( 256u );
+  check_wide_cube<esop::dynamic_cube>( 100u );
+}
+
+TEST_CASE( "Cube set with wide cubes", "[wide_cube]" )
+{
+  std::mt19937 gen( 0xcafe );
+  for ( auto i = 0; i < 20; ++i )
+  {
+    esop::cube_set cubes( 10u );
+    esop::basic_cube_set<esop::cube128> wide_cubes( 128u );
+    for ( auto j = 0; j < 100; ++j )
+    {
+      auto const c = random_cube( gen, 10u );
+      cubes.add( c );
+      wide_cubes.add( widen<esop::cube128>( c, 60u, 128u ) );
+    }
+
+    CHECK( cubes.size() == wide_cubes.size() );
+    for ( const auto& c : cubes )
+    {
+      CHECK( wide_cubes.contains( widen<esop::cube128>( c, 60u, 128u ) ) );
+    }
+  }
+}
+
+TEST_CASE( "PPRM from ESOP forms", "[wide_cube]" )
+{
+  std::mt19937 gen( 0xcafe );
+  for ( auto i = 0; i < 20; ++i )
+  {
+    esop::esop_t esop;
+    for ( auto j = 0; j < 10; ++j )
+    {
+      esop.push_back( random_cube( gen, 8u ) );
+    }
+
+    kitty::dynamic_truth_table tt( 8u );
+    kitty::create_from_cubes( tt, esop, true );
+
+    auto pprm = esop::pprm_from_esop( esop, 8u );
+    auto expected = esop::esop_from_pprm( tt );
+    std::sort( pprm.begin(), pprm.end() );
+    std::sort( expected.begin(), expected.end() );
+    CHECK( pprm == expected );
+
+    std::vector<bool> negated( 8u );
+    for ( auto v = 0u; v < 8u; ++v )
+    {
+      negated[v] = gen() % 2;
+    }
+    CHECK( esop::equivalent_esops( esop::fprm_from_esop( esop, 8u, negated ), esop, 8u ) );
+
+    esop::basic_esop_t<esop::cube128> wide;
+    for ( const auto& c : esop )
+    {
+      wide.push_back( widen<esop::cube128>( c, 0u, 128u ) );
+    }
+    CHECK( esop::pprm_from_esop( wide, 128u ).size() == pprm.size() );
+  }
+}
+
+TEST_CASE( "EXORLINK on wide cubes", "[wide_cube]" )
+{
+  std::mt19937 gen( 0xcafe );
+  for ( auto i = 0u; i < 100u; )
+  {
+    auto const c0 = random_cube( gen, 8u ), c1 = random_cube( gen, 8u );
+    if ( c0.distance( c1 ) != 3 )
+    {
+      continue;
+    }
+    ++i;
+
+    std::array<std::array<kitty::cube, 3>, esop::exorlink_num_groups<3>> results;
+    esop::exorlink_all<3>( c0, c1, results );
+
+    std::array<std::array<esop::dynamic_cube, 3>, esop::exorlink_num_groups<3>> wide_results;
+    esop::exorlink_all<3>( widen<esop::dynamic_cube>( c0, 90u, 100u ), widen<esop::dynamic_cube>( c1, 90u, 100u ), wide_results );
+
+    for ( auto g = 0u; g < results.size(); ++g )
+    {
+      for ( auto k = 0u; k < 3u; ++k )
+      {
+        CHECK( wide_results[g][k] == widen<esop::dynamic_cube>( results[g][k], 90u, 100u ) );
+      }
+    }
+  }
+}
+
+TEST_CASE( "Write and read ESOP forms with 100 inputs", "[wide_cube]" )
+{
+  std::mt19937 gen( 0xcafe );
+  esop::basic_esop_t<esop::cube128> esop;
+  for ( auto j = 0; j < 10; ++j )
+  {
+    esop.push_back( widen<esop::cube128>( random_cube( gen, 32u ), 68u, 128u ) );
+  }
+
+  std::stringstream ss;
+  write_esop( ss, esop, 100u );
+
+  esop::basic_esop_t<esop::cube128> read;
+  unsigned num_vars;
+  esop_storage_reader reader( read, num_vars );
+  CHECK( lorina::read_pla( ss, reader ) == lorina::return_code::success );
+  CHECK( num_vars == 100u );
+  CHECK( read == esop );
+}
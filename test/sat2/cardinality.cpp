@@ -2,6 +2,9 @@
 #include <easy/sat2/sat_solver.hpp>
 #include <easy/sat2/cardinality.hpp>
 
+#include <numeric>
+#include <vector>
+
 using namespace easy;
 
 TEST_CASE( "Enumerate cardinality-5 solutions", "[cardinality]" )
@@ -178,3 +181,159 @@ TEST_CASE( "Increase cardinality n=7, k=3 to cardinality k=6", "[cardinality]" )
   CHECK( num_k2_solutions == 29 );
   CHECK( num_k5_solutions == 91 );
 }
+
+static std::vector<sat2::cardinality_encoding> const encodings = {
+  sat2::cardinality_encoding::totalizer,
+  sat2::cardinality_encoding::sequential_counter,
+  sat2::cardinality_encoding::cardinality_network,
+  sat2::cardinality_encoding::modulo_totalizer
+};
+
+TEST_CASE( "Tighten cardinality constraints of all encodings", "[cardinality]" )
+{
+  for ( const auto& encoding : encodings )
+  {
+    for ( auto n = 1u; n <= 7u; ++n )
+    {
+      for ( auto rhs = 0u; rhs <= n; ++rhs )
+      {
+        sat2::sat_solver_statistics stats;
+        sat2::sat_solver_params ps;
+        sat2::sat_solver solver( stats, ps );
+
+        int sid = 1;
+        std::vector<int> lits;
+        for ( auto i = 0u; i < n; ++i )
+        {
+          lits.emplace_back( sid++ );
+        }
+
+        std::vector<std::vector<int>> cls;
+        auto const c = sat2::create_cardinality_constraint( cls, sid, lits, rhs, encoding );
+        for ( const auto& cl : cls )
+        {
+          solver.add_clause( cl );
+        }
+
+        /* tighten the bound from rhs down to 0 */
+        for ( int k = rhs; k >= 0; --k )
+        {
+          cls.clear();
+          auto const bound = sat2::bound_cardinality_constraint( cls, sid, c, k );
+          for ( const auto& cl : cls )
+          {
+            solver.add_clause( cl );
+          }
+
+          for ( auto a = 0u; a < ( 1u << n ); ++a )
+          {
+            auto assumptions = bound;
+            for ( auto i = 0u; i < n; ++i )
+            {
+              assumptions.emplace_back( ( ( a >> i ) & 1 ) ? lits[i] : -lits[i] );
+            }
+
+            auto const expected = __builtin_popcount( a ) <= k ? sat2::sat_solver::state::sat : sat2::sat_solver::state::unsat;
+            CHECK( solver.solve( assumptions ) == expected );
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE( "Tighten pseudo-Boolean constraints", "[cardinality]" )
+{
+  std::vector<uint64_t> const all_weights = { 3, 1, 5, 5, 0, 2, 7 };
+  for ( auto n = 1u; n <= all_weights.size(); ++n )
+  {
+    std::vector<uint64_t> const weights( all_weights.begin(), all_weights.begin() + n );
+    auto const total = std::accumulate( weights.begin(), weights.end(), uint64_t( 0u ) );
+    for ( auto rhs = 0u; rhs <= total; rhs += 3u )
+    {
+      sat2::sat_solver_statistics stats;
+      sat2::sat_solver_params ps;
+      sat2::sat_solver solver( stats, ps );
+
+      int sid = 1;
+      std::vector<int> lits;
+      for ( auto i = 0u; i < n; ++i )
+      {
+        lits.emplace_back( sid++ );
+      }
+
+      std::vector<std::vector<int>> cls;
+      auto const c = sat2::create_pb_constraint( cls, sid, lits, weights, rhs );
+      for ( const auto& cl : cls )
+      {
+        solver.add_clause( cl );
+      }
+      CHECK( c.sums.size() <= rhs + 2u );
+
+      /* tighten the bound from rhs down to 0 */
+      for ( int k = rhs; k >= 0; --k )
+      {
+        auto const bound = sat2::bound_pb_constraint( c, k );
+        for ( auto a = 0u; a < ( 1u << n ); ++a )
+        {
+          auto assumptions = bound;
+          uint64_t sum = 0u;
+          for ( auto i = 0u; i < n; ++i )
+          {
+            assumptions.emplace_back( ( ( a >> i ) & 1 ) ? lits[i] : -lits[i] );
+            sum += ( ( a >> i ) & 1 ) ? weights[i] : 0u;
+          }
+
+          auto const expected = sum <= uint64_t( k ) ? sat2::sat_solver::state::sat : sat2::sat_solver::state::unsat;
+          CHECK( solver.solve( assumptions ) == expected );
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE( "Compute the size of cardinality encodings", "[cardinality]" )
+{
+  for ( const auto& encoding : encodings )
+  {
+    for ( auto n = 1u; n <= 40u; ++n )
+    {
+      for ( auto rhs : { 0u, 1u, 2u, 3u, 5u, 8u, 13u, 21u, 34u } )
+      {
+        int sid = n + 1;
+        std::vector<int> lits( n );
+        std::iota( lits.begin(), lits.end(), 1 );
+
+        std::vector<std::vector<int>> cls;
+        auto const c = sat2::create_cardinality_constraint( cls, sid, lits, rhs, encoding );
+        CHECK( c.encoding == encoding );
+
+        auto const size = sat2::compute_cardinality_encoding_size( encoding, n, rhs );
+        CHECK( size.clauses == cls.size() );
+        CHECK( size.variables == uint64_t( sid - int( n ) - 1 ) );
+      }
+    }
+  }
+}
+
+TEST_CASE( "Select the smallest cardinality encoding", "[cardinality]" )
+{
+  for ( auto n : { 2u, 10u, 100u, 1000u } )
+  {
+    for ( auto rhs : { 1u, 5u, 50u, 500u } )
+    {
+      auto const selected = sat2::select_cardinality_encoding( n, rhs );
+      auto const size = sat2::compute_cardinality_encoding_size( selected, n, rhs );
+      for ( const auto& encoding : encodings )
+      {
+        CHECK( size.clauses <= sat2::compute_cardinality_encoding_size( encoding, n, rhs ).clauses );
+      }
+
+      int sid = n + 1;
+      std::vector<int> lits( n );
+      std::iota( lits.begin(), lits.end(), 1 );
+      std::vector<std::vector<int>> cls;
+      CHECK( sat2::create_cardinality_constraint( cls, sid, lits, rhs ).encoding == selected );
+    }
+  }
+}
@@ -1,6 +1,8 @@
 #include <catch.hpp>
 #include <easy/sat2/maxsat.hpp>
 
+#include <random>
+
 using namespace easy;
 
 template<typename Algorithm>
@@ -56,13 +58,12 @@ void no_soft_clauses_test()
 }
 
 template<typename Algorithm>
-void sat_soft_clauses_test()
+void sat_soft_clauses_test( sat2::maxsat_solver_params ps = {} )
 {
   int sid = 1;
 
   using maxsat_solver_t = sat2::maxsat_solver<Algorithm>;
   sat2::maxsat_solver_statistics stats;
-  sat2::maxsat_solver_params ps;
   maxsat_solver_t solver( stats, ps, sid );
 
   /* allocate variables */
@@ -148,6 +149,9 @@ TEST_CASE( "Test unsatisfiable hard-clauses", "[sat]" )
   unsat_hard_clauses_test<sat2::maxsat_linear>();
   unsat_hard_clauses_test<sat2::maxsat_uc>();
   unsat_hard_clauses_test<sat2::maxsat_rc2>();
+  unsat_hard_clauses_test<sat2::maxsat_oll>();
+  unsat_hard_clauses_test<sat2::maxsat_pmres>();
+  unsat_hard_clauses_test<sat2::maxsat_lsu>();
 }
 
 TEST_CASE( "Test no soft clauses", "[sat]" )
@@ -155,6 +159,9 @@ TEST_CASE( "Test no soft clauses", "[sat]" )
   no_soft_clauses_test<sat2::maxsat_linear>();
   no_soft_clauses_test<sat2::maxsat_uc>();
   no_soft_clauses_test<sat2::maxsat_rc2>();
+  no_soft_clauses_test<sat2::maxsat_oll>();
+  no_soft_clauses_test<sat2::maxsat_pmres>();
+  no_soft_clauses_test<sat2::maxsat_lsu>();
 }
 
 TEST_CASE( "Test satisfiable soft-clauses", "[sat]" )
@@ -162,6 +169,9 @@ TEST_CASE( "Test satisfiable soft-clauses", "[sat]" )
   sat_soft_clauses_test<sat2::maxsat_linear>();
   sat_soft_clauses_test<sat2::maxsat_uc>();
   sat_soft_clauses_test<sat2::maxsat_rc2>();
+  sat_soft_clauses_test<sat2::maxsat_oll>();
+  sat_soft_clauses_test<sat2::maxsat_pmres>();
+  sat_soft_clauses_test<sat2::maxsat_lsu>();
 }
 
 TEST_CASE( "Test unsatisfiable soft-clauses", "[sat]" )
@@ -169,4 +179,284 @@ TEST_CASE( "Test unsatisfiable soft-clauses", "[sat]" )
   unsat_soft_clauses_test<sat2::maxsat_linear>();
   unsat_soft_clauses_test<sat2::maxsat_uc>();
   unsat_soft_clauses_test<sat2::maxsat_rc2>();
+  unsat_soft_clauses_test<sat2::maxsat_oll>();
+  unsat_soft_clauses_test<sat2::maxsat_pmres>();
+  unsat_soft_clauses_test<sat2::maxsat_lsu>();
+}
+
+/* random weighted instance; returns the optimum cost by enumeration */
+int64_t make_weighted_instance( std::vector<std::vector<int>>& hard, std::vector<std::vector<int>>& soft, std::vector<int>& weights, uint32_t num_vars, uint64_t seed, std::vector<int> const& levels = { 1, 1, 2, 3, 8 } )
+{
+  std::mt19937 gen( seed );
+  auto const random_clause = [&]( uint32_t size ){
+    std::vector<int> clause;
+    for ( auto i = 0u; i < size; ++i )
+    {
+      auto const v = int( gen() % num_vars ) + 1;
+      clause.emplace_back( gen() % 2 ? v : -v );
+    }
+    return clause;
+  };
+
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    hard.emplace_back( random_clause( 3u ) );
+  }
+  for ( auto i = 0u; i < 24u; ++i )
+  {
+    soft.emplace_back( random_clause( 1u + gen() % 2u ) );
+    weights.emplace_back( levels[gen() % levels.size()] );
+  }
+
+  auto const satisfied = [&]( std::vector<int> const& clause, uint32_t assignment ){
+    for ( const auto& l : clause )
+    {
+      if ( ( ( assignment >> ( std::abs( l ) - 1 ) ) & 1 ) == ( l > 0 ) )
+        return true;
+    }
+    return false;
+  };
+
+  int64_t best = -1;
+  for ( auto a = 0u; a < ( 1u << num_vars ); ++a )
+  {
+    if ( !std::all_of( hard.begin(), hard.end(), [&]( auto const& c ){ return satisfied( c, a ); } ) )
+      continue;
+
+    int64_t cost = 0;
+    for ( auto i = 0u; i < soft.size(); ++i )
+    {
+      if ( !satisfied( soft[i], a ) )
+        cost += weights[i];
+    }
+    if ( best < 0 || cost < best )
+      best = cost;
+  }
+  return best;
+}
+
+template<typename Algorithm>
+void weighted_soft_clauses_test( sat2::maxsat_solver_params ps )
+{
+  for ( auto seed = 0u; seed < 20u; ++seed )
+  {
+    std::vector<std::vector<int>> hard, soft;
+    std::vector<int> weights;
+    auto const num_vars = 8u;
+    auto const optimum = make_weighted_instance( hard, soft, weights, num_vars, seed );
+    if ( optimum < 0 )
+      continue;
+
+    int sid = num_vars + 1;
+
+    using maxsat_solver_t = sat2::maxsat_solver<Algorithm>;
+    sat2::maxsat_solver_statistics stats;
+    maxsat_solver_t solver( stats, ps, sid );
+
+    for ( const auto& c : hard )
+      solver.add_clause( c );
+    for ( auto i = 0u; i < soft.size(); ++i )
+      solver.add_soft_clause( soft[i], weights[i] );
+
+    auto const result = solver.solve();
+    CHECK( result == maxsat_solver_t::state::success );
+
+    int64_t cost = 0;
+    for ( const auto& c : solver.get_disabled_clauses() )
+      cost += weights[c];
+    CHECK( cost == optimum );
+    CHECK( stats.cost == optimum );
+  }
+}
+
+TEST_CASE( "Test weighted soft-clauses with RC2 options", "[sat]" )
+{
+  sat2::maxsat_solver_params ps;
+  weighted_soft_clauses_test<sat2::maxsat_rc2>( ps );
+
+  ps.stratification = false;
+  ps.exhaust_cores = false;
+  weighted_soft_clauses_test<sat2::maxsat_rc2>( ps );
+
+  ps.stratification = true;
+  ps.diversity_ratio = 0.0;
+  weighted_soft_clauses_test<sat2::maxsat_rc2>( ps );
+
+  ps.exhaust_cores = true;
+  ps.trim_cores = 4u;
+  ps.minimize_cores = true;
+  weighted_soft_clauses_test<sat2::maxsat_rc2>( ps );
+}
+
+TEST_CASE( "Test weighted soft-clauses with OLL and PM-RES", "[sat]" )
+{
+  sat2::maxsat_solver_params ps;
+  weighted_soft_clauses_test<sat2::maxsat_oll>( ps );
+  weighted_soft_clauses_test<sat2::maxsat_pmres>( ps );
+
+  ps.stratification = false;
+  weighted_soft_clauses_test<sat2::maxsat_oll>( ps );
+  weighted_soft_clauses_test<sat2::maxsat_pmres>( ps );
+
+  ps.trim_cores = 4u;
+  ps.minimize_cores = true;
+  weighted_soft_clauses_test<sat2::maxsat_oll>( ps );
+  weighted_soft_clauses_test<sat2::maxsat_pmres>( ps );
+}
+
+TEST_CASE( "Test weighted soft-clauses with LSU", "[sat]" )
+{
+  sat2::maxsat_solver_params ps;
+  weighted_soft_clauses_test<sat2::maxsat_lsu>( ps );
+
+  ps.stratification = false;
+  weighted_soft_clauses_test<sat2::maxsat_lsu>( ps );
+}
+
+TEST_CASE( "Test large weights with LSU", "[sat]" )
+{
+  /* the weights are not expanded into unary inputs */
+  for ( auto seed = 0u; seed < 10u; ++seed )
+  {
+    std::vector<std::vector<int>> hard, soft;
+    std::vector<int> weights;
+    auto const num_vars = 8u;
+    auto const optimum = make_weighted_instance( hard, soft, weights, num_vars, seed, { 1000003, 1000033, 2000003, 3999971, 7999993 } );
+    if ( optimum < 0 )
+      continue;
+
+    int sid = num_vars + 1;
+    sat2::maxsat_solver_params ps;
+    ps.stratification = false;
+
+    using maxsat_solver_t = sat2::maxsat_solver<sat2::maxsat_lsu>;
+    sat2::maxsat_solver_statistics stats;
+    maxsat_solver_t solver( stats, ps, sid );
+    for ( const auto& c : hard )
+      solver.add_clause( c );
+    for ( auto i = 0u; i < soft.size(); ++i )
+      solver.add_soft_clause( soft[i], weights[i] );
+
+    CHECK( solver.solve() == maxsat_solver_t::state::success );
+    CHECK( stats.optimal );
+    CHECK( stats.cost == optimum );
+    CHECK( sid < 100000 );
+  }
+}
+
+TEST_CASE( "Distinguish a timeout from unsatisfiable hard-clauses in LSU", "[sat]" )
+{
+  using maxsat_solver_t = sat2::maxsat_solver<sat2::maxsat_lsu>;
+
+  std::vector<std::vector<int>> hard, soft;
+  std::vector<int> weights;
+  auto const num_vars = 8u;
+  REQUIRE( make_weighted_instance( hard, soft, weights, num_vars, 0u ) >= 0 );
+
+  /* the budget is exceeded before the first solution */
+  {
+    int sid = num_vars + 1;
+    sat2::maxsat_solver_params ps;
+    ps.conflict_limit = 0;
+    sat2::maxsat_solver_statistics stats;
+    maxsat_solver_t solver( stats, ps, sid );
+    for ( const auto& c : hard )
+      solver.add_clause( c );
+    for ( auto i = 0u; i < soft.size(); ++i )
+      solver.add_soft_clause( soft[i], weights[i] );
+
+    CHECK( solver.solve() == maxsat_solver_t::state::timeout );
+    CHECK( stats.improvements == 0u );
+    CHECK( !stats.optimal );
+  }
+
+  /* unsatisfiable hard-clauses fail within the budget */
+  {
+    int sid = num_vars + 1;
+    sat2::maxsat_solver_params ps;
+    ps.conflict_limit = 1000;
+    sat2::maxsat_solver_statistics stats;
+    maxsat_solver_t solver( stats, ps, sid );
+    solver.add_clause( { 1 } );
+    solver.add_clause( { -1 } );
+    solver.add_soft_clause( { 2 } );
+
+    CHECK( solver.solve() == maxsat_solver_t::state::fail );
+  }
+}
+
+TEST_CASE( "Bound linear search and LSU with all cardinality encodings", "[sat]" )
+{
+  for ( auto const encoding : { sat2::cardinality_encoding::totalizer, sat2::cardinality_encoding::sequential_counter,
+                                sat2::cardinality_encoding::cardinality_network, sat2::cardinality_encoding::modulo_totalizer } )
+  {
+    sat2::maxsat_solver_params ps;
+    ps.cardinality = encoding;
+    sat_soft_clauses_test<sat2::maxsat_linear>( ps );
+    sat_soft_clauses_test<sat2::maxsat_lsu>( ps );
+    weighted_soft_clauses_test<sat2::maxsat_lsu>( ps );
+  }
+}
+
+TEST_CASE( "Report improving solutions in LSU", "[sat]" )
+{
+  std::vector<std::vector<int>> hard, soft;
+  std::vector<int> weights;
+  auto const num_vars = 8u;
+  auto const optimum = make_weighted_instance( hard, soft, weights, num_vars, 3u );
+  REQUIRE( optimum >= 0 );
+
+  std::vector<int64_t> costs;
+  sat2::maxsat_solver_params ps;
+  ps.on_improvement = [&]( int64_t cost, std::vector<int> const& disabled_clauses ){
+    int64_t sum = 0;
+    for ( const auto& c : disabled_clauses )
+      sum += weights[c];
+    CHECK( sum == cost );
+    costs.push_back( cost );
+  };
+
+  int sid = num_vars + 1;
+  using maxsat_solver_t = sat2::maxsat_solver<sat2::maxsat_lsu>;
+  sat2::maxsat_solver_statistics stats;
+  maxsat_solver_t solver( stats, ps, sid );
+  for ( const auto& c : hard )
+    solver.add_clause( c );
+  for ( auto i = 0u; i < soft.size(); ++i )
+    solver.add_soft_clause( soft[i], weights[i] );
+
+  CHECK( solver.solve() == maxsat_solver_t::state::success );
+  CHECK( stats.optimal );
+  CHECK( stats.cost == optimum );
+  CHECK( costs.size() == stats.improvements );
+  CHECK( std::is_sorted( costs.rbegin(), costs.rend() ) );
+  CHECK( std::adjacent_find( costs.begin(), costs.end() ) == costs.end() );
+  CHECK( costs.back() == optimum );
+}
+
+TEST_CASE( "Exhaust cores in RC2", "[sat]" )
+{
+  int sid = 1;
+
+  using maxsat_solver_t = sat2::maxsat_solver<sat2::maxsat_rc2>;
+  sat2::maxsat_solver_statistics stats;
+  sat2::maxsat_solver_params ps;
+  maxsat_solver_t solver( stats, ps, sid );
+
+  std::vector<int> v;
+  for ( auto i = 0; i < 4; ++i )
+    v.emplace_back( sid++ );
+
+  /* at most one of the variables is true */
+  for ( auto i = 0; i < 4; ++i )
+    for ( auto j = i + 1; j < 4; ++j )
+      solver.add_clause( { -v[i], -v[j] } );
+
+  for ( auto i = 0; i < 4; ++i )
+    solver.add_soft_clause( { v[i] } );
+
+  CHECK( solver.solve() == maxsat_solver_t::state::success );
+  CHECK( solver.get_disabled_clauses().size() == 3u );
+  CHECK( stats.cost == 3 );
+  CHECK( stats.cores >= 1u );
 }
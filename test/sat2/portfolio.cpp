@@ -0,0 +1,148 @@
+#include <catch.hpp>
+#include <easy/sat2/maxsat.hpp>
+#include <easy/sat2/sat_solver.hpp>
+
+using namespace easy;
+
+namespace
+{
+
+/* pigeons p are put into holes h: variable p * num_holes + h + 1 */
+void add_pigeon_hole( sat2::sat_solver& solver, int num_pigeons, int num_holes )
+{
+  auto const var = [&]( int p, int h ) { return p * num_holes + h + 1; };
+  for ( auto p = 0; p < num_pigeons; ++p )
+  {
+    std::vector<int> clause;
+    for ( auto h = 0; h < num_holes; ++h )
+    {
+      clause.emplace_back( var( p, h ) );
+    }
+    solver.add_clause( clause );
+  }
+
+  for ( auto h = 0; h < num_holes; ++h )
+  {
+    for ( auto p = 0; p < num_pigeons; ++p )
+    {
+      for ( auto q = p + 1; q < num_pigeons; ++q )
+      {
+        solver.add_clause( {-var( p, h ), -var( q, h )} );
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE( "Each portfolio backend solves incrementally", "[portfolio]" )
+{
+  using sat2::solver_backend;
+  for ( const auto& backend : {solver_backend::glucose, solver_backend::ghack, solver_backend::maple, solver_backend::bsat2} )
+  {
+    sat2::sat_solver_statistics stats;
+    sat2::sat_solver_params ps;
+    ps.portfolio = {{backend, 0u, sat2::phase_mode::standard}};
+    sat2::sat_solver solver( stats, ps );
+
+    add_pigeon_hole( solver, 4, 4 );
+    CHECK( solver.solve() == sat2::sat_solver::state::sat );
+    CHECK( solver.get_num_variables() == 16u );
+
+    /* every pigeon has a hole */
+    auto const m = solver.get_model();
+    for ( auto p = 0; p < 4; ++p )
+    {
+      CHECK( ( m[4 * p + 1] || m[4 * p + 2] || m[4 * p + 3] || m[4 * p + 4] ) );
+    }
+
+    /* pigeon 0 must not use any hole */
+    CHECK( solver.solve( {-1, -2, -3, -4} ) == sat2::sat_solver::state::unsat );
+    auto const core = solver.get_core();
+    CHECK( core.size() > 0u );
+    for ( auto i = 0u; i < core.size(); ++i )
+    {
+      CHECK( ( core[i] >= -4 && core[i] <= -1 ) );
+    }
+
+    /* XOR-clauses are translated into clauses */
+    solver.add_xor_clause( {1, 2}, true );
+    solver.add_xor_clause( {1, 6}, false );
+    CHECK( solver.solve( {1} ) == sat2::sat_solver::state::sat );
+    CHECK( !solver.get_model()[2] );
+    CHECK( solver.get_model()[6] );
+
+    CHECK( stats.portfolio.names.size() == 1u );
+    CHECK( stats.portfolio.last_winner == 0 );
+    CHECK( stats.portfolio.num_calls == 3u );
+    CHECK( stats.portfolio.wins[0] == 3u );
+  }
+}
+
+TEST_CASE( "Portfolio races diversified solvers", "[portfolio]" )
+{
+  auto const configs = sat2::default_portfolio( 6u );
+  CHECK( configs.size() == 6u );
+  CHECK( sat2::to_string( configs[0u] ) == "glucose" );
+  CHECK( sat2::to_string( configs[5u] ) == "bsat2/seed=6/phase=positive" );
+
+  sat2::sat_solver_statistics stats;
+  sat2::sat_solver_params ps;
+  ps.portfolio = configs;
+  sat2::sat_solver solver( stats, ps );
+
+  add_pigeon_hole( solver, 7, 6 );
+  CHECK( solver.solve() == sat2::sat_solver::state::unsat );
+  CHECK( stats.portfolio.last_winner >= 0 );
+  CHECK( stats.portfolio.last_winner_name() == stats.portfolio.names[stats.portfolio.last_winner] );
+
+  /* a conflict budget that is too small for all solvers */
+  sat2::sat_solver_statistics budget_stats;
+  sat2::sat_solver_params budget_ps;
+  budget_ps.portfolio = configs;
+  budget_ps.budget = 10;
+  sat2::sat_solver budget_solver( budget_stats, budget_ps );
+  add_pigeon_hole( budget_solver, 9, 8 );
+  CHECK( budget_solver.solve() == sat2::sat_solver::state::dirty );
+  CHECK( budget_stats.portfolio.last_winner == -1 );
+}
+
+TEST_CASE( "Portfolio reuses its workers across calls", "[portfolio]" )
+{
+  sat2::sat_solver_statistics stats;
+  sat2::sat_solver_params ps;
+  ps.portfolio = sat2::default_portfolio( 4u );
+  sat2::sat_solver solver( stats, ps );
+
+  add_pigeon_hole( solver, 4, 4 );
+  for ( auto i = 0; i < 100; ++i )
+  {
+    /* pigeon i % 4 must not use hole 0 (SAT) or any hole (UNSAT) */
+    auto const p = i % 4;
+    CHECK( solver.solve( {-( 4 * p + 1 )} ) == sat2::sat_solver::state::sat );
+    CHECK( solver.solve( {-( 4 * p + 1 ), -( 4 * p + 2 ), -( 4 * p + 3 ), -( 4 * p + 4 )} ) == sat2::sat_solver::state::unsat );
+  }
+  CHECK( stats.portfolio.num_calls == 200u );
+}
+
+TEST_CASE( "MaxSAT with a SAT-solver portfolio", "[portfolio]" )
+{
+  int sid = 1;
+  sat2::maxsat_solver_statistics stats;
+  sat2::maxsat_solver_params ps;
+  ps.sat.portfolio = sat2::default_portfolio( 4u );
+  sat2::maxsat_solver<sat2::maxsat_rc2> solver( stats, ps, sid );
+
+  /* at most one of 1, 2, 3 */
+  sid = 4;
+  solver.add_clause( {-1, -2} );
+  solver.add_clause( {-1, -3} );
+  solver.add_clause( {-2, -3} );
+  solver.add_soft_clause( {1}, 1 );
+  solver.add_soft_clause( {2}, 1 );
+  solver.add_soft_clause( {3}, 1 );
+
+  CHECK( solver.solve() == sat2::maxsat_solver<sat2::maxsat_rc2>::state::success );
+  CHECK( solver.get_disabled_clauses().size() == 2u );
+  CHECK( stats.sat.portfolio.num_calls > 0u );
+}
@@ -1,8 +1,11 @@
 #include <catch.hpp>
+#include <easy/sat/sat_solver.hpp>
 #include <easy/sat2/sat_solver.hpp>
 #include <easy/sat2/core_utils.hpp>
 #include <fmt/printf.h>
+#include <algorithm>
 #include <fstream>
+#include <random>
 
 using namespace easy;
 
@@ -208,3 +211,187 @@ TEST_CASE( "Test unsat core extraction", "[sat]" )
   /* verify that it's an unsat core */
   CHECK( solver.solve( cs ) == sat2::sat_solver::state::unsat );
 }
+
+TEST_CASE( "Test native XOR clauses", "[sat]" )
+{
+  std::default_random_engine gen( 0xcafe );
+  std::uniform_int_distribution<int> dist( 0, 1 );
+
+  auto const num_vars = 8u;
+  for ( auto i = 0; i < 50; ++i )
+  {
+    sat2::sat_solver_statistics stats;
+    sat2::sat_solver_params ps;
+    sat2::sat_solver solver( stats, ps );
+    solver.add_clause( { int( num_vars ), -int( num_vars ) } ); /* allocate all variables */
+
+    /* random XOR clauses and a clause */
+    std::vector<std::vector<int>> xor_clauses;
+    std::vector<bool> values;
+    for ( auto j = 0; j < 5; ++j )
+    {
+      std::vector<int> clause;
+      for ( auto v = 1u; v <= num_vars; ++v )
+      {
+        if ( dist( gen ) )
+        {
+          clause.emplace_back( dist( gen ) ? v : -int( v ) );
+        }
+      }
+      if ( clause.empty() )
+      {
+        continue;
+      }
+      xor_clauses.emplace_back( clause );
+      values.emplace_back( dist( gen ) );
+      solver.add_xor_clause( clause, values.back() );
+    }
+    std::vector<int> const clause = { 1, -2, 3 };
+    solver.add_clause( clause );
+
+    /* count solutions */
+    auto expected = 0u;
+    for ( auto a = 0u; a < ( 1u << num_vars ); ++a )
+    {
+      auto const value = [&]( int l ){ return bool( ( a >> ( abs( l ) - 1 ) ) & 1 ) == ( l > 0 ); };
+
+      bool sat = std::any_of( clause.begin(), clause.end(), value );
+      for ( auto j = 0u; j < xor_clauses.size(); ++j )
+      {
+        bool parity = false;
+        for ( const auto& l : xor_clauses[j] )
+        {
+          parity ^= value( l );
+        }
+        sat = sat && parity == values[j];
+      }
+      expected += sat;
+    }
+
+    auto count = 0u;
+    while ( solver.solve() == sat2::sat_solver::state::sat )
+    {
+      ++count;
+      auto const m = solver.get_model();
+      std::vector<int> blocking;
+      for ( auto v = 1u; v <= num_vars; ++v )
+      {
+        blocking.emplace_back( m[v] ? -int( v ) : v );
+      }
+      solver.add_clause( blocking );
+    }
+    CHECK( count == expected );
+  }
+}
+
+TEST_CASE( "Test native XOR clauses with assumptions", "[sat]" )
+{
+  sat2::sat_solver_statistics stats;
+  sat2::sat_solver_params ps;
+  sat2::sat_solver solver( stats, ps );
+
+  /* x1 ^ x2 ^ x3 = 1, x2 ^ x3 = 0, hence x1 = 1 */
+  solver.add_xor_clause( { 1, 2, 3 } );
+  solver.add_xor_clause( { 2, -3 } );
+
+  CHECK( solver.solve() == sat2::sat_solver::state::sat );
+  CHECK( solver.get_model()[1] );
+  CHECK( solver.solve( { -1 } ) == sat2::sat_solver::state::unsat );
+  CHECK( solver.solve( { 2, -3 } ) == sat2::sat_solver::state::unsat );
+  CHECK( solver.solve( { 2 } ) == sat2::sat_solver::state::sat );
+  CHECK( solver.get_model()[3] );
+
+  /* x3 ^ x4 = 1 */
+  solver.add_xor_clause( { 3, 4 } );
+  CHECK( solver.solve( { 2, 4 } ) == sat2::sat_solver::state::unsat );
+  CHECK( solver.solve( { 2, -4 } ) == sat2::sat_solver::state::sat );
+
+  /* x1 ^ x4 = 1 implies x4 = 0, x3 = 1, and x2 = 1 */
+  solver.add_xor_clause( { 1, 4 } );
+  CHECK( solver.solve() == sat2::sat_solver::state::sat );
+  CHECK( solver.get_model()[2] );
+  CHECK( solver.get_model()[3] );
+  CHECK( !solver.get_model()[4] );
+
+  solver.add_clause( { -2 } );
+  CHECK( solver.solve() == sat2::sat_solver::state::unsat );
+}
+
+namespace
+{
+
+/* pigeon-hole principle: n + 1 pigeons do not fit into n holes */
+void add_pigeon_hole( sat::constraints& constraints, int n )
+{
+  auto const var = [n]( int p, int h ) { return 1 + p * n + h; };
+  for ( auto p = 0; p <= n; ++p )
+  {
+    std::vector<int> clause;
+    for ( auto h = 0; h < n; ++h )
+    {
+      clause.push_back( var( p, h ) );
+    }
+    constraints.add_clause( clause );
+  }
+  for ( auto h = 0; h < n; ++h )
+  {
+    for ( auto p = 0; p <= n; ++p )
+    {
+      for ( auto q = p + 1; q <= n; ++q )
+      {
+        constraints.add_clause( {-var( p, h ), -var( q, h )} );
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE( "Conflict limit and per-call conflict budget", "[sat]" )
+{
+  {
+    /* the conflict limit bounds the conflicts over all calls */
+    sat::constraints constraints;
+    add_pigeon_hole( constraints, 8 );
+    sat::sat_solver solver;
+    solver.set_conflict_limit( 100 );
+    CHECK( solver.solve( constraints ).is_undef() );
+    auto const conflicts = solver.get_conflicts();
+    CHECK( conflicts >= 100 );
+    CHECK( solver.solve( constraints ).is_undef() );
+    CHECK( solver.get_conflicts() == conflicts );
+  }
+
+  {
+    /* the per-call budget starts afresh for each call */
+    sat::constraints constraints;
+    add_pigeon_hole( constraints, 8 );
+    sat::sat_solver solver;
+    solver.set_conflict_budget_per_call( 100 );
+    CHECK( solver.solve( constraints ).is_undef() );
+    auto const conflicts = solver.get_conflicts();
+    CHECK( solver.solve( constraints ).is_undef() );
+    CHECK( solver.get_conflicts() >= conflicts + 100 );
+  }
+}
+
+TEST_CASE( "Number of learnt clauses with and without a portfolio", "[sat]" )
+{
+  {
+    sat::constraints constraints;
+    add_pigeon_hole( constraints, 5 );
+    sat::sat_solver solver;
+    CHECK( solver.solve( constraints ).is_unsat() );
+    CHECK( solver.get_num_learnts() > 0 );
+  }
+
+  {
+    /* the learnt clauses of the portfolio are not counted */
+    sat::constraints constraints;
+    add_pigeon_hole( constraints, 5 );
+    sat::sat_solver solver;
+    solver.set_portfolio( sat2::default_portfolio( 2u ) );
+    CHECK( solver.solve( constraints ).is_unsat() );
+    CHECK( solver.get_num_learnts() == 0 );
+  }
+}
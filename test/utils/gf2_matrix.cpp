@@ -0,0 +1,155 @@
+#include <catch.hpp>
+
+#include <easy/utils/gf2_matrix.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace easy;
+
+namespace
+{
+
+utils::gf2_matrix random_matrix( std::default_random_engine& gen, uint32_t num_rows, uint32_t num_cols, double density )
+{
+  std::bernoulli_distribution dist( density );
+
+  utils::gf2_matrix m( num_rows, num_cols );
+  for ( auto r = 0u; r < num_rows; ++r )
+  {
+    for ( auto c = 0u; c < num_cols; ++c )
+    {
+      m.set( r, c, dist( gen ) );
+    }
+  }
+  return m;
+}
+
+bool equal( utils::gf2_matrix const& a, utils::gf2_matrix const& b )
+{
+  for ( auto r = 0u; r < a.num_rows(); ++r )
+  {
+    for ( auto c = 0u; c < a.num_cols(); ++c )
+    {
+      if ( a.get( r, c ) != b.get( r, c ) )
+        return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+TEST_CASE( "Row operations on GF(2) matrix", "[gf2_matrix]" )
+{
+  utils::gf2_matrix m( 2, 130 );
+  CHECK( m.num_words() == 3u );
+
+  m.set( 0, 0 );
+  m.set( 0, 129 );
+  m.set( 1, 64 );
+  m.flip( 1, 129 );
+  CHECK( m.get( 0, 0 ) );
+  CHECK( !m.get( 0, 64 ) );
+  CHECK( m.get( 1, 129 ) );
+
+  m.add_row( 0, 1 );
+  CHECK( m.get( 0, 0 ) );
+  CHECK( m.get( 0, 64 ) );
+  CHECK( !m.get( 0, 129 ) );
+
+  std::vector<uint32_t> ones;
+  m.foreach_one( 0, [&]( uint32_t c ){ ones.push_back( c ); } );
+  CHECK( ones == std::vector<uint32_t>{0, 64} );
+
+  m.swap_rows( 0, 1 );
+  CHECK( !m.get( 0, 0 ) );
+  CHECK( m.get( 1, 0 ) );
+}
+
+TEST_CASE( "Dispatched XOR of words agrees with the scalar kernel", "[gf2_matrix]" )
+{
+  std::default_random_engine gen( 7 );
+  std::uniform_int_distribution<uint64_t> dist;
+
+  for ( auto n = 0u; n <= 11u; ++n )
+  {
+    std::vector<uint64_t> src( n ), dst( n );
+    std::generate( src.begin(), src.end(), [&]() { return dist( gen ); } );
+    std::generate( dst.begin(), dst.end(), [&]() { return dist( gen ); } );
+
+    auto expected = dst;
+    utils::detail::xor_words_scalar( expected.data(), src.data(), n );
+    utils::detail::xor_words( dst.data(), src.data(), n );
+    CHECK( dst == expected );
+  }
+}
+
+TEST_CASE( "Reduced row echelon form of random GF(2) matrices", "[gf2_matrix]" )
+{
+  std::default_random_engine gen( 0xcafe );
+
+  for ( auto i = 0; i < 50; ++i )
+  {
+    auto const num_rows = 1u + gen() % 150u;
+    auto const num_cols = 1u + gen() % 300u;
+    auto const density = ( i % 3 == 0 ) ? 0.05 : 0.5;
+
+    auto m = random_matrix( gen, num_rows, num_cols, density );
+    auto const original = m;
+    auto m_blocked = m;
+
+    auto const pivots = m.reduced_row_echelon_form( num_cols, 1u );
+    auto const pivots_blocked = m_blocked.reduced_row_echelon_form( num_cols, 8u );
+
+    /* reduced row echelon form is unique */
+    CHECK( pivots == pivots_blocked );
+    CHECK( equal( m, m_blocked ) );
+
+    bool is_rref = true;
+    for ( auto r = 0u; r < num_rows; ++r )
+    {
+      for ( auto p = 0u; p < pivots.size(); ++p )
+      {
+        is_rref = is_rref && m.get( r, pivots[p] ) == ( r == p );
+      }
+
+      if ( r < pivots.size() )
+      {
+        /* leading one */
+        for ( auto c = 0u; c < pivots[r]; ++c )
+        {
+          is_rref = is_rref && !m.get( r, c );
+        }
+      }
+      else
+      {
+        /* zero row */
+        m.foreach_one( r, [&]( uint32_t ){ is_rref = false; } );
+      }
+    }
+    CHECK( is_rref );
+
+    /* the row space is preserved */
+    bool in_row_space = true;
+    for ( auto r = 0u; r < num_rows; ++r )
+    {
+      utils::gf2_matrix x( pivots.size() + 1u, num_cols );
+      for ( auto p = 0u; p < pivots.size(); ++p )
+      {
+        std::copy_n( m.row( p ), m.num_words(), x.row( p ) );
+      }
+      std::copy_n( original.row( r ), m.num_words(), x.row( pivots.size() ) );
+
+      for ( auto p = 0u; p < pivots.size(); ++p )
+      {
+        if ( x.get( pivots.size(), pivots[p] ) )
+        {
+          x.add_row( pivots.size(), p );
+        }
+      }
+      x.foreach_one( pivots.size(), [&]( uint32_t ){ in_row_space = false; } );
+    }
+    CHECK( in_row_space );
+  }
+}
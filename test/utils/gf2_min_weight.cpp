@@ -0,0 +1,180 @@
+#include <catch.hpp>
+
+#include <easy/utils/gf2_min_weight.hpp>
+
+#include <random>
+
+using namespace easy;
+
+namespace
+{
+
+utils::gf2_matrix random_system( std::default_random_engine& gen, uint32_t num_rows, uint32_t num_vars )
+{
+  std::bernoulli_distribution dist( 0.5 );
+
+  utils::gf2_matrix m( num_rows, num_vars + 1u );
+  for ( auto r = 0u; r < num_rows; ++r )
+  {
+    for ( auto c = 0u; c <= num_vars; ++c )
+    {
+      m.set( r, c, dist( gen ) );
+    }
+  }
+  return m;
+}
+
+/* minimum cost of a solution by enumeration, -1 if there is none */
+int64_t brute_force_min_cost( utils::gf2_matrix const& m, std::vector<int64_t> const& costs )
+{
+  auto const num_vars = m.num_cols() - 1u;
+
+  int64_t best = -1;
+  for ( auto x = 0u; x < ( 1u << num_vars ); ++x )
+  {
+    bool satisfied = true;
+    for ( auto r = 0u; r < m.num_rows() && satisfied; ++r )
+    {
+      bool sum = m.get( r, num_vars );
+      for ( auto c = 0u; c < num_vars; ++c )
+      {
+        sum ^= m.get( r, c ) && ( ( x >> c ) & 1 );
+      }
+      satisfied = !sum;
+    }
+    if ( !satisfied )
+    {
+      continue;
+    }
+
+    int64_t cost = 0;
+    for ( auto c = 0u; c < num_vars; ++c )
+    {
+      cost += ( ( x >> c ) & 1 ) ? costs[c] : 0;
+    }
+    if ( best == -1 || cost < best )
+    {
+      best = cost;
+    }
+  }
+  return best;
+}
+
+bool is_solution( utils::gf2_matrix const& m, std::vector<uint32_t> const& solution )
+{
+  auto const num_vars = m.num_cols() - 1u;
+  for ( auto r = 0u; r < m.num_rows(); ++r )
+  {
+    bool sum = m.get( r, num_vars );
+    for ( const auto& c : solution )
+    {
+      sum ^= m.get( r, c );
+    }
+    if ( sum )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+TEST_CASE( "Minimum-weight solutions of random systems", "[gf2_min_weight]" )
+{
+  std::default_random_engine gen( 0xcafe );
+  std::uniform_int_distribution<int64_t> cost_dist( 1, 5 );
+
+  bool all_consistent = true;
+  bool all_minimum = true;
+  for ( auto i = 0; i < 50; ++i )
+  {
+    auto const m = random_system( gen, 6u, 12u );
+
+    std::vector<int64_t> unit_costs( 12u, 1 );
+    std::vector<int64_t> costs( 12u );
+    for ( auto& c : costs )
+    {
+      c = cost_dist( gen );
+    }
+
+    for ( const auto& cs : {unit_costs, costs} )
+    {
+      auto const expected = brute_force_min_cost( m, cs );
+
+      utils::min_weight_solver_statistics stats;
+      utils::min_weight_solver_params ps;
+      ps.max_iterations = 200u;
+      utils::min_weight_solver solver( m, cs, stats, ps );
+
+      auto const consistent = solver.solve();
+      all_consistent = all_consistent && ( consistent == ( expected != -1 ) );
+      if ( consistent )
+      {
+        all_minimum = all_minimum && solver.cost() == expected && is_solution( m, solver.solution() );
+      }
+    }
+  }
+  CHECK( all_consistent );
+  CHECK( all_minimum );
+}
+
+TEST_CASE( "Minimum-weight solutions corner cases", "[gf2_min_weight]" )
+{
+  utils::min_weight_solver_statistics stats;
+  utils::min_weight_solver_params ps;
+
+  /* x0 + x1 = 1, x0 + x1 = 0 */
+  utils::gf2_matrix inconsistent( 2u, 3u );
+  inconsistent.set( 0u, 0u );
+  inconsistent.set( 0u, 1u );
+  inconsistent.set( 0u, 2u );
+  inconsistent.set( 1u, 0u );
+  inconsistent.set( 1u, 1u );
+  std::vector<int64_t> costs( 2u, 1 );
+  CHECK( !utils::min_weight_solver( inconsistent, costs, stats, ps ).solve() );
+
+  /* homogeneous system */
+  utils::gf2_matrix homogeneous( 1u, 3u );
+  homogeneous.set( 0u, 0u );
+  homogeneous.set( 0u, 1u );
+  utils::min_weight_solver solver( homogeneous, costs, stats, ps );
+  CHECK( solver.solve() );
+  CHECK( solver.solution().empty() );
+  CHECK( solver.is_optimal() );
+}
+
+TEST_CASE( "Anytime and multi-threaded minimum-weight search", "[gf2_min_weight]" )
+{
+  std::default_random_engine gen( 0xbeef );
+  auto const m = random_system( gen, 40u, 200u );
+  std::vector<int64_t> costs( 200u, 1 );
+
+  std::vector<int64_t> improvements;
+  utils::min_weight_solver_statistics stats;
+  utils::min_weight_solver_params ps;
+  ps.num_threads = 4u;
+  ps.max_iterations = 50u;
+  ps.on_improvement = [&]( std::vector<uint32_t> const& solution, int64_t cost ) {
+    CHECK( solution.size() == uint64_t( cost ) );
+    improvements.emplace_back( cost );
+  };
+
+  utils::min_weight_solver solver( m, costs, stats, ps );
+  CHECK( solver.solve() );
+  CHECK( is_solution( m, solver.solution() ) );
+  CHECK( !improvements.empty() );
+  CHECK( std::is_sorted( improvements.rbegin(), improvements.rend() ) );
+  CHECK( improvements.back() == solver.cost() );
+  CHECK( stats.improvements == improvements.size() );
+  CHECK( stats.iterations <= 4u * 50u );
+  CHECK( stats.rank == 40u );
+
+  /* the search stops at the target cost */
+  utils::min_weight_solver_statistics target_stats;
+  ps.on_improvement = nullptr;
+  ps.target_cost = 1000;
+  utils::min_weight_solver target_solver( m, costs, target_stats, ps );
+  CHECK( target_solver.solve() );
+  CHECK( target_stats.iterations == 1u );
+}
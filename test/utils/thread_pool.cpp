@@ -0,0 +1,52 @@
+#include <catch.hpp>
+
+#include <easy/utils/thread_pool.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace easy;
+
+TEST_CASE( "Parallel loop visits each index once", "[thread_pool]" )
+{
+  for ( const auto& num_workers : {1u, 2u, 3u, 8u} )
+  {
+    for ( const auto& num_tasks : {0u, 1u, 5u, 1000u} )
+    {
+      std::vector<std::atomic<uint32_t>> visits( num_tasks );
+      std::vector<uint64_t> results( num_tasks, 0u );
+      std::atomic<bool> valid_worker{true};
+
+      utils::parallel_for( num_tasks, num_workers, [&]( uint32_t worker, uint64_t i ) {
+        if ( worker >= num_workers )
+        {
+          valid_worker = false;
+        }
+        ++visits[i];
+        results[i] = i * i;
+      } );
+
+      CHECK( valid_worker );
+      for ( auto i = 0u; i < num_tasks; ++i )
+      {
+        CHECK( visits[i] == 1u );
+        CHECK( results[i] == uint64_t( i ) * i );
+      }
+    }
+  }
+}
+
+TEST_CASE( "Parallel loop rethrows exceptions", "[thread_pool]" )
+{
+  std::atomic<uint32_t> count{0};
+  CHECK_THROWS_AS( utils::parallel_for( 100u, 4u, [&]( uint32_t, uint64_t i ) {
+                     ++count;
+                     if ( i == 42u )
+                     {
+                       throw std::runtime_error( "error" );
+                     }
+                   } ),
+                   std::runtime_error );
+  CHECK( count == 100u );
+}